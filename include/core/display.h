@@ -1,7 +1,12 @@
 #pragma once
 
 #include "errors.h"
+#include "framebuffer.h"
+#include "glyph_atlas.h"
+#include "text_cache.h"
 #include <cstdint>
+#include <functional>
+#include <mutex>
 
 namespace NightStrike {
 namespace Core {
@@ -32,6 +37,30 @@ public:
         Size(uint16_t w = 0, uint16_t h = 0) : width(w), height(h) {}
     };
 
+    // Text rendering cost, accumulated between beginFrame() and endFrame()
+    struct TextStats {
+        uint32_t labels = 0;        // drawText/drawTextCentered calls
+        uint32_t cacheHits = 0;     // Served from the label cache
+        uint32_t cacheMisses = 0;   // Rasterized through the glyph atlas
+        uint32_t fallbacks = 0;     // Drawn by the TFT driver (wrapping, control chars)
+        uint32_t renderMicros = 0;  // Total time spent drawing text
+    };
+
+    // Asynchronous TFT flush statistics (updated by the flush and UI tasks; read a copy)
+    struct FlushStats {
+        uint32_t framesFlushed = 0;
+        uint32_t framesSkipped = 0;    // Nothing was drawn since the previous flush
+        uint32_t lastPixels = 0;       // Pixels pushed for the last frame
+        uint32_t lastFlushMicros = 0;  // SPI/DMA time of the last frame
+        uint32_t lastWaitMicros = 0;   // Time the UI task waited for the previous flush
+        uint32_t unframedFlushes = 0;  // Flushes forced by drawing outside beginFrame()/endFrame()
+        uint32_t stackFree = 0;        // Flush task stack high-water mark, bytes never used
+        float fps = 0.0f;              // Flushed frames per second, 1 s window
+    };
+
+    using FlushCallback = std::function<void(const FlushStats&)>;
+    using FrameObserver = std::function<void(uint32_t frame)>;
+
     static Display& getInstance();
 
     // Initialization
@@ -49,12 +78,46 @@ public:
     Error drawLine(Point start, Point end, Color color);
     Error drawRect(Point pos, Size size, Color color, bool filled = false);
     Error drawCircle(Point center, uint16_t radius, Color color, bool filled = false);
+    Error drawTriangle(Point a, Point b, Point c, Color color, bool filled = false);
+    Error drawImage(Point pos, Size size, const uint16_t* pixels);  // RGB565, row-major
 
     // Text rendering
     Error setTextColor(Color foreground, Color background);
     Error setTextSize(uint8_t size);
     Error drawText(Point pos, const char* text);
     Error drawTextCentered(Point center, const char* text);
+    Color getTextColor() const { return _textColor; }
+    Color getTextBackground() const { return _textBgColor; }
+    uint8_t getTextSize() const { return _textSize; }
+
+    // Frame accounting. With async flush, drawing outside a frame still reaches the
+    // panel: it is flushed as soon as the flush task is idle, or by update().
+    void beginFrame();
+    void endFrame();
+    void update();                                     // From the main loop
+    const TextStats& getTextStats() const { return _lastFrameText; }
+    uint32_t getFrameCount() const { return _frameCount; }
+    void setFrameObserver(FrameObserver observer) { _frameObserver = observer; }  // From endFrame()
+
+    // Framebuffer backend (HEADLESS_DISPLAY builds render into memory instead of TFT_eSPI)
+    bool hasFramebuffer() const { return _canvas != nullptr; }
+    const Framebuffer* getFramebuffer() const { return _canvas; }
+    const Framebuffer::FrameStats& getFrameStats() const { return _lastFrameStats; }
+    Error saveFrame(const char* path) const;           // PNG, or PPM for a .ppm path
+    Error setFrameDumpDirectory(const char* dir);      // Save every finished frame; nullptr stops
+
+    /**
+     * @brief Double-buffered rendering with DMA flush (HAS_SCREEN builds)
+     *
+     * Drawing goes to an off-screen buffer; endFrame() hands it to a background
+     * task that pushes the touched region over SPI DMA while the UI task draws
+     * the next frame. Falls back to direct drawing if the buffers don't fit.
+     */
+    Error enableAsyncFlush(bool enable);
+    bool isAsyncFlush() const { return _asyncFlush; }
+    Error flush();                                     // Called by endFrame() in async mode
+    void setFlushCallback(FlushCallback callback) { _flushCallback = callback; }  // Flush task context
+    FlushStats getFlushStats() const;
 
     // Battery indicator
     Error drawBatteryIndicator(Point pos, int level, bool charging);
@@ -75,6 +138,30 @@ private:
     Color _textBgColor = Color::Black();
     uint8_t _textSize = 1;
     uint8_t _brightness = 100;
+
+    GlyphAtlas _atlas;
+    TextCache _textCache;
+    TextStats _frameText;
+    TextStats _lastFrameText;
+    uint32_t _frameCount = 0;
+    FrameObserver _frameObserver;
+
+    Framebuffer* _canvas = nullptr;
+    Framebuffer::FrameStats _lastFrameStats;
+    std::string _frameDumpDir;
+
+    bool _asyncFlush = false;
+    bool _inFrame = false;
+    bool _unframedDirty = false;  // Drawn outside a frame and not flushed yet
+    FlushCallback _flushCallback;
+    FlushStats _flushStats;
+    mutable std::mutex _flushStatsLock;  // _flushStats, written from two tasks
+
+    void drawLabel(Point pos, const char* text);
+    void canvasTouched();
+    void drawCanvasText(Point pos, const char* text, size_t len);
+    static void flushTask(void* param);
+    void pushRegion(const Framebuffer& frame, const Framebuffer::Region& region);
 };
 
 } // namespace Core
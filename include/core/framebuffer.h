@@ -0,0 +1,95 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+namespace NightStrike {
+namespace Core {
+
+/**
+ * @brief In-memory RGB565 canvas
+ *
+ * Backs the headless Display build (host benchmarks and UI regression runs).
+ * Implements the same primitives as the TFT path, counts every pixel
+ * written, and diffs each finished frame against the previous one.
+ */
+class Framebuffer {
+public:
+    struct Region {
+        int16_t x = 0;
+        int16_t y = 0;
+        uint16_t width = 0;
+        uint16_t height = 0;
+        bool empty() const { return width == 0 || height == 0; }
+    };
+
+    struct FrameStats {
+        uint32_t pixelsWritten = 0;  // All writes, including overdraw
+        uint32_t pixelsChanged = 0;  // Pixels that differ from the previous frame
+        int16_t dirtyX = 0;          // Bounding box of changed pixels
+        int16_t dirtyY = 0;
+        uint16_t dirtyWidth = 0;
+        uint16_t dirtyHeight = 0;
+
+        // Writes per changed pixel; 1.0 is ideal, 0 means nothing changed
+        float overdraw() const {
+            return pixelsChanged ? static_cast<float>(pixelsWritten) / pixelsChanged : 0.0f;
+        }
+    };
+
+    /**
+     * @param trackChanges Keep a copy of the previous frame for endFrame() diffs
+     */
+    Framebuffer(uint16_t width, uint16_t height, bool trackChanges = true);
+
+    bool isValid() const { return !_pixels.empty(); }
+    uint16_t width() const { return _width; }
+    uint16_t height() const { return _height; }
+    const uint16_t* data() const { return _pixels.data(); }
+    uint16_t* data() { return _pixels.data(); }
+    uint16_t getPixel(int16_t x, int16_t y) const;
+
+    // Drawing primitives (clipped to the canvas)
+    void fill(uint16_t color);
+    void drawPixel(int16_t x, int16_t y, uint16_t color);
+    void drawHLine(int16_t x, int16_t y, int16_t w, uint16_t color);
+    void drawVLine(int16_t x, int16_t y, int16_t h, uint16_t color);
+    void drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color);
+    void drawRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+    void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+    void drawCircle(int16_t cx, int16_t cy, int16_t r, uint16_t color);
+    void fillCircle(int16_t cx, int16_t cy, int16_t r, uint16_t color);
+    void fillTriangle(int16_t x0, int16_t y0, int16_t x1, int16_t y1,
+                      int16_t x2, int16_t y2, uint16_t color);
+    void blit(int16_t x, int16_t y, uint16_t w, uint16_t h, const uint16_t* src);
+
+    // Finish the current frame: diff against the previous one and reset counters
+    FrameStats endFrame();
+
+    // Bounding box of everything drawn since the last call (cheap, no diff)
+    Region takeWrittenRegion();
+
+    // Copy a region from another canvas of the same size without counting it as drawing
+    void copyRegion(const Framebuffer& src, const Region& region);
+
+    // Image export (24-bit RGB)
+    void encodePPM(std::vector<uint8_t>& out) const;
+    void encodePNG(std::vector<uint8_t>& out) const;
+
+private:
+    uint16_t _width;
+    uint16_t _height;
+    bool _trackChanges;
+    std::vector<uint16_t> _pixels;
+    std::vector<uint16_t> _previous;
+    uint32_t _written = 0;
+    int32_t _writtenX0, _writtenY0, _writtenX1, _writtenY1;  // Exclusive max
+
+    void markWritten(int32_t x0, int32_t y0, int32_t x1, int32_t y1);
+    void resetWritten();
+    void rowToRGB(uint16_t y, uint8_t* out) const;
+};
+
+} // namespace Core
+} // namespace NightStrike
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+namespace NightStrike {
+namespace Core {
+
+/**
+ * @brief Pre-rasterized atlas for the built-in 6x8 GLCD font
+ *
+ * Glyph rows are stored in flash as 6-bit masks. Text is expanded to
+ * RGB565 row by row through a run table (one pre-scaled pixel run per
+ * possible mask), so a whole label is produced with a few memcpy calls
+ * and can be pushed to the panel with a single blit.
+ */
+class GlyphAtlas {
+public:
+    static const uint8_t GLYPH_WIDTH = 6;   // 5 px glyph + 1 px spacing
+    static const uint8_t GLYPH_HEIGHT = 8;
+    static const uint8_t MAX_RUN_SCALE = 3; // Text sizes with a cached run table
+
+    GlyphAtlas() = default;
+
+    // True if every character is printable ASCII and has a glyph
+    static bool canRender(const char* text, size_t len);
+
+    // 32-bit: a long label at a large size overflows uint16_t and would pass the fit checks
+    static uint32_t textWidth(size_t len, uint8_t size) {
+        return static_cast<uint32_t>(len) * GLYPH_WIDTH * size;
+    }
+    static uint32_t textHeight(uint8_t size) { return static_cast<uint32_t>(GLYPH_HEIGHT) * size; }
+
+    /**
+     * @brief Rasterize text into an RGB565 buffer
+     * @param dst    Destination, at least textWidth(len, size) x textHeight(size) pixels
+     * @param stride Destination row pitch in pixels
+     */
+    void rasterize(const char* text, size_t len, uint8_t size,
+                   uint16_t fg, uint16_t bg, uint16_t* dst, uint16_t stride);
+
+private:
+    // Run table: for every 6-bit row mask, the scaled RGB565 pixel run
+    uint16_t _runs[64][GLYPH_WIDTH * MAX_RUN_SCALE];
+    uint16_t _runFg = 0;
+    uint16_t _runBg = 0;
+    uint8_t _runSize = 0;
+
+    void buildRuns(uint16_t fg, uint16_t bg, uint8_t size);
+    static const uint8_t* glyphRows(char c);
+};
+
+} // namespace Core
+} // namespace NightStrike
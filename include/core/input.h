@@ -1,6 +1,7 @@
 #pragma once
 
 #include "errors.h"
+#include <atomic>
 #include <cstdint>
 #include <functional>
 
@@ -38,6 +39,21 @@ public:
 
     using ButtonCallback = std::function<void(Button, EventType)>;
     using TouchCallback = std::function<void(const TouchPoint&)>;
+    using EventObserver = std::function<void(Button, EventType, uint32_t edgeMicros)>;
+
+    // Time from the button edge (ISR timestamp) to the PRESS/DOUBLE_PRESS callback
+    struct LatencyStats {
+        uint32_t samples = 0;
+        uint32_t minMicros = 0;
+        uint32_t maxMicros = 0;
+        uint64_t totalMicros = 0;
+        uint32_t droppedEdges = 0;  // Edge queue overflowed
+        uint32_t averageMicros() const { return samples ? totalMicros / samples : 0; }
+    };
+
+    static const uint32_t DEBOUNCE_MICROS = 50000;
+    static const uint32_t LONG_PRESS_MICROS = 800000;
+    static const uint32_t DOUBLE_PRESS_MICROS = 400000;  // Second press within this window
 
     static Input& getInstance();
 
@@ -58,9 +74,22 @@ public:
     // Update (call in loop)
     void update();
 
+    // Drop queued edges, e.g. after a screen that polled the buttons itself
+    void discardPendingEvents();
+
+    // Synthetic events (replay, remote control); delivered like a real button
+    void injectEvent(Button button, EventType type);
+
+    // Sees every event before the button callback (recording, latency probes)
+    void setEventObserver(EventObserver observer) { _eventObserver = observer; }
+
     // Keyboard input (for devices with keyboard)
     Error processKeyboardInput(const char* input);
 
+    // Latency measurement
+    LatencyStats getLatencyStats() const;
+    void resetLatencyStats();
+
 private:
     Input() = default;
     ~Input() = default;
@@ -72,10 +101,48 @@ private:
     TouchPoint _touchPoint = {0, 0, false};
     ButtonCallback _buttonCallback = nullptr;
     TouchCallback _touchCallback = nullptr;
+    EventObserver _eventObserver = nullptr;
+
+    // Debounce / long-press / double-press state machine, one per physical button
+    struct ButtonState {
+        Input* owner = nullptr;
+        uint8_t index = 0;
+        Button button = Button::NONE;
+        uint8_t pin = 0;
+        bool pressed = false;         // Debounced level
+        bool longFired = false;       // LONG_PRESS already sent for this press
+        uint32_t lastEdgeMicros = 0;  // Last accepted edge
+        uint32_t pressMicros = 0;     // Start of the current press
+        uint32_t lastPressMicros = 0; // Previous PRESS, 0 once consumed by a DOUBLE_PRESS
+    };
+
+    // Edge captured by the GPIO interrupt
+    struct Edge {
+        uint8_t button;  // Index into _buttons
+        bool pressed;
+        uint32_t micros;
+    };
+
+    static const uint8_t MAX_BUTTONS = 2;
+    static const uint8_t EDGE_QUEUE_SIZE = 32;  // Power of two
+
+    ButtonState _buttons[MAX_BUTTONS];
+    uint8_t _buttonCount = 0;
+
+    // Single-producer (GPIO ISR) / single-consumer (update()) ring
+    Edge _edges[EDGE_QUEUE_SIZE];
+    std::atomic<uint8_t> _edgeHead{0};
+    std::atomic<uint8_t> _edgeTail{0};
+
+    uint32_t _serialSelectMicros = 0;  // Double-press tracking for the serial fallback
+    LatencyStats _latency;
+    std::atomic<uint32_t> _droppedEdges{0};  // Bumped from the ISR, read from tasks
 
-    unsigned long _lastButtonTime = 0;
-    Button _lastButtonState = Button::NONE;
-    mutable Button _currentButtonState = Button::NONE;  // For debouncing
+    void addButton(Button button, uint8_t pin);
+    void pushEdge(uint8_t button, bool pressed, uint32_t micros);
+    void processEdge(ButtonState& state, bool pressed, uint32_t micros);
+    void emit(Button button, EventType type, uint32_t edgeMicros);
+    static void onButtonEdge(void* arg);
 };
 
 } // namespace Core
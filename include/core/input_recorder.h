@@ -0,0 +1,97 @@
+#pragma once
+
+#include "errors.h"
+#include "input.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace NightStrike {
+namespace Core {
+
+/**
+ * @brief Records and replays Input event streams, measuring input-to-frame latency
+ *
+ * Sessions are plain text, one event per line: "<offset ms> <BUTTON> <EVENT>",
+ * so scripted sessions can also be written by hand. Replay injects events
+ * through Input::injectEvent() at the recorded pace divided by a speed factor.
+ * While recording or replaying, the time from each PRESS / DOUBLE_PRESS /
+ * LONG_PRESS to the next Display::endFrame() is sampled.
+ */
+class InputRecorder {
+public:
+    struct Event {
+        uint32_t offsetMs;
+        Input::Button button;
+        Input::EventType type;
+    };
+
+    struct LatencyReport {
+        uint32_t samples = 0;
+        uint32_t missed = 0;  // No frame within FRAME_TIMEOUT_MICROS
+        uint32_t p50Micros = 0;
+        uint32_t p90Micros = 0;
+        uint32_t p99Micros = 0;
+        uint32_t maxMicros = 0;
+    };
+
+    static const uint32_t FRAME_TIMEOUT_MICROS = 1000000;
+    static const size_t MAX_SAMPLES = 1024;
+
+    static InputRecorder& getInstance();
+
+    // Recording
+    Error startRecording();
+    Error stopRecording();  // Drops the trailing activation that stopped it
+    bool isRecording() const { return _recording; }
+
+    // Replay (call update() from loop())
+    Error startReplay(float speed = 1.0f);
+    void stopReplay();
+    bool isReplaying() const { return _replaying; }
+    void update();
+
+    // Session I/O
+    std::string toText() const;
+    Error fromText(const char* text);
+    Error saveSession(const std::string& path, bool preferSD = false) const;
+    Error loadSession(const std::string& path, bool preferSD = false);
+    const std::vector<Event>& getEvents() const { return _events; }
+
+    // Latency of the current/last session
+    LatencyReport getLatencyReport() const;
+    void printLatencyReport() const;
+
+private:
+    InputRecorder() = default;
+    ~InputRecorder() = default;
+    InputRecorder(const InputRecorder&) = delete;
+    InputRecorder& operator=(const InputRecorder&) = delete;
+
+    std::vector<Event> _events;
+    bool _recording = false;
+    bool _replaying = false;
+    uint32_t _startMicros = 0;
+    float _speed = 1.0f;
+    size_t _nextEvent = 0;
+
+    // Latency probe: an event waiting for its first frame
+    bool _awaitingFrame = false;
+    uint32_t _eventMicros = 0;
+    std::vector<uint32_t> _samples;
+    uint32_t _missed = 0;
+
+    void beginSession();
+    void endSession();
+    void onEvent(Input::Button button, Input::EventType type, uint32_t micros);
+    void onFrame();
+    void checkFrameTimeout(uint32_t now);
+
+    static const char* buttonName(Input::Button button);
+    static const char* eventName(Input::EventType type);
+    static bool parseButton(const char* name, Input::Button& button);
+    static bool parseEvent(const char* name, Input::EventType& type);
+};
+
+} // namespace Core
+} // namespace NightStrike
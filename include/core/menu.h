@@ -40,6 +40,8 @@ public:
     Error show();
     Error hide();
     void update();
+    void refresh();  // Redraw if visible
+    bool isVisible() const { return _visible; }
 
     // Selection
     void selectNext();
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <Arduino.h>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+namespace NightStrike {
+namespace Core {
+
+/**
+ * @brief Process-wide metrics registry, exported in Prometheus text format
+ *
+ * Metrics are registered once (usually at init) and the returned reference is
+ * kept by the caller; updates are single relaxed atomics, safe from any task
+ * and from ISRs/WiFi callbacks. Registration and export take a lock, updates
+ * never do. Names may carry fixed labels, e.g. "x_total{storage=\"sd\"}";
+ * series of one family should be registered one after another. Backslashes
+ * and newlines in help text and label values are escaped on export.
+ */
+class Metrics {
+public:
+    enum class Type : uint8_t {
+        COUNTER,
+        GAUGE,
+        HISTOGRAM
+    };
+
+    class Metric {
+    public:
+        virtual ~Metric() = default;
+        const char* name() const { return _name; }
+        const char* help() const { return _help; }
+        Type type() const { return _type; }
+
+    protected:
+        Metric(const char* name, const char* help, Type type)
+            : _name(name), _help(help), _type(type) {}
+
+    private:
+        const char* _name;
+        const char* _help;
+        Type _type;
+    };
+
+    class Counter : public Metric {
+    public:
+        Counter(const char* name, const char* help) : Metric(name, help, Type::COUNTER) {}
+        void inc(uint64_t n = 1) { _value.fetch_add(n, std::memory_order_relaxed); }
+        uint64_t value() const { return _value.load(std::memory_order_relaxed); }
+
+    private:
+        std::atomic<uint64_t> _value{0};  // 64-bit: byte counters pass 4 GiB
+    };
+
+    class Gauge : public Metric {
+    public:
+        using Sampler = std::function<int32_t()>;
+
+        Gauge(const char* name, const char* help, Sampler sampler = nullptr)
+            : Metric(name, help, Type::GAUGE), _sampler(sampler) {}
+        void set(int32_t v) { _value.store(v, std::memory_order_relaxed); }
+        void add(int32_t n) { _value.fetch_add(n, std::memory_order_relaxed); }
+        int32_t value() const {
+            return _sampler ? _sampler() : _value.load(std::memory_order_relaxed);
+        }
+
+    private:
+        std::atomic<int32_t> _value{0};
+        Sampler _sampler;  // Read at export time instead of the stored value
+    };
+
+    class Histogram : public Metric {
+    public:
+        static const size_t MAX_BUCKETS = 12;
+
+        // bounds: ascending upper bounds; a +Inf bucket is implicit
+        Histogram(const char* name, const char* help, const uint32_t* bounds, size_t count);
+        void observe(uint32_t value);
+
+        size_t bucketCount() const { return _count; }
+        uint32_t bound(size_t i) const { return _bounds[i]; }
+        uint32_t bucket(size_t i) const { return _buckets[i].load(std::memory_order_relaxed); }
+        uint32_t observations() const { return _observations.load(std::memory_order_relaxed); }
+        uint32_t sum() const { return _sum.load(std::memory_order_relaxed); }
+
+    private:
+        uint32_t _bounds[MAX_BUCKETS];
+        size_t _count;
+        std::atomic<uint32_t> _buckets[MAX_BUCKETS + 1];  // Not cumulative; last is +Inf
+        std::atomic<uint32_t> _observations{0};
+        std::atomic<uint32_t> _sum{0};
+    };
+
+    static Metrics& getInstance();
+
+    // Registering an existing name returns the existing metric. A name whose family is
+    // already registered with another type gets a detached metric that is never exported.
+    Counter& counter(const char* name, const char* help);
+    Gauge& gauge(const char* name, const char* help, Gauge::Sampler sampler = nullptr);
+    Histogram& histogram(const char* name, const char* help, const uint32_t* bounds,
+                         size_t count);
+
+    // Prometheus text exposition format 0.0.4
+    void write(Print& out);
+
+private:
+    Metrics();
+    ~Metrics() = default;
+    Metrics(const Metrics&) = delete;
+    Metrics& operator=(const Metrics&) = delete;
+
+    std::mutex _lock;
+    std::vector<Metric*> _metrics;  // Never freed: callers keep references
+
+    Metric* find(const char* name, Type type, bool& conflict);
+    void registerSystemMetrics();
+};
+
+} // namespace Core
+} // namespace NightStrike
@@ -0,0 +1,70 @@
+#pragma once
+
+#include "display.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace NightStrike {
+namespace Core {
+
+/**
+ * @brief Non-blocking toast notifications
+ *
+ * Messages are queued and shown one at a time in a box at the bottom of the
+ * screen, on top of whatever is displayed. Posting a message that is already
+ * queued extends it instead of adding a duplicate. update() expires toasts
+ * from loop(); the menu re-renders and overlays the next one. UI task only.
+ */
+class Notifications {
+public:
+    enum class Level {
+        INFO,
+        WARNING,
+        ERROR
+    };
+
+    static const size_t MAX_QUEUED = 4;
+    static const uint8_t MAX_LINES = 4;
+    static const uint32_t DEFAULT_DURATION_MS = 2000;
+
+    static Notifications& getInstance();
+
+    // Queue a toast ('\n' splits lines); drawn immediately if nothing else is showing
+    void post(const char* message, uint32_t durationMs = DEFAULT_DURATION_MS,
+              Level level = Level::INFO);
+    void dismiss();  // Drop the toast currently shown
+    void clear();    // Drop everything
+
+    // Call from loop(): expires toasts and repaints when the visible one changes
+    void update();
+
+    // Overlay the current toast; screens call this before endFrame()
+    void render(Display& display);
+
+    bool isShowing() const { return !_queue.empty(); }
+
+private:
+    Notifications() = default;
+    ~Notifications() = default;
+    Notifications(const Notifications&) = delete;
+    Notifications& operator=(const Notifications&) = delete;
+
+    struct Toast {
+        std::string message;
+        Level level;
+        uint32_t durationMs;
+        uint32_t shownAt;  // 0 until it reaches the front of the queue
+        uint16_t repeats;  // Coalesced duplicates
+    };
+
+    std::vector<Toast> _queue;
+    Display::Point _boxPos;  // Area covered by the last drawn toast
+    Display::Size _boxSize;
+
+    void showFront();
+    void repaint();
+};
+
+} // namespace Core
+} // namespace NightStrike
@@ -0,0 +1,87 @@
+#pragma once
+
+#include "display.h"
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace NightStrike {
+namespace Core {
+
+/**
+ * @brief Live spectrum chart: averaged bars with peak-hold over a waterfall
+ *
+ * Scanner tasks push samples with addSample()/addSweep() under a short lock;
+ * the UI task calls render(), which only repaints bar segments whose height
+ * changed and writes one waterfall line per frame at a wrapping cursor, so
+ * the history ring is never redrawn as a whole.
+ */
+class SpectrumChart {
+public:
+    struct Config {
+        Display::Point origin;
+        Display::Size size;
+        uint16_t bins = 64;
+        int16_t minLevel = -110;        // Level mapped to an empty bar / coldest color
+        int16_t maxLevel = -30;         // Level mapped to a full bar / hottest color
+        uint8_t smoothing = 4;          // Bars follow an EMA with weight 1/N; 1 shows raw sweeps
+        uint16_t peakHoldMs = 1500;     // Peak marker hold time; 0 disables peak-hold
+        uint8_t waterfallPercent = 50;  // Share of the height used by the waterfall
+    };
+
+    explicit SpectrumChart(const Config& config);
+
+    // Producer side (any task)
+    void addSample(uint16_t bin, int16_t level);            // Max within the current sweep
+    void addSweep(const int16_t* levels, uint16_t count);   // Complete sweep, bins 0..count-1
+    void endSweep();
+
+    // UI side
+    void render(Display& display);  // Draws only what changed since the previous call
+    void invalidate();              // Repaint everything on the next render (after a clear)
+    void reset();                   // Drop all history
+
+    const Config& getConfig() const { return _config; }
+    uint16_t getBinCount() const { return _config.bins; }
+    uint32_t getSweepCount();
+    void getLevels(std::vector<int16_t>& levels);  // Averaged level per bin (any task)
+
+private:
+    static const int16_t NO_SAMPLE = INT16_MIN;
+
+    Config _config;
+
+    // Shared with producers, guarded by _lock
+    std::mutex _lock;
+    std::vector<int16_t> _pending;   // Sweep in progress
+    std::vector<int32_t> _average;   // EMA, level * 16
+    std::vector<int16_t> _recent;    // Max of sweeps completed since the last render
+    uint32_t _sweeps = 0;
+
+    // UI task only
+    std::vector<int32_t> _snapAverage;
+    std::vector<int16_t> _snapRecent;
+    std::vector<int16_t> _peak;
+    std::vector<uint32_t> _peakTime;
+    std::vector<uint16_t> _barDrawn;   // Bar heights currently on screen, pixels
+    std::vector<uint16_t> _peakDrawn;  // Peak marker heights on screen, 0 = none
+    std::vector<uint16_t> _line;       // One waterfall line, RGB565
+    uint32_t _renderedSweeps = 0;
+    uint16_t _cursor = 0;
+    bool _fullRedraw = true;
+
+    // Geometry
+    uint16_t _binWidth;
+    int16_t _plotX;
+    int16_t _barTop;
+    uint16_t _barHeight;
+    int16_t _fallTop;
+    uint16_t _fallHeight;
+
+    uint16_t levelToHeight(int32_t level, uint16_t span) const;
+    uint16_t levelToColor(int16_t level) const;
+    void drawBar(Display& display, uint16_t bin, uint16_t height, uint16_t peakHeight);
+};
+
+} // namespace Core
+} // namespace NightStrike
@@ -7,6 +7,7 @@
 // Forward declaration for FS
 namespace fs {
     class FS;
+    class File;
 }
 
 namespace NightStrike {
@@ -33,12 +34,20 @@ public:
     Error readFile(const std::string& path, std::vector<uint8_t>& data, bool preferSD = false);
     Error writeFile(const std::string& path, const std::vector<uint8_t>& data, bool preferSD = false);
     Error deleteFile(const std::string& path, bool preferSD = false);
+    Error renameFile(const std::string& from, const std::string& to, bool preferSD = false);
     Error listFiles(const std::string& path, std::vector<std::string>& files, bool preferSD = false);
     bool fileExists(const std::string& path, bool preferSD = false);
 
+    // Open a file for streaming (mode as for FS::open); directories are rejected
+    Error openFile(const std::string& path, fs::File& file, const char* mode = "r",
+                   bool preferSD = false);
+
     // Storage info
     uint64_t getFreeSpace(bool preferSD = false);
 
+    // Account bytes written through a file from openFile() in the metrics
+    void recordWrite(size_t bytes, bool preferSD = false);
+
 private:
     Storage() = default;
     ~Storage() = default;
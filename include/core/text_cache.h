@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace NightStrike {
+namespace Core {
+
+/**
+ * @brief Small LRU cache of fully rendered RGB565 label bitmaps
+ *
+ * Menu rows and status messages are redrawn with the same text and colors
+ * on every frame; caching the rasterized bitmap turns each repeat into a
+ * single blit. Bounded by both entry count and total pixel bytes.
+ */
+class TextCache {
+public:
+    struct Entry {
+        std::string text;
+        uint16_t fg = 0;
+        uint16_t bg = 0;
+        uint8_t size = 0;
+        uint16_t width = 0;
+        uint16_t height = 0;
+        uint32_t hash = 0;
+        uint32_t lastUse = 0;
+        std::vector<uint16_t> pixels;
+    };
+
+    static const size_t MAX_ENTRIES = 16;
+    static const size_t DEFAULT_BUDGET = 24 * 1024;  // bytes of pixel data
+
+    explicit TextCache(size_t budgetBytes = DEFAULT_BUDGET) : _budget(budgetBytes) {}
+
+    // Returns the cached bitmap or nullptr; refreshes its LRU position
+    const Entry* find(const char* text, size_t len, uint16_t fg, uint16_t bg, uint8_t size);
+
+    // Reserves a w x h bitmap for the key, evicting least recently used entries.
+    // Returns nullptr if the bitmap alone exceeds half the budget.
+    Entry* insert(const char* text, size_t len, uint16_t fg, uint16_t bg, uint8_t size,
+                  uint16_t width, uint16_t height);
+
+    void clear();
+    size_t bytesUsed() const { return _used; }
+    size_t entryCount() const { return _entries.size(); }
+
+private:
+    std::vector<Entry> _entries;
+    size_t _budget;
+    size_t _used = 0;
+    uint32_t _clock = 0;
+
+    static uint32_t hashKey(const char* text, size_t len, uint16_t fg, uint16_t bg, uint8_t size);
+    void evictOldest();
+};
+
+} // namespace Core
+} // namespace NightStrike
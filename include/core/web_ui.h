@@ -1,9 +1,16 @@
 #pragma once
 
 #include "errors.h"
+#include "utils/json_writer.h"
+#include <cstdint>
+#include <cstring>
 #include <string>
 #include <functional>
-#include <map>
+#include <memory>
+#include <vector>
+
+class AsyncWebServerRequest;
+class AsyncResponseStream;
 
 namespace NightStrike {
 namespace Core {
@@ -15,22 +22,129 @@ namespace Core {
  */
 class WebUI {
 public:
-    struct Request {
-        std::string method;
-        std::string path;
-        std::string body;
-        std::map<std::string, std::string> headers;
-        std::map<std::string, std::string> params;
+    enum class Method : uint8_t {
+        GET,
+        POST,
+        PUT,
+        DELETE,
+        ANY
+    };
+
+    /**
+     * @brief Non-owning view of text inside a request; valid until the handler returns
+     */
+    struct StringRef {
+        const char* data = nullptr;
+        size_t length = 0;
+
+        StringRef() = default;
+        StringRef(const char* d, size_t l) : data(d), length(l) {}
+
+        bool empty() const { return length == 0; }
+        bool operator==(const char* other) const {
+            return other && strlen(other) == length && memcmp(data, other, length) == 0;
+        }
+        bool operator!=(const char* other) const { return !(*this == other); }
+        std::string str() const { return std::string(data ? data : "", length); }
+    };
+
+    /**
+     * @brief Incoming request; parameters and headers are read in place, not copied
+     */
+    class Request {
+    public:
+        Method method() const;
+        StringRef path() const;
+        bool hasParam(const char* name) const;
+        StringRef param(const char* name) const;  // Query string or form field
+        StringRef header(const char* name) const;
+        StringRef body() const;  // Raw body of POST/PUT, up to MAX_BODY_SIZE
+
+    private:
+        friend class WebUI;
+        explicit Request(AsyncWebServerRequest* request) : _request(request) {}
+
+        AsyncWebServerRequest* _request;
+    };
+
+    /**
+     * @brief Response under construction
+     *
+     * Bodies are written through json() or stream() as they are produced;
+     * sendChunked() streams bodies too large to hold in memory. Whatever was
+     * written is sent when the handler returns.
+     */
+    class Response {
+    public:
+        // Fills buffer (at most maxLen bytes) with the next part; 0 ends the body
+        using Filler = std::function<size_t(uint8_t* buffer, size_t maxLen, size_t index)>;
+
+        void setStatus(int status);
+        void setContentType(const char* contentType);  // Default application/json
+        void addHeader(const char* name, const char* value);
+
+        void send(const char* body);
+        Utils::JsonWriter& json();
+        Print& stream();
+        void sendChunked(Filler filler);
+
+    private:
+        friend class WebUI;
+        explicit Response(AsyncWebServerRequest* request) : _request(request) {}
+
+        AsyncWebServerRequest* _request;
+        AsyncResponseStream* _stream = nullptr;
+        std::unique_ptr<Utils::JsonWriter> _json;
+        std::vector<std::pair<std::string, std::string>> _headers;
+        Filler _filler;
+        int _status = 200;
+        const char* _contentType = "application/json";
+
+        AsyncResponseStream* open();
+        void finish(uint32_t heapBefore);
+    };
+
+    using RouteHandler = std::function<void(const Request&, Response&)>;
+
+    static const size_t MAX_BODY_SIZE = 4096;
+
+    // Downloads (/api/storage/download) and uploads (/api/storage/upload), per storage
+    struct TransferStats {
+        uint32_t transfers = 0;  // Completed transfers
+        uint64_t bytes = 0;
+        uint32_t lastBytes = 0;
+        uint32_t lastMicros = 0;
+        uint32_t lastKiBps = 0;  // Sustained rate of the last completed transfer
     };
 
-    struct Response {
-        int statusCode = 200;
-        std::string contentType = "application/json";
-        std::string body;
-        std::map<std::string, std::string> headers;
+    static const size_t DOWNLOAD_CHUNK_SIZE = 4096;
+    static const size_t UPLOAD_BUFFER_SIZE = 8192;  // Two per upload
+    static const size_t MAX_UPLOADS = 2;            // In flight at once, to different files
+    // Received bytes left unacknowledged while the writer lags; under lwIP's
+    // receive window (5744), so the sender can always send once more
+    static const size_t UPLOAD_ACK_HOLD = 2920;
+    static const size_t MAX_UPLOAD_RESULTS = 4;     // Outcomes kept for GET /api/storage/upload
+
+    // Server-Sent Events channel at /api/events
+    struct PushStats {
+        uint32_t published = 0;  // publish() calls
+        uint32_t coalesced = 0;  // Replaced a value that had not been sent yet
+        uint32_t sent = 0;       // Events handed to the clients
+        uint32_t deferred = 0;   // Push rounds skipped because clients were backlogged
     };
 
-    using RouteHandler = std::function<Response(const Request&)>;
+    static const uint32_t PUSH_INTERVAL_MS = 100;
+    static const uint32_t STATUS_INTERVAL_MS = 1000;
+    static const size_t MAX_CLIENT_BACKLOG = 1024;  // Queued bytes per client before we hold off
+    static const size_t MAX_PUSH_TOPICS = 8;
+
+    // Embedded static assets (web/, gzipped at build time)
+    struct AssetStats {
+        uint32_t requests = 0;
+        uint32_t notModified = 0;        // Answered with 304
+        uint32_t bytesSent = 0;          // gzip bodies actually sent
+        uint32_t bytesUncompressed = 0;  // Same responses without gzip
+    };
 
     static WebUI& getInstance();
 
@@ -38,12 +152,27 @@ public:
     Error initialize(uint16_t port = 80);
     Error shutdown();
 
-    // Route management
-    Error addRoute(const std::string& method, const std::string& path, RouteHandler handler);
+    // Route table; modules may register before initialize(), routes go live with the server
+    Error addRoute(Method method, const char* path, RouteHandler handler);
 
     // Status
     bool isActive() const { return _active; }
     std::string getURL() const;
+    const AssetStats& getAssetStats() const { return _assetStats; }
+
+    // Live push. publish() never blocks on clients: each event name keeps only its
+    // latest payload (JSON), which a background task sends when clients keep up.
+    // Status deltas are pushed by the same task.
+    void publish(const char* event, const std::string& data);
+    bool hasSubscribers() const;
+    const PushStats& getPushStats() const { return _pushStats; }
+
+    const TransferStats& getDownloadStats(bool sdCard) const {
+        return _downloadStats[sdCard ? 1 : 0];
+    }
+    const TransferStats& getUploadStats(bool sdCard) const {
+        return _uploadStats[sdCard ? 1 : 0];
+    }
 
 private:
     WebUI() = default;
@@ -54,6 +183,34 @@ private:
     bool _initialized = false;
     bool _active = false;
     uint16_t _port = 80;
+    AssetStats _assetStats;
+    PushStats _pushStats;
+    TransferStats _downloadStats[2];  // LittleFS, SD
+    TransferStats _uploadStats[2];
+
+    struct Route {
+        Method method;
+        std::string path;
+        RouteHandler handler;
+    };
+    std::vector<Route> _routes;
+    bool _coreRoutesAdded = false;
+
+    void registerAssets();
+    void registerCoreRoutes();
+    void registerRoute(size_t index);
+    void dispatch(size_t index, AsyncWebServerRequest* request);
+    void registerEvents();
+    void sendDownload(AsyncWebServerRequest* request);
+    void receiveUpload(AsyncWebServerRequest* request, size_t index, uint8_t* data, size_t len,
+                       bool final);
+    void finishUpload(AsyncWebServerRequest* request);
+    void recordTransfer(TransferStats& stats, const char* what, bool sdCard, uint32_t bytes,
+                        uint32_t elapsedMicros);
+    static void uploadTask(void* param);
+    void pushPending(bool all);
+    void pushStatus(bool full);
+    static void pushTask(void* param);
 };
 
 } // namespace Core
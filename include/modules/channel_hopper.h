@@ -0,0 +1,115 @@
+#pragma once
+
+#include "core/errors.h"
+#include "modules/wifi_module.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+namespace NightStrike {
+namespace Modules {
+
+/**
+ * @brief Channel hopper for passive surveys
+ *
+ * Visits every channel once per round. In adaptive mode the dwell of each
+ * channel follows its recent frame rate and the number of BSSIDs seen there,
+ * so busy channels get most of the round while quiet ones keep MIN_DWELL_MS;
+ * the round never exceeds the revisit limit, so no channel goes unobserved
+ * for two limits' worth. Fixed mode is plain round-robin, kept as the
+ * baseline for comparing discovery rates (tests/test_channel_hopper
+ * simulates both).
+ */
+class ChannelHopper {
+public:
+    static const uint8_t CHANNEL_COUNT = 13;
+    static const uint32_t MIN_DWELL_MS = 100;
+    static const uint32_t MAX_DWELL_MS = 1500;
+    static const uint32_t DEFAULT_REVISIT_MS = 5000;    // Longest gap between visits
+    static const uint32_t DEFAULT_FIXED_DWELL_MS = 250;
+    static const size_t DEVICE_SET_SIZE = 1024;         // Unique transmitters, all channels
+    static const size_t BSSID_SET_SIZE = 64;            // Per channel
+
+    enum class Mode : uint8_t {
+        ADAPTIVE,
+        FIXED
+    };
+
+    struct ChannelStats {
+        uint8_t channel;
+        uint32_t dwellMs;        // Planned for the next visit
+        uint32_t visits;
+        uint32_t frames;
+        uint32_t framesPerSecond;  // Smoothed, while on the channel
+        uint32_t bssids;         // Unique, up to BSSID_SET_SIZE
+        uint32_t lastVisitMs;    // millis() when last left
+    };
+
+    struct Stats {
+        bool running;
+        Mode mode;
+        uint32_t revisitMs;
+        uint32_t elapsedMs;
+        uint32_t devices;            // Unique transmitter addresses
+        uint32_t devicesPerMinute;   // Discovery rate since start
+        ChannelStats channels[CHANNEL_COUNT];
+    };
+
+    static ChannelHopper& getInstance();
+
+    // dwellMs is only used in FIXED mode; revisitMs bounds an ADAPTIVE round.
+    // Clears the statistics, so call it before onPacket() is subscribed.
+    Core::Error configure(Mode mode, uint32_t dwellMs = DEFAULT_FIXED_DWELL_MS,
+                          uint32_t revisitMs = DEFAULT_REVISIT_MS);
+    Core::Error start();  // Hops with the configured settings
+    Core::Error stop();
+    bool isRunning() const { return _task != nullptr; }
+
+    // Sniffer subscriber (WiFi task)
+    void onPacket(const WiFiModule::SnifferPacket& packet);
+
+    void getStats(Stats& stats) const;
+
+    static const char* modeName(Mode mode);
+
+    // Adaptive dwell per channel from its smoothed frame rate and BSSID count;
+    // pure, so the planning can be simulated off the device
+    static void planDwell(const uint32_t rates[CHANNEL_COUNT],
+                          const uint32_t bssids[CHANNEL_COUNT], uint32_t revisitMs,
+                          uint32_t dwellMs[CHANNEL_COUNT]);
+
+private:
+    ChannelHopper() = default;
+    ~ChannelHopper() = default;
+    ChannelHopper(const ChannelHopper&) = delete;
+    ChannelHopper& operator=(const ChannelHopper&) = delete;
+
+    struct Channel {
+        std::atomic<uint32_t> frames{0};
+        std::atomic<uint32_t> bssidCount{0};
+        uint32_t bssids[BSSID_SET_SIZE];  // MAC hashes, 0 = empty; WiFi task only
+        uint32_t dwellMs = MIN_DWELL_MS;
+        uint32_t visits = 0;
+        uint32_t rate = 0;                // Frames per second, smoothed
+        uint32_t lastVisitMs = 0;
+    };
+
+    Channel _channels[CHANNEL_COUNT];
+    uint32_t _devices[DEVICE_SET_SIZE];   // MAC hashes, 0 = empty; WiFi task only
+    std::atomic<uint32_t> _deviceCount{0};
+
+    Mode _mode = Mode::ADAPTIVE;
+    uint32_t _fixedDwellMs = DEFAULT_FIXED_DWELL_MS;
+    uint32_t _revisitMs = DEFAULT_REVISIT_MS;
+    uint32_t _startMs = 0;
+    std::atomic<bool> _stopping{false};
+    TaskHandle_t _task = nullptr;
+
+    void plan();
+    static void hopTask(void* param);
+};
+
+} // namespace Modules
+} // namespace NightStrike
@@ -0,0 +1,107 @@
+#pragma once
+
+#include "core/errors.h"
+#include "modules/wifi_module.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace NightStrike {
+namespace Modules {
+
+/**
+ * @brief Passive inventory of the APs and stations heard by the sniffer
+ *
+ * A fixed-capacity open-addressing table keyed by the packed transmitter
+ * MAC, allocated once (PSRAM when available) so updates from the sniffer
+ * never allocate. Probing is bounded to MAX_PROBE slots; when a new device
+ * finds them all taken, the least recently seen of them is replaced, which
+ * ages out stale devices without ever shifting entries around.
+ */
+class DeviceTable {
+public:
+    static const size_t CAPACITY = 8192;           // Slots in PSRAM, power of two
+    static const size_t CAPACITY_INTERNAL = 1024;  // Fallback in internal RAM
+    static const uint8_t MAX_PROBE = 16;
+
+    struct Device {
+        uint8_t mac[6];
+        uint8_t bssid[6];      // AP the device talks to; its own address for APs
+        bool isAP;
+        bool associated;       // bssid is known
+        uint8_t channel;       // Last heard on
+        int8_t rssiMin;
+        int8_t rssiMax;
+        int8_t rssiAvg;        // Smoothed
+        uint32_t firstSeenMs;
+        uint32_t lastSeenMs;
+        uint32_t frames;
+        uint32_t mgmtFrames;
+        uint32_t dataFrames;
+    };
+
+    enum class Filter : uint8_t {
+        ALL,
+        APS,
+        CLIENTS
+    };
+
+    static DeviceTable& getInstance();
+
+    Core::Error begin();  // Allocates the table on first use
+    void clear();
+
+    // Sniffer subscriber (WiFi task); frames arriving while a reader holds
+    // the table are skipped rather than blocking the WiFi task
+    void update(const WiFiModule::SnifferPacket& packet);
+
+    size_t size() const { return _count.load(std::memory_order_relaxed); }
+    size_t capacity() const { return _capacity; }
+    uint32_t evictions() const { return _evictions.load(std::memory_order_relaxed); }
+    uint32_t skipped() const { return _skipped.load(std::memory_order_relaxed); }
+
+    bool find(const uint8_t* mac, Device& device) const;
+    // Up to limit devices, most recently seen first
+    void recent(std::vector<Device>& devices, size_t limit, Filter filter = Filter::ALL) const;
+    // Stations associated with the given BSSID, most recently seen first
+    void clientsOf(const uint8_t* bssid, std::vector<Device>& devices, size_t limit) const;
+
+private:
+    DeviceTable() = default;
+    ~DeviceTable() = default;
+    DeviceTable(const DeviceTable&) = delete;
+    DeviceTable& operator=(const DeviceTable&) = delete;
+
+    struct Slot {
+        uint64_t key;          // Packed MAC, 0 = empty
+        uint8_t bssid[6];
+        uint8_t flags;
+        uint8_t channel;
+        int8_t rssiMin;
+        int8_t rssiMax;
+        int16_t rssiAvg16;     // x16, exponential average
+        uint32_t firstSeenMs;
+        uint32_t lastSeenMs;
+        uint32_t frames;
+        uint32_t mgmtFrames;
+        uint32_t dataFrames;
+    };
+
+    Slot* _slots = nullptr;
+    size_t _capacity = 0;
+    mutable std::mutex _lock;
+    std::atomic<size_t> _count{0};
+    std::atomic<uint32_t> _evictions{0};
+    std::atomic<uint32_t> _skipped{0};
+
+    Slot* slotFor(uint64_t key);
+    const Slot* lookup(uint64_t key) const;
+    template <typename Predicate>
+    void collect(std::vector<Device>& devices, size_t limit, Predicate predicate) const;
+    static void toDevice(const Slot& slot, Device& device);
+};
+
+} // namespace Modules
+} // namespace NightStrike
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "core/errors.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace NightStrike {
+namespace Modules {
+
+/**
+ * @brief 802.11 frame filter, compiled once and run in the sniffer callback
+ *
+ * Expressions combine primitives with and / or / not and parentheses:
+ *   type mgt|ctl|data
+ *   subtype beacon|probe-req|probe-resp|assoc-req|assoc-resp|reassoc-req|
+ *           reassoc-resp|disassoc|auth|deauth|action|rts|cts|ack|data|null|qos-data
+ *   bssid|addr1|addr2|addr3 aa:bb:cc:dd:ee:ff   (or a prefix: aa:bb:*)
+ *   src|dst <mac>   (transmitter / receiver, i.e. addr2 / addr1)
+ *   rssi >|< -70
+ * e.g. "type mgt and subtype beacon and bssid aa:bb:*".
+ *
+ * The program is postfix bytecode held inline (no allocation); evaluation
+ * touches only the frame header. typeMask() tells which frame types can
+ * possibly match, for the driver's promiscuous filter.
+ */
+class FrameFilter {
+public:
+    static const size_t MAX_CODE = 96;
+    static const uint8_t MAX_DEPTH = 32;     // Operands on the stack, and nested ( / not
+    static const size_t MAX_SOURCE = 256;    // Longer text is rejected before parsing
+
+    FrameFilter() = default;
+
+    // errorAt, when given, receives the offset of the offending token.
+    // A filter that can match no frame type at all is rejected too.
+    static Core::Error compile(const char* source, FrameFilter& filter, size_t* errorAt = nullptr);
+
+    bool empty() const { return _length == 0; }
+    bool matches(const uint8_t* frame, size_t length, int8_t rssi) const;  // length without FCS
+    uint8_t typeMask() const { return _typeMask; }  // WiFiModule::SNIFF_* bits
+    const std::string& source() const { return _source; }
+
+private:
+    enum Op : uint8_t {
+        OP_TYPE,       // type
+        OP_SUBTYPE,    // type << 4 | subtype
+        OP_ADDR,       // which (0 = bssid, 1-3 = addrN), length, bytes...
+        OP_RSSI_GT,    // int8
+        OP_RSSI_LT,    // int8
+        OP_AND,
+        OP_OR,
+        OP_NOT
+    };
+
+    uint8_t _code[MAX_CODE];
+    uint8_t _length = 0;
+    uint8_t _typeMask = 0x0F;
+    std::string _source;
+
+    friend class FrameFilterCompiler;
+};
+
+} // namespace Modules
+} // namespace NightStrike
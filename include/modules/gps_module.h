@@ -2,8 +2,13 @@
 
 #include "core/module_interface.h"
 #include "core/errors.h"
+#include "modules/nmea_parser.h"
+#include <atomic>
+#include <mutex>
 #include <vector>
 #include <string>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
 
 namespace NightStrike {
 namespace Modules {
@@ -20,24 +25,51 @@ namespace Modules {
 class GPSModule : public Core::IModule {
 public:
     struct GPSPosition {
-        double latitude;
-        double longitude;
-        double altitude;
-        uint8_t satellites;
-        bool valid;
+        double latitude = 0;
+        double longitude = 0;
+        double altitude = 0;
+        float speedKmh = 0;
+        float course = 0;
+        float hdop = 0;
+        uint8_t satellites = 0;
+        bool valid = false;     // A fix no older than FIX_TIMEOUT_MS
+        uint16_t year = 0;      // UTC from the receiver; year 0 until an RMC brings the date
+        uint8_t month = 0;
+        uint8_t day = 0;
+        uint8_t hour = 0;
+        uint8_t minute = 0;
+        uint8_t second = 0;
     };
 
+    static const uint32_t FIX_TIMEOUT_MS = 2000;
+    static const size_t RX_BUFFER_SIZE = 1024;  // ~90 ms of 115200 baud
+    static const uint32_t TRACK_INTERVAL_MS = 1000;
+    static const size_t MAX_TRACK_POINTS = 1024;  // ~48 KB; then thinned, see parseGPSData()
+
+    // One per BSSID, holding its strongest sighting; fixed size so the table never allocates
     struct WiFiNetwork {
-        std::string ssid;
-        std::string bssid;
+        uint8_t bssid[6];
+        char ssid[33];
         int8_t rssi;
         uint8_t channel;
         bool encrypted;
-        double latitude;
+        double latitude;        // Where rssi was seen
         double longitude;
-        uint64_t timestamp;
+        float altitude;
+        uint32_t lastSeenMs;
+        uint32_t sightings;     // 0 = empty slot
+        uint16_t firstYear;     // First seen, UTC
+        uint8_t firstMonth;
+        uint8_t firstDay;
+        uint8_t firstHour;
+        uint8_t firstMinute;
+        uint8_t firstSecond;
     };
 
+    static const size_t NETWORK_CAPACITY = 4096;          // Slots in PSRAM, power of two
+    static const size_t NETWORK_CAPACITY_INTERNAL = 512;  // ~45 KB of internal RAM without it
+    static const uint32_t SCAN_INTERVAL_MS = 10000;
+
     GPSModule();
     ~GPSModule() override = default;
 
@@ -48,14 +80,16 @@ public:
     bool isInitialized() const override { return _initialized; }
     bool isSupported() const override;
 
-    // GPS operations
+    // GPS operations; NMEA is parsed as it arrives on the UART
     Core::Error getPosition(GPSPosition& position);
+    void getParserStats(NmeaParser::Stats& stats);
     Core::Error startTracking();
     Core::Error stopTracking();
     Core::Error saveTrack(const std::string& filename);
 
-    // Wardriving
-    Core::Error startWardriving();
+    // Wardriving scans every SCAN_INTERVAL_MS from its own task; new networks are
+    // appended to a WiGLE CSV as they are found
+    Core::Error startWardriving(const std::string& filename = "/wardriving.csv");
     Core::Error stopWardriving();
     Core::Error getNetworks(std::vector<WiFiNetwork>& networks);
     Core::Error exportToWigle(const std::string& filename);
@@ -66,19 +100,32 @@ public:
 private:
     bool _initialized = false;
     bool _tracking = false;
-    bool _wardriving = false;
+    std::atomic<bool> _wardriving{false};
     
     uint8_t _rxPin = 16;  // Default GPIO16
     uint8_t _txPin = 17;  // Default GPIO17
     uint32_t _baud = 9600;
     
+    std::mutex _positionLock;  // UART event task vs. readers
+    NmeaParser _parser;
     GPSPosition _lastPosition;
-    std::vector<WiFiNetwork> _capturedNetworks;
+    uint32_t _lastFixMs = 0;
+    uint32_t _lastTrackMs = 0;
+    uint32_t _trackIntervalMs = TRACK_INTERVAL_MS;  // Doubles each time the track is thinned
+    std::mutex _networkLock;
+    WiFiNetwork* _networks = nullptr;  // Open addressing by BSSID, allocated once and kept
+    size_t _networkCapacity = 0;
+    size_t _networkCount = 0;
+    uint32_t _droppedNetworks = 0;  // New BSSIDs seen with the table full
+    std::string _wardrivePath;
+    TaskHandle_t _scanTask = nullptr;
     std::vector<GPSPosition> _trackPoints;
     
     // Internal methods
-    Core::Error parseGPSData();
+    Core::Error parseGPSData();  // Drains the UART into the parser
     void scanAndStoreNetworks();
+    WiFiNetwork* networkSlot(const uint8_t* bssid, bool& created);
+    static void wardriveTask(void* param);
 };
 
 } // namespace Modules
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace NightStrike {
+namespace Modules {
+
+/**
+ * @brief Incremental NMEA 0183 parser
+ *
+ * Fed one byte at a time, straight from the UART; the checksum is
+ * accumulated as the sentence arrives and the fields are split in place
+ * once it is complete, so nothing is allocated. GGA, RMC, GSA and VTG from
+ * any talker (GP, GN, GL, ...) update the fix; other sentences are counted
+ * and skipped. Sentences without a checksum are rejected.
+ */
+class NmeaParser {
+public:
+    static const size_t MAX_SENTENCE = 96;  // 82 by the standard; some receivers run longer
+    static const uint8_t MAX_FIELDS = 24;
+
+    struct Fix {
+        double latitude = 0;       // Degrees, south negative
+        double longitude = 0;      // Degrees, west negative
+        float altitude = 0;        // Metres above mean sea level (GGA)
+        float speedKmh = 0;        // VTG, or RMC knots converted
+        float course = 0;          // Degrees true
+        float hdop = 0;
+        float pdop = 0;
+        float vdop = 0;
+        uint8_t satellites = 0;    // In use (GGA)
+        uint8_t quality = 0;       // GGA: 0 none, 1 GPS, 2 DGPS, 4/5 RTK, 6 estimated
+        uint8_t mode = 1;          // GSA: 1 none, 2 2D, 3 3D
+        bool valid = false;        // RMC status A, or a GGA position with quality > 0
+        uint8_t hour = 0;          // UTC
+        uint8_t minute = 0;
+        uint8_t second = 0;
+        uint16_t millisecond = 0;
+        uint8_t day = 0;           // RMC date; 0 until one is seen
+        uint8_t month = 0;
+        uint16_t year = 0;
+    };
+
+    struct Stats {
+        uint32_t sentences = 0;    // Checksum valid
+        uint32_t checksumErrors = 0;
+        uint32_t overflows = 0;    // Longer than MAX_SENTENCE
+        uint32_t ignored = 0;      // Valid, but not a sentence we parse
+        uint32_t positions = 0;    // GGA / RMC that set the position
+    };
+
+    // true when the byte completed a sentence that changed the fix
+    bool feed(char c);
+    size_t feed(const char* data, size_t length);  // Fix updates in the chunk
+
+    const Fix& fix() const { return _fix; }
+    const Stats& stats() const { return _stats; }
+    void reset();
+
+private:
+    enum class State : uint8_t {
+        IDLE,      // Waiting for '$'
+        BODY,      // Address and fields, XOR-ing into the checksum
+        CHECKSUM1,
+        CHECKSUM2
+    };
+
+    State _state = State::IDLE;
+    char _buffer[MAX_SENTENCE];
+    size_t _length = 0;
+    uint8_t _checksum = 0;
+    uint8_t _expected = 0;
+    Fix _fix;
+    Stats _stats;
+
+    bool complete();
+    void parseGGA(char** fields, uint8_t count);
+    void parseRMC(char** fields, uint8_t count);
+    void parseGSA(char** fields, uint8_t count);
+    void parseVTG(char** fields, uint8_t count);
+    void parseTime(const char* field);
+};
+
+} // namespace Modules
+} // namespace NightStrike
@@ -0,0 +1,104 @@
+#pragma once
+
+#include "core/errors.h"
+#include "modules/wifi_module.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+namespace NightStrike {
+namespace Modules {
+
+/**
+ * @brief Saves sniffed 802.11 frames as pcap (LINKTYPE_IEEE802_11_RADIOTAP) on the SD card
+ *
+ * The promiscuous callback only copies each frame, with a radiotap header
+ * built from rx_ctrl, into a preallocated single-producer ring. A writer task
+ * drains the ring into a staging block and writes it out in whole sectors,
+ * so the card sees few, large, aligned writes. Frames that don't fit in the
+ * ring are dropped and counted; files rotate at a size limit so long sessions
+ * never produce one huge file.
+ */
+class PcapWriter {
+public:
+    static const size_t RING_SIZE = 96 * 1024;           // PSRAM when available
+    static const size_t RING_SIZE_INTERNAL = 32 * 1024;  // Fallback in internal RAM
+    static const size_t BLOCK_SIZE = 16 * 1024;          // Staging block, whole sectors
+    static const size_t SECTOR_SIZE = 512;
+    static const uint32_t SNAP_LENGTH = 2400;            // Longer frames are truncated
+    static const uint32_t DEFAULT_FILE_SIZE = 32 * 1024 * 1024;
+    static const uint32_t FLUSH_INTERVAL_MS = 2000;      // Quiet channels still reach the card
+
+    struct Stats {
+        bool running = false;
+        bool stopping = false;           // Stopped, the writer still draining the ring
+        uint32_t framesWritten = 0;
+        uint32_t framesDropped = 0;      // Ring full
+        uint32_t framesPerSecond = 0;    // Written, over the last second
+        uint64_t bytesWritten = 0;
+        uint32_t files = 0;              // Files started this session, rotations included
+        uint32_t ringPeak = 0;           // Highest ring fill in bytes
+        std::string file;                // Current file
+    };
+
+    static PcapWriter& getInstance();
+
+    // Neither call touches the card: the writer task picks the file name and opens it.
+    // stop(false) only signals the writer; poll getStats() until stopping clears.
+    Core::Error start(uint32_t maxFileSize = DEFAULT_FILE_SIZE);
+    Core::Error stop(bool wait = true);  // Drains the ring and closes the file
+    bool isRunning() const { return _running.load(std::memory_order_relaxed); }
+
+    // Sniffer subscriber (WiFi task); never blocks
+    void capture(const WiFiModule::SnifferPacket& packet);
+
+    void getStats(Stats& stats) const;
+
+private:
+    PcapWriter() = default;
+    ~PcapWriter() = default;
+    PcapWriter(const PcapWriter&) = delete;
+    PcapWriter& operator=(const PcapWriter&) = delete;
+
+    // Ring: records are [uint32_t length][pcap record], padded to 4 bytes.
+    // A zero length means "wrapped, continue at the start".
+    // Indices run over twice the ring size and wrap explicitly: the ring size
+    // is not a power of two, so free-running counters would jump on overflow.
+    uint8_t* _ring = nullptr;
+    size_t _ringSize = 0;
+    std::atomic<size_t> _head{0};  // Written by the producer only
+    std::atomic<size_t> _tail{0};  // Written by the writer task only
+
+    size_t advance(size_t index, size_t bytes) const {
+        index += bytes;
+        return index >= 2 * _ringSize ? index - 2 * _ringSize : index;
+    }
+    size_t offset(size_t index) const { return index >= _ringSize ? index - _ringSize : index; }
+    size_t used(size_t head, size_t tail) const {
+        return head >= tail ? head - tail : head + 2 * _ringSize - tail;
+    }
+
+    std::atomic<bool> _running{false};
+    std::atomic<bool> _stopping{false};  // Cleared by the writer once the file is closed
+    TaskHandle_t _task = nullptr;
+    uint32_t _maxFileSize = DEFAULT_FILE_SIZE;
+
+    std::atomic<uint32_t> _framesWritten{0};
+    std::atomic<uint32_t> _framesDropped{0};
+    std::atomic<uint32_t> _framesPerSecond{0};
+    std::atomic<uint32_t> _files{0};
+    std::atomic<uint32_t> _ringPeak{0};
+    uint64_t _bytesWritten = 0;
+    mutable std::mutex _statsLock;  // _bytesWritten and _file
+    std::string _file;
+    uint32_t _session = 0;
+
+    static void writerTask(void* param);
+};
+
+} // namespace Modules
+} // namespace NightStrike
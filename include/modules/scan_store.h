@@ -0,0 +1,163 @@
+#pragma once
+
+#include "modules/wifi_module.h"
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace NightStrike {
+namespace Modules {
+
+/**
+ * @brief Latest WiFi scan results, shared by the menu and the web API
+ *
+ * A full scan replaces the whole set and bumps the generation. A survey
+ * merges one channel at a time: known APs are updated in place and new ones
+ * appended, and only when it ends are the APs it no longer heard removed,
+ * bumping the generation if any were. Queries filter and sort on the device
+ * and return one page at a time; a cursor ("<generation>.<offset>") pins the
+ * page to the rows it came from, so a client paging while a survey runs
+ * keeps its place and notices when rows were replaced or removed.
+ *
+ * Results are kept as columns (RSSI, channel, auth mode, BSSID, SSID id)
+ * with the SSIDs interned in one pool, so hidden networks and repeated
+ * names cost two bytes per AP. Readers get row indices, stable for one
+ * generation, and look the fields up through a Reader instead of copying.
+ */
+class ScanStore {
+public:
+    static const size_t DEFAULT_PAGE_SIZE = 25;
+    static const size_t MAX_PAGE_SIZE = 100;
+
+    enum class SortKey : uint8_t {
+        RSSI,
+        CHANNEL,
+        SSID
+    };
+
+    enum class Security : uint8_t {
+        ANY,
+        OPEN,
+        ENCRYPTED,
+        WEP,
+        WPA,
+        WPA2,
+        WPA3
+    };
+
+    struct Query {
+        SortKey sort = SortKey::RSSI;
+        bool descending = true;
+        uint8_t channel = 0;          // 0 = any
+        Security security = Security::ANY;
+        std::string ssid;             // Case-insensitive substring, empty = any
+    };
+
+    struct Page {
+        uint32_t generation = 0;
+        size_t offset = 0;
+        size_t total = 0;             // Matches over all pages
+        std::vector<uint16_t> items;  // Row indices
+
+        bool hasMore() const { return offset + items.size() < total; }
+    };
+
+    // One row, pointing into the store; valid while the Reader that returned it lives
+    struct Entry {
+        const char* ssid;             // "" when hidden
+        const uint8_t* bssid;
+        int8_t rssi;
+        uint8_t channel;
+        uint8_t authMode;             // wifi_auth_mode_t
+    };
+
+    /**
+     * @brief Locked view of the store
+     *
+     * Holds the store's lock for its lifetime, so keep it short: scans
+     * finishing in the meantime wait for it.
+     */
+    class Reader {
+    public:
+        uint32_t generation() const { return _store._generation; }
+        size_t size() const { return _store._rssi.size(); }
+        Entry entry(size_t index) const;
+        size_t memoryUsage() const;  // Bytes held by the columns and the SSID pool
+
+        // generation 0 queries the current results; any other value must still be current
+        Core::Error query(const Query& query, uint32_t generation, size_t offset, size_t limit,
+                          Page& page) const;
+
+    private:
+        friend class ScanStore;
+        explicit Reader(const ScanStore& store) : _store(store), _guard(store._lock) {}
+
+        const ScanStore& _store;
+        std::unique_lock<std::mutex> _guard;
+    };
+
+    static ScanStore& getInstance();
+
+    // Replace the results with a new scan and announce it to web clients
+    void replace(const std::vector<WiFiModule::ScanRecord>& records);
+    // Add one channel's results to the survey; scanning false ends it
+    void merge(uint8_t channel, const std::vector<WiFiModule::ScanRecord>& records,
+               bool scanning);
+    // A channel scan failed: its previous rows stay, clients still learn whether more follow
+    void keep(uint8_t channel, bool scanning);
+
+    Reader read() const { return Reader(*this); }
+    uint32_t generation() const;
+    size_t size() const;
+    // A copy of the AP with this BSSID, for callers that keep it; false when it is gone
+    bool find(const uint8_t* bssid, WiFiModule::ScanRecord& record) const;
+
+    static bool parseCursor(const char* cursor, uint32_t& generation, size_t& offset);
+    static std::string makeCursor(uint32_t generation, size_t offset);
+
+    static bool parseSortKey(const std::string& name, SortKey& key);
+    static bool parseSecurity(const std::string& name, Security& security);
+    static const char* securityName(uint8_t authMode);
+
+private:
+    ScanStore() = default;
+    ~ScanStore() = default;
+    ScanStore(const ScanStore&) = delete;
+    ScanStore& operator=(const ScanStore&) = delete;
+
+    mutable std::mutex _lock;
+    uint32_t _generation = 0;
+
+    // One entry per AP, same index in every column
+    std::vector<int8_t> _rssi;
+    std::vector<uint8_t> _channel;
+    std::vector<uint8_t> _authMode;
+    std::vector<uint8_t> _bssid;          // 6 bytes per AP
+    std::vector<uint16_t> _ssid;          // SSID pool id
+    std::vector<uint8_t> _seen;           // Heard by the survey in progress
+    uint16_t _surveyed = 0;               // Channels the survey has merged, bit N = channel N
+
+    // SSID pool: NUL-terminated names back to back, id 0 is the empty name
+    std::vector<char> _pool;
+    std::vector<uint32_t> _poolOffsets;   // Id to offset in _pool
+    std::vector<uint16_t> _poolIndex;     // Open addressing, id + 1 (0 = free)
+
+    // Under _lock
+    void append(const WiFiModule::ScanRecord& record);
+    size_t rowOf(const uint8_t* bssid) const;  // size() when not there
+    void endSurvey();
+    uint16_t intern(const char* ssid);
+    void resetPool();
+    void rebuildPoolIndex();
+    void compactPool();
+    uint32_t bump();
+    const char* ssidAt(size_t row) const { return &_pool[_poolOffsets[_ssid[row]]]; }
+    bool matches(size_t row, const Query& query) const;
+
+    static void announce(uint32_t generation, size_t count, uint8_t channel, bool scanning);
+};
+
+} // namespace Modules
+} // namespace NightStrike
@@ -2,6 +2,7 @@
 
 #include "core/module_interface.h"
 #include "core/errors.h"
+#include "modules/frame_filter.h"
 #include <WiFi.h>
 #include <vector>
 #include <string>
@@ -27,15 +28,67 @@ public:
         int8_t rssi;
         uint8_t channel;
         bool encrypted;
+        uint8_t authMode;  // wifi_auth_mode_t
         uint8_t bssidBytes[6];
     };
 
+    /**
+     * @brief One scan result, copied straight from the driver's wifi_ap_record_t
+     */
+    struct ScanRecord {
+        uint8_t bssid[6];
+        char ssid[33];             // NUL-terminated
+        int8_t rssi;
+        uint8_t channel;
+        uint8_t authMode;          // wifi_auth_mode_t
+    };
+
     struct Client {
         std::string mac;
         int8_t rssi;
         uint8_t macBytes[6];
     };
 
+    /**
+     * @brief One received frame as handed to sniffer subscribers
+     *
+     * Points into the driver's buffer: only valid during the callback, so
+     * copy whatever has to outlive it.
+     */
+    struct SnifferPacket {
+        const uint8_t* data;       // 802.11 frame, FCS included
+        uint16_t length;
+        int8_t rssi;
+        int8_t noiseFloor;
+        uint8_t channel;
+        uint8_t rate;              // rx_ctrl.rate
+        uint32_t timestamp;        // rx_ctrl.timestamp, microseconds
+        wifi_promiscuous_pkt_type_t type;
+    };
+
+    using SnifferCallback = std::function<void(const SnifferPacket&)>;
+
+    // Frame types a subscriber wants, bit per wifi_promiscuous_pkt_type_t
+    static const uint8_t SNIFF_MGMT = 1 << WIFI_PKT_MGMT;
+    static const uint8_t SNIFF_CTRL = 1 << WIFI_PKT_CTRL;
+    static const uint8_t SNIFF_DATA = 1 << WIFI_PKT_DATA;
+    static const uint8_t SNIFF_MISC = 1 << WIFI_PKT_MISC;
+    static const uint8_t SNIFF_ALL = SNIFF_MGMT | SNIFF_CTRL | SNIFF_DATA | SNIFF_MISC;
+    static const uint8_t MAX_SNIFFER_SUBSCRIBERS = 6;
+    static const size_t MAX_CLIENTS = 32;  // Per AP, from getClients()
+    static const uint16_t ALL_CHANNELS = 0x3FFE;  // Scan channel mask, bit N = channel N (1-13)
+    static const uint32_t SCAN_DWELL_MS = 120;    // Active scan time per channel
+
+    struct SnifferStats {
+        int id;
+        uint8_t types;            // SNIFF_* bits requested from the driver
+        std::string filter;       // Filter source, empty when unfiltered
+        uint32_t delivered;       // Frames handed to the callback
+        uint32_t filtered;        // Frames the filter rejected before the callback
+        uint64_t filterCycles;    // CPU cycles spent in the filter
+        uint64_t callbackCycles;  // CPU cycles spent in the callback
+    };
+
     WiFiModule();
     ~WiFiModule() override = default;
 
@@ -46,8 +99,13 @@ public:
     bool isInitialized() const override { return _initialized; }
     bool isSupported() const override { return true; }
 
-    // WiFi operations
+    // WiFi operations; scan results are also kept in ScanStore
     Core::Error scanNetworks(std::vector<AccessPoint>& aps);
+    // Returns at once and scans one channel at a time; ScanStore is updated after
+    // each channel, so results show up while the rest are still being scanned
+    Core::Error startAsyncScan(uint16_t channels = ALL_CHANNELS);
+    bool isScanning() const;
+    static void toAccessPoint(const ScanRecord& record, AccessPoint& ap);
     Core::Error connectToAP(const std::string& ssid, const std::string& password);
     Core::Error disconnect();
     Core::Error startAP(const std::string& ssid, const std::string& password = "");
@@ -56,9 +114,36 @@ public:
     // Attack functions
     Core::Error deauthAttack(const AccessPoint& ap, uint32_t count = 0);
     Core::Error beaconSpam(const std::vector<std::string>& ssids);
-    Core::Error startSniffer(std::function<void(const uint8_t*, size_t)> callback);
+    Core::Error startSniffer(SnifferCallback callback);
     Core::Error stopSniffer();
 
+    // One promiscuous session shared by every subscriber; it runs while anyone
+    // is subscribed and only receives the union of their frame types.
+    // Callbacks run in the WiFi task and must not unsubscribe themselves.
+    int subscribeSniffer(SnifferCallback callback, uint8_t types = SNIFF_ALL);  // -1 when full
+    // Only frames matching the filter reach the callback; the driver gets filter.typeMask()
+    int subscribeSniffer(SnifferCallback callback, const FrameFilter& filter);
+    void unsubscribeSniffer(int id);
+    void getSnifferStats(std::vector<SnifferStats>& stats) const;
+
+    // pcap capture to the SD card (see PcapWriter); runs alongside the sniffer callback
+    Core::Error startCapture(uint32_t maxFileSize = 32 * 1024 * 1024,
+                             const FrameFilter& filter = FrameFilter());
+    Core::Error stopCapture(bool wait = true);  // wait: until the file is closed
+    bool isCapturing() const { return _captureSubscription >= 0; }
+
+    // Passive survey across all channels (see ChannelHopper); adaptive unless fixed is set
+    Core::Error startChannelHopper(bool fixed = false, uint32_t dwellMs = 250,
+                                   uint32_t revisitMs = 5000);
+    Core::Error stopChannelHopper();
+    bool isHopping() const { return _hopperSubscription >= 0; }
+
+    // Passive AP / station inventory from sniffed frames (see DeviceTable)
+    Core::Error startInventory();
+    Core::Error stopInventory();
+    bool isInventoryRunning() const { return _inventorySubscription >= 0; }
+    Core::Error getClients(const AccessPoint& ap, std::vector<Client>& clients);
+
     // Evil Portal
     Core::Error startEvilPortal(const std::string& ssid, const std::string& portalHtml = "");
     Core::Error stopEvilPortal();
@@ -117,10 +202,19 @@ private:
     std::string getIP() const;
 
 private:
-    bool _sniffing = false;
-    std::function<void(const uint8_t*, size_t)> _snifferCallback;
+    int _snifferSubscription = -1;
+    int _captureSubscription = -1;
+    int _hopperSubscription = -1;
+    int _inventorySubscription = -1;
+    bool _webRoutesAdded = false;
+
+    void registerWebRoutes();
 
     static void snifferCallback(void* buf, wifi_promiscuous_pkt_type_t type);
+    static int addSniffer(SnifferCallback callback, uint8_t types, const FrameFilter* filter);
+    static void onScanDone(arduino_event_id_t event, arduino_event_info_t info);
+    static void collectScanResults(int16_t count, std::vector<ScanRecord>& records);
+    static bool scanNextChannel();
     void sendDeauthFrame(const uint8_t* bssid, uint8_t channel);
 };
 
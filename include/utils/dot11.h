@@ -0,0 +1,258 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace NightStrike {
+namespace Utils {
+namespace Dot11 {
+
+/**
+ * @brief Bounds-checked, zero-copy 802.11 frame parser
+ *
+ * Frame wraps a received buffer without copying it; every accessor checks
+ * the length first and returns nullptr / an empty Span / false when the
+ * field is not in the frame, so truncated or malformed frames are safe to
+ * feed in. Spans point into the buffer and live as long as it does.
+ *
+ * Pass the length without the FCS: sniffer frames carry it, so use
+ * Frame::fromSniffer() for those.
+ */
+
+enum Type : uint8_t {
+    TYPE_MGMT = 0,
+    TYPE_CTRL = 1,
+    TYPE_DATA = 2,
+    TYPE_EXTENSION = 3
+};
+
+// Management subtypes
+enum Subtype : uint8_t {
+    ASSOC_REQ = 0,
+    ASSOC_RESP = 1,
+    REASSOC_REQ = 2,
+    REASSOC_RESP = 3,
+    PROBE_REQ = 4,
+    PROBE_RESP = 5,
+    BEACON = 8,
+    DISASSOC = 10,
+    AUTH = 11,
+    DEAUTH = 12,
+    ACTION = 13
+};
+
+// Element IDs
+static const uint8_t IE_SSID = 0;
+static const uint8_t IE_SUPPORTED_RATES = 1;
+static const uint8_t IE_DS_PARAMETER = 3;
+static const uint8_t IE_RSN = 48;
+static const uint8_t IE_VENDOR = 221;
+
+static const size_t FCS_LENGTH = 4;
+static const size_t MAC_LENGTH = 6;
+static const size_t MAX_SSID_LENGTH = 32;
+
+struct Span {
+    const uint8_t* data = nullptr;
+    size_t length = 0;
+
+    Span() = default;
+    Span(const uint8_t* d, size_t n) : data(d), length(n) {}
+
+    bool empty() const { return length == 0; }
+    bool equals(const char* str) const {
+        return strlen(str) == length && (length == 0 || memcmp(data, str, length) == 0);
+    }
+};
+
+struct Element {
+    uint8_t id;
+    Span body;
+};
+
+/**
+ * @brief Iterates tagged parameters (id, length, body)
+ *
+ * Stops at the first element that would run past the end, so a truncated
+ * tail is never returned.
+ */
+class ElementIterator {
+public:
+    ElementIterator() = default;
+    ElementIterator(const uint8_t* pos, const uint8_t* end) : _pos(pos), _end(end) { load(); }
+
+    const Element& operator*() const { return _element; }
+    const Element* operator->() const { return &_element; }
+    ElementIterator& operator++() {
+        _pos += 2 + _element.body.length;
+        load();
+        return *this;
+    }
+    bool operator!=(const ElementIterator& other) const { return _pos != other._pos; }
+
+private:
+    const uint8_t* _pos = nullptr;
+    const uint8_t* _end = nullptr;
+    Element _element = {0, Span()};
+
+    void load() {
+        // Compare remaining sizes, never pointers past the end
+        size_t remaining = _pos ? _end - _pos : 0;
+        if (remaining < 2 || remaining - 2 < _pos[1]) {
+            _pos = _end = nullptr;
+            return;
+        }
+        _element.id = _pos[0];
+        _element.body = Span(_pos + 2, _pos[1]);
+    }
+};
+
+class Elements {
+public:
+    Elements() = default;
+    explicit Elements(Span span) : _span(span) {}
+
+    ElementIterator begin() const {
+        return _span.data ? ElementIterator(_span.data, _span.data + _span.length)
+                          : ElementIterator();
+    }
+    ElementIterator end() const { return ElementIterator(); }
+
+    // First element with this id
+    bool find(uint8_t id, Span& body) const {
+        for (const Element& element : *this) {
+            if (element.id == id) {
+                body = element.body;
+                return true;
+            }
+        }
+        return false;
+    }
+
+private:
+    Span _span;
+};
+
+class Frame {
+public:
+    Frame(const uint8_t* data, size_t length) : _data(data), _length(data ? length : 0) {}
+
+    static Frame fromSniffer(const uint8_t* data, size_t length) {
+        return Frame(data, length > FCS_LENGTH ? length - FCS_LENGTH : 0);
+    }
+
+    bool valid() const { return _length >= 10; }  // Smallest frame: CTS / ACK
+    const uint8_t* data() const { return _data; }
+    size_t length() const { return _length; }
+
+    // Frame control
+    uint8_t type() const { return _length >= 2 ? (_data[0] >> 2) & 0x3 : 0; }
+    uint8_t subtype() const { return _length >= 2 ? _data[0] >> 4 : 0; }
+    uint8_t flags() const { return _length >= 2 ? _data[1] : 0; }
+    bool toDS() const { return flags() & 0x01; }
+    bool fromDS() const { return flags() & 0x02; }
+    bool retry() const { return flags() & 0x08; }
+    bool isProtected() const { return flags() & 0x40; }
+    bool is(uint8_t frameType, uint8_t frameSubtype) const {
+        return valid() && type() == frameType && subtype() == frameSubtype;
+    }
+
+    // Receiver, transmitter and the third address; nullptr when absent
+    const uint8_t* addr1() const { return field(4, MAC_LENGTH); }
+    const uint8_t* addr2() const { return field(10, MAC_LENGTH); }
+    const uint8_t* addr3() const { return type() == TYPE_CTRL ? nullptr : field(16, MAC_LENGTH); }
+    const uint8_t* addr4() const {
+        return type() == TYPE_DATA && toDS() && fromDS() ? field(24, MAC_LENGTH) : nullptr;
+    }
+
+    // Management: addr3. Data: depends on To/From DS; none between two APs.
+    const uint8_t* bssid() const {
+        if (type() == TYPE_MGMT) {
+            return addr3();
+        }
+        if (type() != TYPE_DATA) {
+            return nullptr;
+        }
+        switch (flags() & 0x3) {
+            case 0: return addr3();
+            case 1: return addr1();
+            case 2: return addr2();
+            default: return nullptr;
+        }
+    }
+
+    bool hasSequence() const { return type() != TYPE_CTRL && _length >= 24; }
+    uint16_t sequence() const { return hasSequence() ? (_data[22] | _data[23] << 8) >> 4 : 0; }
+    uint8_t fragment() const { return hasSequence() ? _data[22] & 0x0F : 0; }
+
+    // MAC header length, or 0 when the frame is shorter than its header
+    size_t headerLength() const {
+        size_t header;
+        switch (type()) {
+            case TYPE_MGMT:
+                header = 24;
+                break;
+            case TYPE_DATA:
+                header = 24 + (toDS() && fromDS() ? MAC_LENGTH : 0);
+                if (subtype() & 0x8) {
+                    header += 2;                              // QoS control
+                    header += flags() & 0x80 ? 4 : 0;         // HT control
+                }
+                break;
+            case TYPE_CTRL:
+                // CTS and ACK carry one address, the rest two
+                header = subtype() == 12 || subtype() == 13 ? 10 : 16;
+                break;
+            default:
+                return 0;
+        }
+        return _length >= header ? header : 0;
+    }
+
+    Span body() const {
+        size_t header = headerLength();
+        return header ? Span(_data + header, _length - header) : Span();
+    }
+
+    // Tagged parameters of a management frame, after its fixed fields
+    Elements elements() const {
+        if (type() != TYPE_MGMT || isProtected()) {
+            return Elements();
+        }
+        size_t fixed;
+        switch (subtype()) {
+            case PROBE_REQ:    fixed = 0; break;
+            case ASSOC_REQ:    fixed = 4; break;   // Capability, listen interval
+            case ASSOC_RESP:
+            case REASSOC_RESP: fixed = 6; break;   // Capability, status, AID
+            case REASSOC_REQ:  fixed = 10; break;  // + current AP
+            case PROBE_RESP:
+            case BEACON:       fixed = 12; break;  // Timestamp, interval, capability
+            case AUTH:         fixed = 6; break;   // Algorithm, sequence, status
+            default:           return Elements();
+        }
+        Span payload = body();
+        if (!payload.data || payload.length < fixed) {
+            return Elements();
+        }
+        return Elements(Span(payload.data + fixed, payload.length - fixed));
+    }
+
+    // SSID element; empty for wildcard probes and hidden networks
+    bool ssid(Span& out) const {
+        return elements().find(IE_SSID, out) && out.length <= MAX_SSID_LENGTH;
+    }
+
+private:
+    const uint8_t* _data;
+    size_t _length;
+
+    const uint8_t* field(size_t offset, size_t size) const {
+        return _length >= offset + size ? _data + offset : nullptr;
+    }
+};
+
+} // namespace Dot11
+} // namespace Utils
+} // namespace NightStrike
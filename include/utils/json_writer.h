@@ -0,0 +1,101 @@
+#pragma once
+
+#include <Arduino.h>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace NightStrike {
+namespace Utils {
+
+/**
+ * @brief Streaming JSON writer
+ *
+ * Renders straight into a Print (e.g. AsyncResponseStream) through a small
+ * fixed buffer, so building a response never allocates. Commas are inserted
+ * automatically and strings are escaped. Nesting is limited to MAX_DEPTH;
+ * deeper containers are written but stop getting separators right.
+ */
+class JsonWriter {
+public:
+    static const size_t BUFFER_SIZE = 128;
+    static const uint8_t MAX_DEPTH = 16;
+
+    explicit JsonWriter(Print& out) : _out(out) {}
+    ~JsonWriter() { flush(); }
+
+    JsonWriter(const JsonWriter&) = delete;
+    JsonWriter& operator=(const JsonWriter&) = delete;
+
+    JsonWriter& beginObject();
+    JsonWriter& endObject();
+    JsonWriter& beginArray();
+    JsonWriter& endArray();
+
+    // Object member name; the next value (or container) belongs to it
+    JsonWriter& key(const char* name);
+
+    JsonWriter& value(const char* str);
+    JsonWriter& value(const char* str, size_t length);
+    JsonWriter& value(const std::string& str) { return value(str.data(), str.size()); }
+    JsonWriter& value(bool b);
+    // Fundamental types, so int32_t/size_t/uint64_t resolve on every toolchain
+    JsonWriter& value(int n) { return value(static_cast<long long>(n)); }
+    JsonWriter& value(unsigned n) { return value(static_cast<unsigned long long>(n)); }
+    JsonWriter& value(long n) { return value(static_cast<long long>(n)); }
+    JsonWriter& value(unsigned long n) { return value(static_cast<unsigned long long>(n)); }
+    JsonWriter& value(long long n);
+    JsonWriter& value(unsigned long long n);
+    JsonWriter& value(double n);
+    JsonWriter& null();
+
+    // key(name).value(v)
+    template <typename T>
+    JsonWriter& field(const char* name, const T& v) {
+        return key(name).value(v);
+    }
+
+    void flush();
+    size_t bytesWritten() const { return _written + _used; }
+
+private:
+    Print& _out;
+    char _buffer[BUFFER_SIZE];
+    size_t _used = 0;
+    size_t _written = 0;
+
+    uint8_t _depth = 0;
+    uint32_t _hasItems = 0;  // Bit per nesting level: something was written there
+    bool _afterKey = false;
+
+    void separator();
+    void open(char c);
+    void close(char c);
+    void put(char c);
+    void put(const char* str, size_t length);
+    void putEscaped(const char* str, size_t length);
+};
+
+/**
+ * @brief Print that appends to a std::string, for JSON kept beyond one response
+ */
+class StringPrint : public Print {
+public:
+    explicit StringPrint(std::string& out) : _out(out) {}
+
+    size_t write(uint8_t c) override {
+        _out += static_cast<char>(c);
+        return 1;
+    }
+
+    size_t write(const uint8_t* data, size_t size) override {
+        _out.append(reinterpret_cast<const char*>(data), size);
+        return size;
+    }
+
+private:
+    std::string& _out;
+};
+
+} // namespace Utils
+} // namespace NightStrike
@@ -4,12 +4,20 @@ Pre-build script for NightStrike Firmware
 Handles version generation, configuration validation, etc.
 """
 
+import os
+import sys
+
 Import("env")
 
+# Web UI assets are embedded as generated headers, which must exist before
+# anything is compiled, so this runs when the script is loaded
+sys.path.insert(0, os.path.join(env.subst("$PROJECT_DIR"), "scripts"))
+import web_assets
+web_assets.generate(env.subst("$PROJECT_DIR"))
+
 def pre_build(source, target, env):
     """Pre-build hook"""
     print("[Pre-Build] NightStrike Firmware pre-build script")
     # TODO: Generate version info, validate configs, etc.
 
 env.AddPreAction("buildprog", pre_build)
-
@@ -0,0 +1,134 @@
+#!/usr/bin/env python3
+"""
+Embeds the web UI (web/*.html, *.js, *.css) into the firmware.
+
+Every asset is gzip-compressed and written as a flash array into
+include/generated/web_assets.h together with its MIME type and a strong
+ETag (content hash), so WebUI can serve it with Content-Encoding: gzip
+and answer revalidations with 304.
+
+Run from pre_build.py on every build, or by hand:
+    python3 scripts/web_assets.py [project_dir]
+"""
+
+import gzip
+import hashlib
+import os
+import sys
+
+WEB_DIR = "web"
+OUTPUT = os.path.join("include", "generated", "web_assets.h")
+
+MIME_TYPES = {
+    ".html": "text/html; charset=utf-8",
+    ".js": "application/javascript",
+    ".css": "text/css",
+    ".svg": "image/svg+xml",
+    ".ico": "image/x-icon",
+    ".json": "application/json",
+}
+
+
+def url_for(name):
+    """index.html is served at /, everything else under its file name"""
+    return "/" if name == "index.html" else "/" + name
+
+
+def collect(web_dir):
+    assets = []
+    for name in sorted(os.listdir(web_dir)):
+        ext = os.path.splitext(name)[1].lower()
+        if ext not in MIME_TYPES:
+            continue
+        with open(os.path.join(web_dir, name), "rb") as f:
+            raw = f.read()
+        # mtime=0 keeps the output (and so the ETag) reproducible
+        packed = gzip.compress(raw, compresslevel=9, mtime=0)
+        etag = hashlib.sha256(packed).hexdigest()[:16]
+        assets.append({
+            "name": name,
+            "url": url_for(name),
+            "mime": MIME_TYPES[ext],
+            "etag": etag,
+            "raw": len(raw),
+            "data": packed,
+        })
+    return assets
+
+
+def symbol_for(name):
+    return "WEB_ASSET_" + "".join(c.upper() if c.isalnum() else "_" for c in name)
+
+
+def render(assets):
+    out = [
+        "// Generated by scripts/web_assets.py from web/ - do not edit",
+        "#pragma once",
+        "",
+        "#include <Arduino.h>",
+        "#include <cstddef>",
+        "#include <cstdint>",
+        "",
+        "namespace NightStrike {",
+        "namespace Core {",
+        "",
+        "struct WebAsset {",
+        "    const char* url;",
+        "    const char* contentType;",
+        "    const char* etag;         // Quoted, ready for the ETag header",
+        "    const uint8_t* data;      // gzip",
+        "    size_t size;",
+        "    size_t uncompressedSize;",
+        "};",
+        "",
+    ]
+
+    for asset in assets:
+        data = asset["data"]
+        out.append("static const uint8_t %s[] PROGMEM = {" % symbol_for(asset["name"]))
+        for i in range(0, len(data), 16):
+            out.append("    " + ", ".join("0x%02x" % b for b in data[i:i + 16]) + ",")
+        out.append("};")
+        out.append("")
+
+    out.append("static const WebAsset WEB_ASSETS[] = {")
+    for asset in assets:
+        out.append('    {"%s", "%s", "\\"%s\\"", %s, %d, %d},' % (
+            asset["url"], asset["mime"], asset["etag"], symbol_for(asset["name"]),
+            len(asset["data"]), asset["raw"]))
+    out.append("};")
+    out.append("")
+    out.append("static const size_t WEB_ASSET_COUNT = %d;" % len(assets))
+    out.append("")
+    out.append("} // namespace Core")
+    out.append("} // namespace NightStrike")
+    out.append("")
+    return "\n".join(out)
+
+
+def generate(project_dir):
+    assets = collect(os.path.join(project_dir, WEB_DIR))
+    header = render(assets)
+
+    path = os.path.join(project_dir, OUTPUT)
+    os.makedirs(os.path.dirname(path), exist_ok=True)
+
+    # Only touch the file when it changes so web_ui.cpp isn't rebuilt every time
+    current = None
+    if os.path.exists(path):
+        with open(path, "r") as f:
+            current = f.read()
+    if current != header:
+        with open(path, "w") as f:
+            f.write(header)
+
+    raw_total = sum(a["raw"] for a in assets)
+    packed_total = sum(len(a["data"]) for a in assets)
+    for asset in assets:
+        print("[WebAssets] %-12s %6d -> %6d bytes  ETag %s" % (
+            asset["name"], asset["raw"], len(asset["data"]), asset["etag"]))
+    print("[WebAssets] Page load: %d -> %d bytes" % (raw_total, packed_total))
+
+
+if __name__ == "__main__":
+    generate(sys.argv[1] if len(sys.argv) > 1 else os.getcwd())
@@ -1,15 +1,55 @@
 #include "core/display.h"
 #include "core/hardware_detection.h"
+#include "core/logger.h"
 #include <Arduino.h>
+#include <algorithm>
+#include <cstdio>
 
 #ifdef HAS_SCREEN
 #include <TFT_eSPI.h>
+#include <esp_heap_caps.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/semphr.h>
 static TFT_eSPI tft;
 #endif
 
+#ifndef HEADLESS_DISPLAY_WIDTH
+#define HEADLESS_DISPLAY_WIDTH 240
+#endif
+#ifndef HEADLESS_DISPLAY_HEIGHT
+#define HEADLESS_DISPLAY_HEIGHT 135
+#endif
+
 namespace NightStrike {
 namespace Core {
 
+#ifdef HAS_SCREEN
+// Async flush state. The two canvases are large enough to be served from PSRAM,
+// which SPI DMA cannot read, so rows are staged through two small DMA-capable
+// strips: one is filled while the other is on the wire.
+static const size_t FLUSH_STRIP_PIXELS = 240 * 16;
+static const size_t FLUSH_HEAP_RESERVE = 64 * 1024;  // Internal RAM left for WiFi/BLE
+// pushRegion() itself needs little; the fps LOG_DEBUG (float printf) and the flush
+// callback dominate. getFlushStats().stackFree reports what is left in practice.
+static const uint32_t FLUSH_TASK_STACK = 4096;
+static Framebuffer* s_flushBuffers[2] = {nullptr, nullptr};
+static uint16_t* s_flushStrips[2] = {nullptr, nullptr};
+static TaskHandle_t s_flushTask = nullptr;
+static SemaphoreHandle_t s_flushIdle = nullptr;
+static const Framebuffer* s_pendingFrame = nullptr;
+static Framebuffer::Region s_pendingRegion;
+
+static void releaseFlushBuffers() {
+    for (int i = 0; i < 2; ++i) {
+        delete s_flushBuffers[i];
+        s_flushBuffers[i] = nullptr;
+        heap_caps_free(s_flushStrips[i]);
+        s_flushStrips[i] = nullptr;
+    }
+}
+#endif
+
 Display& Display::getInstance() {
     static Display instance;
     return instance;
@@ -38,6 +78,7 @@ Error Display::initialize() {
 #ifdef M5STICKC_PLUS2
         // M5StickC PLUS2: ST7789v2, 240x135, rotation 3 (landscape)
         tft.init();
+        tft.setSwapBytes(true);  // Label bitmaps are native-endian RGB565
         tft.setRotation(3);  // Landscape mode (horizontal)
         tft.fillScreen(TFT_BLACK);
         _size.width = 240;
@@ -45,6 +86,7 @@ Error Display::initialize() {
         Serial.printf("[Display] M5StickC PLUS2 TFT initialized (240x135 landscape)\n");
 #else
         tft.init();
+        tft.setSwapBytes(true);  // Label bitmaps are native-endian RGB565
         tft.setRotation(1);
         _size.width = tft.width();
         _size.height = tft.height();
@@ -56,6 +98,14 @@ Error Display::initialize() {
         _size.width = 80;
         _size.height = 24;
     }
+#elif defined(HEADLESS_DISPLAY)
+    // Host build: render into memory so frames can be inspected and diffed
+    if (!_canvas) {
+        _canvas = new Framebuffer(HEADLESS_DISPLAY_WIDTH, HEADLESS_DISPLAY_HEIGHT);
+    }
+    _size.width = _canvas->width();
+    _size.height = _canvas->height();
+    Serial.printf("[Display] Headless framebuffer initialized (%dx%d)\n", _size.width, _size.height);
 #else
     Serial.println("[Display] Running in serial-only mode");
     _size.width = 80;  // Terminal width
@@ -99,6 +149,10 @@ Error Display::setBrightness(uint8_t brightness) {
 }
 
 Error Display::setRotation(uint8_t rotation) {
+    if (_asyncFlush) {
+        return Error(ErrorCode::NOT_SUPPORTED, "Disable async flush first");
+    }
+
 #ifdef HAS_SCREEN
     tft.setRotation(rotation);
 #endif
@@ -110,6 +164,12 @@ Error Display::fillScreen(Color color) {
         return Error(ErrorCode::NOT_INITIALIZED);
     }
 
+    if (_canvas) {
+        _canvas->fill(color.value);
+        canvasTouched();
+        return Error(ErrorCode::SUCCESS);
+    }
+
 #ifdef HAS_SCREEN
     tft.fillScreen(color.value);
 #else
@@ -127,6 +187,12 @@ Error Display::drawPixel(Point pos, Color color) {
         return Error(ErrorCode::NOT_INITIALIZED);
     }
 
+    if (_canvas) {
+        _canvas->drawPixel(pos.x, pos.y, color.value);
+        canvasTouched();
+        return Error(ErrorCode::SUCCESS);
+    }
+
 #ifdef HAS_SCREEN
     tft.drawPixel(pos.x, pos.y, color.value);
 #endif
@@ -138,6 +204,12 @@ Error Display::drawLine(Point start, Point end, Color color) {
         return Error(ErrorCode::NOT_INITIALIZED);
     }
 
+    if (_canvas) {
+        _canvas->drawLine(start.x, start.y, end.x, end.y, color.value);
+        canvasTouched();
+        return Error(ErrorCode::SUCCESS);
+    }
+
 #ifdef HAS_SCREEN
     tft.drawLine(start.x, start.y, end.x, end.y, color.value);
 #endif
@@ -149,6 +221,16 @@ Error Display::drawRect(Point pos, Size size, Color color, bool filled) {
         return Error(ErrorCode::NOT_INITIALIZED);
     }
 
+    if (_canvas) {
+        if (filled) {
+            _canvas->fillRect(pos.x, pos.y, size.width, size.height, color.value);
+        } else {
+            _canvas->drawRect(pos.x, pos.y, size.width, size.height, color.value);
+        }
+        canvasTouched();
+        return Error(ErrorCode::SUCCESS);
+    }
+
 #ifdef HAS_SCREEN
     if (filled) {
         tft.fillRect(pos.x, pos.y, size.width, size.height, color.value);
@@ -164,6 +246,16 @@ Error Display::drawCircle(Point center, uint16_t radius, Color color, bool fille
         return Error(ErrorCode::NOT_INITIALIZED);
     }
 
+    if (_canvas) {
+        if (filled) {
+            _canvas->fillCircle(center.x, center.y, radius, color.value);
+        } else {
+            _canvas->drawCircle(center.x, center.y, radius, color.value);
+        }
+        canvasTouched();
+        return Error(ErrorCode::SUCCESS);
+    }
+
 #ifdef HAS_SCREEN
     if (filled) {
         tft.fillCircle(center.x, center.y, radius, color.value);
@@ -174,6 +266,54 @@ Error Display::drawCircle(Point center, uint16_t radius, Color color, bool fille
     return Error(ErrorCode::SUCCESS);
 }
 
+Error Display::drawTriangle(Point a, Point b, Point c, Color color, bool filled) {
+    if (!_initialized) {
+        return Error(ErrorCode::NOT_INITIALIZED);
+    }
+
+    if (_canvas) {
+        if (filled) {
+            _canvas->fillTriangle(a.x, a.y, b.x, b.y, c.x, c.y, color.value);
+        } else {
+            _canvas->drawLine(a.x, a.y, b.x, b.y, color.value);
+            _canvas->drawLine(b.x, b.y, c.x, c.y, color.value);
+            _canvas->drawLine(c.x, c.y, a.x, a.y, color.value);
+        }
+        canvasTouched();
+        return Error(ErrorCode::SUCCESS);
+    }
+
+#ifdef HAS_SCREEN
+    if (filled) {
+        tft.fillTriangle(a.x, a.y, b.x, b.y, c.x, c.y, color.value);
+    } else {
+        tft.drawTriangle(a.x, a.y, b.x, b.y, c.x, c.y, color.value);
+    }
+#endif
+    return Error(ErrorCode::SUCCESS);
+}
+
+Error Display::drawImage(Point pos, Size size, const uint16_t* pixels) {
+    if (!_initialized) {
+        return Error(ErrorCode::NOT_INITIALIZED);
+    }
+
+    if (!pixels) {
+        return Error(ErrorCode::INVALID_PARAMETER);
+    }
+
+    if (_canvas) {
+        _canvas->blit(pos.x, pos.y, size.width, size.height, pixels);
+        canvasTouched();
+        return Error(ErrorCode::SUCCESS);
+    }
+
+#ifdef HAS_SCREEN
+    tft.pushImage(pos.x, pos.y, size.width, size.height, pixels);
+#endif
+    return Error(ErrorCode::SUCCESS);
+}
+
 Error Display::setTextColor(Color foreground, Color background) {
     _textColor = foreground;
     _textBgColor = background;
@@ -204,9 +344,14 @@ Error Display::drawText(Point pos, const char* text) {
         return Error(ErrorCode::INVALID_PARAMETER);
     }
 
+    if (_canvas) {
+        drawLabel(pos, text);
+        canvasTouched();
+        return Error(ErrorCode::SUCCESS);
+    }
+
 #ifdef HAS_SCREEN
-    tft.setCursor(pos.x, pos.y);
-    tft.print(text);
+    drawLabel(pos, text);
 #else
     Serial.printf("[Display] Text: %s\n", text);
 #endif
@@ -218,25 +363,435 @@ Error Display::drawTextCentered(Point center, const char* text) {
         return Error(ErrorCode::INVALID_PARAMETER);
     }
 
+    // Width/height follow the 6x8 GLCD cell scaled by text size
+    uint32_t textWidth = GlyphAtlas::textWidth(strlen(text), _textSize);
+    uint32_t textHeight = GlyphAtlas::textHeight(_textSize);
+
+    // Far off-screen origins clamp rather than wrap back onto the panel
+    int32_t x = std::max<int32_t>(center.x - static_cast<int32_t>(textWidth / 2), INT16_MIN);
+    int32_t y = std::max<int32_t>(center.y - static_cast<int32_t>(textHeight / 2), INT16_MIN);
+
+    if (_canvas) {
+        drawLabel(Point(x, y), text);
+        canvasTouched();
+        return Error(ErrorCode::SUCCESS);
+    }
+
 #ifdef HAS_SCREEN
-    // Calculate text width and height manually
-    // Approximate: width = strlen * char_width, height = font_height
-    // For TFT_eSPI, typical char width is ~6 pixels per char at size 1
-    uint16_t charWidth = 6 * _textSize;
-    uint16_t charHeight = 8 * _textSize;
-    uint16_t textWidth = strlen(text) * charWidth;
-    uint16_t textHeight = charHeight;
-    
-    int16_t x = center.x - textWidth / 2;
-    int16_t y = center.y - textHeight / 2;
-    tft.setCursor(x, y);
-    tft.print(text);
+    drawLabel(Point(x, y), text);
 #else
     Serial.printf("[Display] Centered: %s\n", text);
 #endif
     return Error(ErrorCode::SUCCESS);
 }
 
+void Display::drawLabel(Point pos, const char* text) {
+    unsigned long start = micros();
+    _frameText.labels++;
+
+    size_t len = strlen(text);
+    uint32_t width = GlyphAtlas::textWidth(len, _textSize);
+    uint32_t height = GlyphAtlas::textHeight(_textSize);
+
+    // The atlas path covers single-line printable labels that fit on screen;
+    // anything that relies on TFT_eSPI wrapping or transparency goes through the driver
+    bool atlasPath = len > 0 && GlyphAtlas::canRender(text, len) &&
+                     _textColor.value != _textBgColor.value &&
+                     pos.x >= 0 && pos.y >= 0 &&
+                     pos.x + width <= _size.width && pos.y + height <= _size.height;
+    // From here on the atlas path's label fits the panel, so its size fits uint16_t
+
+    const TextCache::Entry* entry = nullptr;
+    if (atlasPath) {
+        entry = _textCache.find(text, len, _textColor.value, _textBgColor.value, _textSize);
+        if (entry) {
+            _frameText.cacheHits++;
+        } else {
+            TextCache::Entry* fresh = _textCache.insert(text, len, _textColor.value,
+                                                        _textBgColor.value, _textSize,
+                                                        static_cast<uint16_t>(width),
+                                                        static_cast<uint16_t>(height));
+            if (fresh) {
+                _atlas.rasterize(text, len, _textSize, _textColor.value, _textBgColor.value,
+                                 fresh->pixels.data(), width);
+                _frameText.cacheMisses++;
+                entry = fresh;
+            }
+        }
+    }
+
+    if (entry) {
+        if (_canvas) {
+            _canvas->blit(pos.x, pos.y, entry->width, entry->height, entry->pixels.data());
+        } else {
+#ifdef HAS_SCREEN
+            tft.pushImage(pos.x, pos.y, entry->width, entry->height, entry->pixels.data());
+#endif
+        }
+    } else {
+        _frameText.fallbacks++;
+        if (_canvas) {
+            drawCanvasText(pos, text, len);
+        } else {
+#ifdef HAS_SCREEN
+            tft.setTextColor(_textColor.value, _textBgColor.value);
+            tft.setTextSize(_textSize);
+            tft.setCursor(pos.x, pos.y);
+            tft.print(text);
+#endif
+        }
+    }
+
+    _frameText.renderMicros += micros() - start;
+}
+
+void Display::drawCanvasText(Point pos, const char* text, size_t len) {
+    // Mirrors TFT_eSPI print(): '\n' returns to column 0, long lines wrap at the edge
+    const uint16_t cellWidth = GlyphAtlas::textWidth(1, _textSize);
+    const uint16_t cellHeight = GlyphAtlas::textHeight(_textSize);
+    std::vector<uint16_t> cell(static_cast<size_t>(cellWidth) * cellHeight);
+    bool transparent = _textColor.value == _textBgColor.value;
+
+    // 32-bit cursor: many lines of text would wrap an int16_t back onto the panel
+    int32_t x = pos.x;
+    int32_t y = pos.y;
+    for (size_t i = 0; i < len && y < _size.height; ++i) {
+        char c = text[i];
+        if (c == '\n') {
+            x = 0;
+            y += cellHeight;
+            continue;
+        }
+        if (!GlyphAtlas::canRender(&c, 1)) {
+            continue;
+        }
+        if (x + cellWidth > _size.width) {
+            x = 0;
+            y += cellHeight;
+            if (y >= _size.height) {
+                break;
+            }
+        }
+
+        if (transparent) {
+            // fg == bg means "no background" in TFT_eSPI; rasterize a mask, plot glyph pixels
+            _atlas.rasterize(&c, 1, _textSize, 1, 0, cell.data(), cellWidth);
+            for (uint16_t cy = 0; cy < cellHeight; ++cy) {
+                for (uint16_t cx = 0; cx < cellWidth; ++cx) {
+                    if (cell[cy * cellWidth + cx]) {
+                        _canvas->drawPixel(x + cx, y + cy, _textColor.value);
+                    }
+                }
+            }
+        } else {
+            _atlas.rasterize(&c, 1, _textSize, _textColor.value, _textBgColor.value,
+                             cell.data(), cellWidth);
+            _canvas->blit(x, y, cellWidth, cellHeight, cell.data());
+        }
+        x += cellWidth;
+    }
+}
+
+// Drawing outside beginFrame()/endFrame() would otherwise sit in the canvas until
+// the next frame. Push it right away if that costs no wait, else leave it to update().
+void Display::canvasTouched() {
+    if (!_asyncFlush || _inFrame) {
+        return;
+    }
+
+    _unframedDirty = true;
+#ifdef HAS_SCREEN
+    if (uxSemaphoreGetCount(s_flushIdle) > 0) {
+        _unframedDirty = false;
+        {
+            std::lock_guard<std::mutex> guard(_flushStatsLock);
+            _flushStats.unframedFlushes++;
+        }
+        flush();
+    }
+#endif
+}
+
+void Display::update() {
+    if (_unframedDirty && !_inFrame) {
+        _unframedDirty = false;
+        {
+            std::lock_guard<std::mutex> guard(_flushStatsLock);
+            _flushStats.unframedFlushes++;
+        }
+        flush();
+    }
+}
+
+void Display::beginFrame() {
+    _frameText = TextStats();
+    _inFrame = true;
+}
+
+void Display::endFrame() {
+    _inFrame = false;
+    _unframedDirty = false;  // Whatever was drawn before goes out with this frame
+    _frameCount++;
+    _lastFrameText = _frameText;
+    LOG_DEBUG("[Display] Frame text: %u labels, %u us (%u hits, %u misses, %u fallbacks)",
+              _lastFrameText.labels, _lastFrameText.renderMicros, _lastFrameText.cacheHits,
+              _lastFrameText.cacheMisses, _lastFrameText.fallbacks);
+
+    if (_canvas) {
+        _lastFrameStats = _canvas->endFrame();
+        LOG_DEBUG("[Display] Frame %u: %u px written, %u changed, overdraw %.2f",
+                  _frameCount, _lastFrameStats.pixelsWritten, _lastFrameStats.pixelsChanged,
+                  _lastFrameStats.overdraw());
+
+        if (!_frameDumpDir.empty()) {
+            char path[128];
+            snprintf(path, sizeof(path), "%s/frame_%05u.png", _frameDumpDir.c_str(), _frameCount);
+            saveFrame(path);
+        }
+
+        if (_asyncFlush) {
+            flush();
+        }
+    }
+
+    if (_frameObserver) {
+        _frameObserver(_frameCount);
+    }
+}
+
+Error Display::enableAsyncFlush(bool enable) {
+    if (!_initialized) {
+        return Error(ErrorCode::NOT_INITIALIZED);
+    }
+
+#ifdef HAS_SCREEN
+    if (enable == _asyncFlush) {
+        return Error(ErrorCode::SUCCESS);
+    }
+
+    if (!enable) {
+        // Let the frame in flight finish, then draw straight to the panel again
+        xSemaphoreTake(s_flushIdle, portMAX_DELAY);
+        vTaskDelete(s_flushTask);
+        s_flushTask = nullptr;
+        vSemaphoreDelete(s_flushIdle);
+        s_flushIdle = nullptr;
+        tft.deInitDMA();
+        releaseFlushBuffers();
+        _canvas = nullptr;
+        _asyncFlush = false;
+        Serial.println("[Display] Async flush disabled");
+        return Error(ErrorCode::SUCCESS);
+    }
+
+    // Each canvas must fit in one block, and internal RAM must stay usable for the radios
+    size_t frameBytes = static_cast<size_t>(_size.width) * _size.height * sizeof(uint16_t);
+    for (int i = 0; i < 2; ++i) {
+        if (heap_caps_get_largest_free_block(MALLOC_CAP_8BIT) < frameBytes) {
+            releaseFlushBuffers();
+            return Error(ErrorCode::OUT_OF_MEMORY, "No room for frame buffers");
+        }
+        s_flushBuffers[i] = new Framebuffer(_size.width, _size.height, false);
+        s_flushStrips[i] = static_cast<uint16_t*>(
+            heap_caps_malloc(FLUSH_STRIP_PIXELS * sizeof(uint16_t), MALLOC_CAP_DMA));
+        if (!s_flushBuffers[i]->isValid() || !s_flushStrips[i]) {
+            releaseFlushBuffers();
+            return Error(ErrorCode::OUT_OF_MEMORY, "No room for frame buffers");
+        }
+    }
+
+    if (heap_caps_get_free_size(MALLOC_CAP_INTERNAL) < FLUSH_HEAP_RESERVE) {
+        releaseFlushBuffers();
+        return Error(ErrorCode::OUT_OF_MEMORY, "Frame buffers would exhaust internal RAM");
+    }
+
+    if (!tft.initDMA()) {
+        releaseFlushBuffers();
+        return Error(ErrorCode::NOT_SUPPORTED, "TFT DMA unavailable");
+    }
+
+    s_flushIdle = xSemaphoreCreateBinary();
+    xSemaphoreGive(s_flushIdle);
+    if (xTaskCreatePinnedToCore(flushTask, "DisplayFlush", FLUSH_TASK_STACK, this, 2,
+                                &s_flushTask, 0) !=
+        pdPASS) {
+        vSemaphoreDelete(s_flushIdle);
+        s_flushIdle = nullptr;
+        tft.deInitDMA();
+        releaseFlushBuffers();
+        return Error(ErrorCode::OPERATION_FAILED, "Failed to start flush task");
+    }
+
+    // Both canvases start black; match the panel so partial frames stay consistent
+    tft.fillScreen(TFT_BLACK);
+    _canvas = s_flushBuffers[0];
+    {
+        std::lock_guard<std::mutex> guard(_flushStatsLock);
+        _flushStats = FlushStats();
+    }
+    _asyncFlush = true;
+    Serial.printf("[Display] Async flush enabled (2x %u KB frame buffers)\n",
+                  static_cast<unsigned>(frameBytes / 1024));
+    return Error(ErrorCode::SUCCESS);
+#else
+    return Error(ErrorCode::NOT_SUPPORTED);
+#endif
+}
+
+Error Display::flush() {
+    if (!_asyncFlush) {
+        return Error(ErrorCode::NOT_SUPPORTED);
+    }
+
+#ifdef HAS_SCREEN
+    Framebuffer::Region region = _canvas->takeWrittenRegion();
+    if (region.empty()) {
+        std::lock_guard<std::mutex> guard(_flushStatsLock);
+        _flushStats.framesSkipped++;
+        return Error(ErrorCode::SUCCESS);
+    }
+
+    // Wait for the previous frame; this is the only point where the UI task blocks
+    unsigned long start = micros();
+    xSemaphoreTake(s_flushIdle, portMAX_DELAY);
+    {
+        std::lock_guard<std::mutex> guard(_flushStatsLock);
+        _flushStats.lastWaitMicros = micros() - start;
+    }
+
+    s_pendingFrame = _canvas;
+    s_pendingRegion = region;
+    xTaskNotifyGive(s_flushTask);
+
+    // Draw the next frame into the other canvas, brought up to date with this one
+    // so screens that only redraw a few widgets stay correct
+    Framebuffer* next = _canvas == s_flushBuffers[0] ? s_flushBuffers[1] : s_flushBuffers[0];
+    next->copyRegion(*_canvas, region);
+    _canvas = next;
+#endif
+    return Error(ErrorCode::SUCCESS);
+}
+
+void Display::flushTask(void* param) {
+#ifdef HAS_SCREEN
+    Display* display = static_cast<Display*>(param);
+    unsigned long windowStart = millis();
+    uint32_t windowFrames = 0;
+
+    while (true) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+        unsigned long start = micros();
+        display->pushRegion(*s_pendingFrame, s_pendingRegion);
+        uint32_t flushMicros = micros() - start;
+
+        // Updated and copied under the lock; the callback and the log use the copy
+        FlushStats stats;
+        windowFrames++;
+        unsigned long now = millis();
+        bool windowDone = now - windowStart >= 1000;
+        {
+            std::lock_guard<std::mutex> guard(display->_flushStatsLock);
+            FlushStats& shared = display->_flushStats;
+            shared.lastFlushMicros = flushMicros;
+            shared.lastPixels =
+                static_cast<uint32_t>(s_pendingRegion.width) * s_pendingRegion.height;
+            shared.framesFlushed++;
+            if (windowDone) {
+                shared.fps = windowFrames * 1000.0f / (now - windowStart);
+                shared.stackFree = uxTaskGetStackHighWaterMark(nullptr);
+            }
+            stats = shared;
+        }
+
+        if (windowDone) {
+            windowFrames = 0;
+            windowStart = now;
+            LOG_DEBUG("[Display] %.1f fps, last flush %u px in %u us (UI waited %u us), "
+                      "stack %u B free",
+                      stats.fps, stats.lastPixels, stats.lastFlushMicros, stats.lastWaitMicros,
+                      stats.stackFree);
+        }
+
+        xSemaphoreGive(s_flushIdle);
+        if (display->_flushCallback) {
+            display->_flushCallback(stats);
+        }
+    }
+#endif
+}
+
+void Display::pushRegion(const Framebuffer& frame, const Framebuffer::Region& region) {
+#ifdef HAS_SCREEN
+    const uint16_t rowsPerStrip = FLUSH_STRIP_PIXELS / region.width;
+    uint8_t strip = 0;
+
+    tft.startWrite();
+    for (uint16_t row = 0; row < region.height; row += rowsPerStrip) {
+        uint16_t rows = std::min<uint16_t>(rowsPerStrip, region.height - row);
+
+        // pushImageDMA waits for the previous transfer, so the strip used two
+        // pushes ago is free to refill while the other one is still sending
+        uint16_t* dst = s_flushStrips[strip];
+        for (uint16_t i = 0; i < rows; ++i) {
+            const uint16_t* src =
+                frame.data() + static_cast<size_t>(region.y + row + i) * frame.width() + region.x;
+            memcpy(dst + static_cast<size_t>(i) * region.width, src,
+                   region.width * sizeof(uint16_t));
+        }
+        tft.pushImageDMA(region.x, region.y + row, region.width, rows, dst);
+        strip ^= 1;
+    }
+    tft.dmaWait();
+    tft.endWrite();
+#endif
+}
+
+Display::FlushStats Display::getFlushStats() const {
+    std::lock_guard<std::mutex> guard(_flushStatsLock);
+    return _flushStats;
+}
+
+Error Display::saveFrame(const char* path) const {
+    if (!_canvas) {
+        return Error(ErrorCode::NOT_SUPPORTED, "No framebuffer");
+    }
+
+    if (!path) {
+        return Error(ErrorCode::INVALID_PARAMETER);
+    }
+
+    std::vector<uint8_t> image;
+    size_t len = strlen(path);
+    if (len > 4 && strcmp(path + len - 4, ".ppm") == 0) {
+        _canvas->encodePPM(image);
+    } else {
+        _canvas->encodePNG(image);
+    }
+
+    FILE* file = fopen(path, "wb");
+    if (!file) {
+        return Error(ErrorCode::FILE_WRITE_ERROR);
+    }
+
+    size_t written = fwrite(image.data(), 1, image.size(), file);
+    fclose(file);
+
+    if (written != image.size()) {
+        return Error(ErrorCode::FILE_WRITE_ERROR);
+    }
+    return Error(ErrorCode::SUCCESS);
+}
+
+Error Display::setFrameDumpDirectory(const char* dir) {
+    if (dir && !_canvas) {
+        return Error(ErrorCode::NOT_SUPPORTED, "No framebuffer");
+    }
+
+    _frameDumpDir = dir ? dir : "";
+    return Error(ErrorCode::SUCCESS);
+}
+
 Error Display::drawBatteryIndicator(Point pos, int level, bool charging) {
     if (!_initialized) {
         return Error(ErrorCode::NOT_INITIALIZED);
@@ -246,7 +801,7 @@ Error Display::drawBatteryIndicator(Point pos, int level, bool charging) {
         return Error(ErrorCode::INVALID_PARAMETER);
     }
 
-#ifdef HAS_SCREEN
+#if defined(HAS_SCREEN) || defined(HEADLESS_DISPLAY)
     // Battery icon: rectangle with rounded end + charging indicator
     const uint16_t width = 24;
     const uint16_t height = 12;
@@ -266,41 +821,42 @@ Error Display::drawBatteryIndicator(Point pos, int level, bool charging) {
     }
     
     // Draw battery body (rectangle)
-    tft.drawRect(pos.x, pos.y, width, height, outlineColor.value);
+    drawRect(pos, Size(width, height), outlineColor);
     
     // Draw battery tip (small rectangle on the right)
-    tft.fillRect(pos.x + width, pos.y + (height - tipHeight) / 2, tipWidth, tipHeight, outlineColor.value);
+    drawRect(Point(pos.x + width, pos.y + (height - tipHeight) / 2), Size(tipWidth, tipHeight),
+             outlineColor, true);
     
     // Draw battery fill (level indicator)
     uint16_t fillWidth = ((width - 2) * level) / 100;
     if (fillWidth > 0) {
-        tft.fillRect(pos.x + 1, pos.y + 1, fillWidth, height - 2, fillColor.value);
+        drawRect(Point(pos.x + 1, pos.y + 1), Size(fillWidth, height - 2), fillColor, true);
     }
     
     // Draw charging indicator (lightning bolt) if charging
     if (charging) {
         // Simple lightning bolt: small triangle
-        tft.fillTriangle(
-            pos.x + width / 2, pos.y + 2,
-            pos.x + width / 2 - 2, pos.y + height / 2,
-            pos.x + width / 2 + 2, pos.y + height / 2,
-            Color::White().value
-        );
-        tft.fillTriangle(
-            pos.x + width / 2, pos.y + height - 2,
-            pos.x + width / 2 - 2, pos.y + height / 2,
-            pos.x + width / 2 + 2, pos.y + height / 2,
-            Color::White().value
-        );
+        drawTriangle(Point(pos.x + width / 2, pos.y + 2),
+                     Point(pos.x + width / 2 - 2, pos.y + height / 2),
+                     Point(pos.x + width / 2 + 2, pos.y + height / 2),
+                     Color::White(), true);
+        drawTriangle(Point(pos.x + width / 2, pos.y + height - 2),
+                     Point(pos.x + width / 2 - 2, pos.y + height / 2),
+                     Point(pos.x + width / 2 + 2, pos.y + height / 2),
+                     Color::White(), true);
     }
     
-    // Draw percentage text next to battery icon
+    // Draw percentage text next to battery icon, keeping the caller's text style
     char percentStr[5];
     snprintf(percentStr, sizeof(percentStr), "%d%%", level);
-    tft.setTextColor(Color::White().value, Color::Black().value);
-    tft.setTextSize(1);
-    tft.setCursor(pos.x + width + tipWidth + 2, pos.y + 2);
-    tft.print(percentStr);
+    Color savedFg = _textColor;
+    Color savedBg = _textBgColor;
+    uint8_t savedSize = _textSize;
+    setTextColor(Color::White(), Color::Black());
+    setTextSize(1);
+    drawText(Point(pos.x + width + tipWidth + 2, pos.y + 2), percentStr);
+    setTextColor(savedFg, savedBg);
+    setTextSize(savedSize);
 #else
     Serial.printf("[Display] Battery: %d%% %s\n", level, charging ? "(charging)" : "");
 #endif
@@ -0,0 +1,381 @@
+#include "core/framebuffer.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace NightStrike {
+namespace Core {
+
+Framebuffer::Framebuffer(uint16_t width, uint16_t height, bool trackChanges)
+    : _width(width), _height(height), _trackChanges(trackChanges) {
+    size_t count = static_cast<size_t>(width) * height;
+    _pixels.assign(count, 0);
+    if (trackChanges) {
+        _previous.assign(count, 0);
+    }
+    resetWritten();
+}
+
+void Framebuffer::markWritten(int32_t x0, int32_t y0, int32_t x1, int32_t y1) {
+    _writtenX0 = std::min(_writtenX0, x0);
+    _writtenY0 = std::min(_writtenY0, y0);
+    _writtenX1 = std::max(_writtenX1, x1);
+    _writtenY1 = std::max(_writtenY1, y1);
+}
+
+void Framebuffer::resetWritten() {
+    _writtenX0 = _width;
+    _writtenY0 = _height;
+    _writtenX1 = 0;
+    _writtenY1 = 0;
+}
+
+Framebuffer::Region Framebuffer::takeWrittenRegion() {
+    Region region;
+    if (_writtenX1 > _writtenX0 && _writtenY1 > _writtenY0) {
+        region.x = _writtenX0;
+        region.y = _writtenY0;
+        region.width = _writtenX1 - _writtenX0;
+        region.height = _writtenY1 - _writtenY0;
+    }
+    resetWritten();
+    return region;
+}
+
+void Framebuffer::copyRegion(const Framebuffer& src, const Region& region) {
+    if (src._width != _width || src._height != _height || region.empty()) {
+        return;
+    }
+
+    for (uint16_t row = 0; row < region.height; ++row) {
+        size_t offset = static_cast<size_t>(region.y + row) * _width + region.x;
+        memcpy(&_pixels[offset], &src._pixels[offset], region.width * sizeof(uint16_t));
+    }
+}
+
+uint16_t Framebuffer::getPixel(int16_t x, int16_t y) const {
+    if (x < 0 || y < 0 || x >= _width || y >= _height) {
+        return 0;
+    }
+    return _pixels[static_cast<size_t>(y) * _width + x];
+}
+
+void Framebuffer::fill(uint16_t color) {
+    std::fill(_pixels.begin(), _pixels.end(), color);
+    _written += _pixels.size();
+    markWritten(0, 0, _width, _height);
+}
+
+void Framebuffer::drawPixel(int16_t x, int16_t y, uint16_t color) {
+    if (x < 0 || y < 0 || x >= _width || y >= _height) {
+        return;
+    }
+    _pixels[static_cast<size_t>(y) * _width + x] = color;
+    _written++;
+    markWritten(x, y, x + 1, y + 1);
+}
+
+void Framebuffer::drawHLine(int16_t x, int16_t y, int16_t w, uint16_t color) {
+    fillRect(x, y, w, 1, color);
+}
+
+void Framebuffer::drawVLine(int16_t x, int16_t y, int16_t h, uint16_t color) {
+    fillRect(x, y, 1, h, color);
+}
+
+void Framebuffer::fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+    int32_t x0 = std::max<int32_t>(x, 0);
+    int32_t y0 = std::max<int32_t>(y, 0);
+    int32_t x1 = std::min<int32_t>(static_cast<int32_t>(x) + w, _width);
+    int32_t y1 = std::min<int32_t>(static_cast<int32_t>(y) + h, _height);
+    if (x0 >= x1 || y0 >= y1) {
+        return;
+    }
+
+    for (int32_t row = y0; row < y1; ++row) {
+        uint16_t* line = &_pixels[static_cast<size_t>(row) * _width];
+        std::fill(line + x0, line + x1, color);
+    }
+    _written += (x1 - x0) * (y1 - y0);
+    markWritten(x0, y0, x1, y1);
+}
+
+void Framebuffer::drawRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+    if (w <= 0 || h <= 0) {
+        return;
+    }
+    drawHLine(x, y, w, color);
+    drawHLine(x, y + h - 1, w, color);
+    drawVLine(x, y + 1, h - 2, color);
+    drawVLine(x + w - 1, y + 1, h - 2, color);
+}
+
+void Framebuffer::drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color) {
+    // Bresenham
+    int32_t dx = std::abs(x1 - x0);
+    int32_t dy = -std::abs(y1 - y0);
+    int32_t sx = x0 < x1 ? 1 : -1;
+    int32_t sy = y0 < y1 ? 1 : -1;
+    int32_t err = dx + dy;
+
+    while (true) {
+        drawPixel(x0, y0, color);
+        if (x0 == x1 && y0 == y1) {
+            break;
+        }
+        int32_t e2 = 2 * err;
+        if (e2 >= dy) {
+            err += dy;
+            x0 += sx;
+        }
+        if (e2 <= dx) {
+            err += dx;
+            y0 += sy;
+        }
+    }
+}
+
+void Framebuffer::drawCircle(int16_t cx, int16_t cy, int16_t r, uint16_t color) {
+    // Midpoint circle
+    int16_t x = r;
+    int16_t y = 0;
+    int16_t err = 1 - r;
+
+    while (x >= y) {
+        drawPixel(cx + x, cy + y, color);
+        drawPixel(cx + y, cy + x, color);
+        drawPixel(cx - y, cy + x, color);
+        drawPixel(cx - x, cy + y, color);
+        drawPixel(cx - x, cy - y, color);
+        drawPixel(cx - y, cy - x, color);
+        drawPixel(cx + y, cy - x, color);
+        drawPixel(cx + x, cy - y, color);
+
+        y++;
+        if (err < 0) {
+            err += 2 * y + 1;
+        } else {
+            x--;
+            err += 2 * (y - x) + 1;
+        }
+    }
+}
+
+void Framebuffer::fillCircle(int16_t cx, int16_t cy, int16_t r, uint16_t color) {
+    int16_t x = r;
+    int16_t y = 0;
+    int16_t err = 1 - r;
+
+    while (x >= y) {
+        drawHLine(cx - x, cy + y, 2 * x + 1, color);
+        drawHLine(cx - x, cy - y, 2 * x + 1, color);
+        drawHLine(cx - y, cy + x, 2 * y + 1, color);
+        drawHLine(cx - y, cy - x, 2 * y + 1, color);
+
+        y++;
+        if (err < 0) {
+            err += 2 * y + 1;
+        } else {
+            x--;
+            err += 2 * (y - x) + 1;
+        }
+    }
+}
+
+void Framebuffer::fillTriangle(int16_t x0, int16_t y0, int16_t x1, int16_t y1,
+                               int16_t x2, int16_t y2, uint16_t color) {
+    // Sort vertices by y, then fill scanlines between the long and short edges
+    if (y0 > y1) {
+        std::swap(y0, y1);
+        std::swap(x0, x1);
+    }
+    if (y1 > y2) {
+        std::swap(y1, y2);
+        std::swap(x1, x2);
+    }
+    if (y0 > y1) {
+        std::swap(y0, y1);
+        std::swap(x0, x1);
+    }
+
+    if (y0 == y2) {
+        int16_t a = std::min(x0, std::min(x1, x2));
+        int16_t b = std::max(x0, std::max(x1, x2));
+        drawHLine(a, y0, b - a + 1, color);
+        return;
+    }
+
+    for (int32_t y = y0; y <= y2; ++y) {
+        int32_t xa = x0 + (x2 - x0) * (y - y0) / (y2 - y0);
+        int32_t xb;
+        if (y < y1) {
+            xb = x0 + (x1 - x0) * (y - y0) / (y1 - y0);
+        } else if (y2 != y1) {
+            xb = x1 + (x2 - x1) * (y - y1) / (y2 - y1);
+        } else {
+            xb = x1;
+        }
+        if (xa > xb) {
+            std::swap(xa, xb);
+        }
+        drawHLine(xa, y, xb - xa + 1, color);
+    }
+}
+
+void Framebuffer::blit(int16_t x, int16_t y, uint16_t w, uint16_t h, const uint16_t* src) {
+    int32_t x0 = std::max<int32_t>(x, 0);
+    int32_t y0 = std::max<int32_t>(y, 0);
+    int32_t x1 = std::min<int32_t>(static_cast<int32_t>(x) + w, _width);
+    int32_t y1 = std::min<int32_t>(static_cast<int32_t>(y) + h, _height);
+    if (!src || x0 >= x1 || y0 >= y1) {
+        return;
+    }
+
+    for (int32_t row = y0; row < y1; ++row) {
+        const uint16_t* in = src + static_cast<size_t>(row - y) * w + (x0 - x);
+        memcpy(&_pixels[static_cast<size_t>(row) * _width + x0], in,
+               (x1 - x0) * sizeof(uint16_t));
+    }
+    _written += (x1 - x0) * (y1 - y0);
+    markWritten(x0, y0, x1, y1);
+}
+
+Framebuffer::FrameStats Framebuffer::endFrame() {
+    FrameStats stats;
+    stats.pixelsWritten = _written;
+    _written = 0;
+
+    if (!_trackChanges) {
+        return stats;
+    }
+
+    int32_t minX = _width, minY = _height, maxX = -1, maxY = -1;
+    for (uint16_t y = 0; y < _height; ++y) {
+        const uint16_t* cur = &_pixels[static_cast<size_t>(y) * _width];
+        const uint16_t* prev = &_previous[static_cast<size_t>(y) * _width];
+        if (memcmp(cur, prev, _width * sizeof(uint16_t)) == 0) {
+            continue;
+        }
+        for (uint16_t x = 0; x < _width; ++x) {
+            if (cur[x] != prev[x]) {
+                stats.pixelsChanged++;
+                minX = std::min<int32_t>(minX, x);
+                maxX = std::max<int32_t>(maxX, x);
+                minY = std::min<int32_t>(minY, y);
+                maxY = y;
+            }
+        }
+    }
+
+    if (stats.pixelsChanged > 0) {
+        stats.dirtyX = minX;
+        stats.dirtyY = minY;
+        stats.dirtyWidth = maxX - minX + 1;
+        stats.dirtyHeight = maxY - minY + 1;
+        _previous = _pixels;
+    }
+    return stats;
+}
+
+void Framebuffer::rowToRGB(uint16_t y, uint8_t* out) const {
+    const uint16_t* line = &_pixels[static_cast<size_t>(y) * _width];
+    for (uint16_t x = 0; x < _width; ++x) {
+        uint16_t v = line[x];
+        uint8_t r = (v >> 11) & 0x1F;
+        uint8_t g = (v >> 5) & 0x3F;
+        uint8_t b = v & 0x1F;
+        *out++ = (r << 3) | (r >> 2);
+        *out++ = (g << 2) | (g >> 4);
+        *out++ = (b << 3) | (b >> 2);
+    }
+}
+
+void Framebuffer::encodePPM(std::vector<uint8_t>& out) const {
+    char header[32];
+    int headerLen = snprintf(header, sizeof(header), "P6\n%u %u\n255\n", _width, _height);
+
+    out.resize(headerLen + static_cast<size_t>(_width) * _height * 3);
+    memcpy(out.data(), header, headerLen);
+    for (uint16_t y = 0; y < _height; ++y) {
+        rowToRGB(y, out.data() + headerLen + static_cast<size_t>(y) * _width * 3);
+    }
+}
+
+static uint32_t crc32Update(uint32_t crc, const uint8_t* data, size_t len) {
+    crc = ~crc;
+    for (size_t i = 0; i < len; ++i) {
+        crc ^= data[i];
+        for (int k = 0; k < 8; ++k) {
+            crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1u)));
+        }
+    }
+    return ~crc;
+}
+
+static void putBE32(std::vector<uint8_t>& out, uint32_t v) {
+    out.push_back(v >> 24);
+    out.push_back(v >> 16);
+    out.push_back(v >> 8);
+    out.push_back(v);
+}
+
+static void putChunk(std::vector<uint8_t>& out, const char* type, const uint8_t* data, size_t len) {
+    putBE32(out, len);
+    size_t start = out.size();
+    out.insert(out.end(), type, type + 4);
+    out.insert(out.end(), data, data + len);
+    putBE32(out, crc32Update(0, &out[start], len + 4));
+}
+
+void Framebuffer::encodePNG(std::vector<uint8_t>& out) const {
+    // Uncompressed (stored deflate blocks) truecolor PNG: no zlib dependency,
+    // still readable by every image viewer and diff tool
+    static const uint8_t signature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+    out.assign(signature, signature + sizeof(signature));
+
+    uint8_t ihdr[13] = {
+        0, 0, static_cast<uint8_t>(_width >> 8), static_cast<uint8_t>(_width),
+        0, 0, static_cast<uint8_t>(_height >> 8), static_cast<uint8_t>(_height),
+        8, 2, 0, 0, 0  // 8-bit RGB, deflate, adaptive filter, no interlace
+    };
+    putChunk(out, "IHDR", ihdr, sizeof(ihdr));
+
+    // Raw scanlines, each prefixed with filter type 0
+    size_t rowBytes = static_cast<size_t>(_width) * 3 + 1;
+    std::vector<uint8_t> raw(rowBytes * _height);
+    for (uint16_t y = 0; y < _height; ++y) {
+        raw[y * rowBytes] = 0;
+        rowToRGB(y, &raw[y * rowBytes + 1]);
+    }
+
+    std::vector<uint8_t> zlib;
+    zlib.reserve(raw.size() + raw.size() / 65535 * 5 + 16);
+    zlib.push_back(0x78);
+    zlib.push_back(0x01);
+    size_t pos = 0;
+    do {
+        size_t blockLen = std::min<size_t>(raw.size() - pos, 65535);
+        bool last = pos + blockLen >= raw.size();
+        zlib.push_back(last ? 1 : 0);
+        zlib.push_back(blockLen & 0xFF);
+        zlib.push_back(blockLen >> 8);
+        zlib.push_back(~blockLen & 0xFF);
+        zlib.push_back((~blockLen >> 8) & 0xFF);
+        zlib.insert(zlib.end(), raw.begin() + pos, raw.begin() + pos + blockLen);
+        pos += blockLen;
+    } while (pos < raw.size());
+
+    uint32_t a = 1, b = 0;
+    for (uint8_t byte : raw) {
+        a = (a + byte) % 65521;
+        b = (b + a) % 65521;
+    }
+    putBE32(zlib, (b << 16) | a);
+
+    putChunk(out, "IDAT", zlib.data(), zlib.size());
+    putChunk(out, "IEND", nullptr, 0);
+}
+
+} // namespace Core
+} // namespace NightStrike
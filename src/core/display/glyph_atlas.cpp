@@ -0,0 +1,184 @@
+#include "core/glyph_atlas.h"
+#include <cstring>
+
+namespace NightStrike {
+namespace Core {
+
+// Classic 5x7 GLCD font (the TFT_eSPI / Adafruit GFX default font), pre-transposed
+// to row-major order: 8 rows per glyph, bit 5 = leftmost column, bit 0 = spacing.
+// Covers 0x20..0x7E.
+static const uint8_t FONT_ROWS[95][GlyphAtlas::GLYPH_HEIGHT] = {
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},  // space
+    {0x08, 0x08, 0x08, 0x08, 0x08, 0x00, 0x08, 0x00},  // !
+    {0x14, 0x14, 0x14, 0x00, 0x00, 0x00, 0x00, 0x00},  // "
+    {0x14, 0x14, 0x3E, 0x14, 0x3E, 0x14, 0x14, 0x00},  // #
+    {0x08, 0x1E, 0x28, 0x1C, 0x0A, 0x3C, 0x08, 0x00},  // $
+    {0x30, 0x32, 0x04, 0x08, 0x10, 0x26, 0x06, 0x00},  // %
+    {0x10, 0x28, 0x28, 0x10, 0x2A, 0x24, 0x1A, 0x00},  // &
+    {0x0C, 0x0C, 0x08, 0x10, 0x00, 0x00, 0x00, 0x00},  // '
+    {0x04, 0x08, 0x10, 0x10, 0x10, 0x08, 0x04, 0x00},  // (
+    {0x10, 0x08, 0x04, 0x04, 0x04, 0x08, 0x10, 0x00},  // )
+    {0x08, 0x2A, 0x1C, 0x3E, 0x1C, 0x2A, 0x08, 0x00},  // *
+    {0x00, 0x08, 0x08, 0x3E, 0x08, 0x08, 0x00, 0x00},  // +
+    {0x00, 0x00, 0x00, 0x00, 0x0C, 0x0C, 0x08, 0x10},  // ,
+    {0x00, 0x00, 0x00, 0x3E, 0x00, 0x00, 0x00, 0x00},  // -
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x0C, 0x0C, 0x00},  // .
+    {0x00, 0x02, 0x04, 0x08, 0x10, 0x20, 0x00, 0x00},  // /
+    {0x1C, 0x22, 0x26, 0x2A, 0x32, 0x22, 0x1C, 0x00},  // 0
+    {0x08, 0x18, 0x08, 0x08, 0x08, 0x08, 0x1C, 0x00},  // 1
+    {0x1C, 0x22, 0x02, 0x1C, 0x20, 0x20, 0x3E, 0x00},  // 2
+    {0x3E, 0x02, 0x04, 0x0C, 0x02, 0x22, 0x1C, 0x00},  // 3
+    {0x04, 0x0C, 0x14, 0x24, 0x3E, 0x04, 0x04, 0x00},  // 4
+    {0x3E, 0x20, 0x3C, 0x02, 0x02, 0x22, 0x1C, 0x00},  // 5
+    {0x0E, 0x10, 0x20, 0x3C, 0x22, 0x22, 0x1C, 0x00},  // 6
+    {0x3E, 0x02, 0x02, 0x04, 0x08, 0x10, 0x20, 0x00},  // 7
+    {0x1C, 0x22, 0x22, 0x1C, 0x22, 0x22, 0x1C, 0x00},  // 8
+    {0x1C, 0x22, 0x22, 0x1E, 0x02, 0x04, 0x38, 0x00},  // 9
+    {0x00, 0x00, 0x08, 0x00, 0x08, 0x00, 0x00, 0x00},  // :
+    {0x00, 0x00, 0x08, 0x00, 0x08, 0x08, 0x10, 0x00},  // ;
+    {0x02, 0x04, 0x08, 0x10, 0x08, 0x04, 0x02, 0x00},  // <
+    {0x00, 0x00, 0x3E, 0x00, 0x3E, 0x00, 0x00, 0x00},  // =
+    {0x10, 0x08, 0x04, 0x02, 0x04, 0x08, 0x10, 0x00},  // >
+    {0x1C, 0x22, 0x02, 0x0C, 0x08, 0x00, 0x08, 0x00},  // ?
+    {0x1C, 0x22, 0x2A, 0x2E, 0x2C, 0x20, 0x1E, 0x00},  // @
+    {0x08, 0x14, 0x22, 0x22, 0x3E, 0x22, 0x22, 0x00},  // A
+    {0x3C, 0x22, 0x22, 0x3C, 0x22, 0x22, 0x3C, 0x00},  // B
+    {0x1C, 0x22, 0x20, 0x20, 0x20, 0x22, 0x1C, 0x00},  // C
+    {0x3C, 0x22, 0x22, 0x22, 0x22, 0x22, 0x3C, 0x00},  // D
+    {0x3E, 0x20, 0x20, 0x3C, 0x20, 0x20, 0x3E, 0x00},  // E
+    {0x3E, 0x20, 0x20, 0x3C, 0x20, 0x20, 0x20, 0x00},  // F
+    {0x1E, 0x22, 0x20, 0x20, 0x26, 0x22, 0x1E, 0x00},  // G
+    {0x22, 0x22, 0x22, 0x3E, 0x22, 0x22, 0x22, 0x00},  // H
+    {0x1C, 0x08, 0x08, 0x08, 0x08, 0x08, 0x1C, 0x00},  // I
+    {0x0E, 0x04, 0x04, 0x04, 0x04, 0x24, 0x18, 0x00},  // J
+    {0x22, 0x24, 0x28, 0x30, 0x28, 0x24, 0x22, 0x00},  // K
+    {0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x3E, 0x00},  // L
+    {0x22, 0x36, 0x2A, 0x2A, 0x2A, 0x22, 0x22, 0x00},  // M
+    {0x22, 0x22, 0x32, 0x2A, 0x26, 0x22, 0x22, 0x00},  // N
+    {0x1C, 0x22, 0x22, 0x22, 0x22, 0x22, 0x1C, 0x00},  // O
+    {0x3C, 0x22, 0x22, 0x3C, 0x20, 0x20, 0x20, 0x00},  // P
+    {0x1C, 0x22, 0x22, 0x22, 0x2A, 0x24, 0x1A, 0x00},  // Q
+    {0x3C, 0x22, 0x22, 0x3C, 0x28, 0x24, 0x22, 0x00},  // R
+    {0x1C, 0x22, 0x20, 0x1C, 0x02, 0x22, 0x1C, 0x00},  // S
+    {0x3E, 0x2A, 0x08, 0x08, 0x08, 0x08, 0x08, 0x00},  // T
+    {0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x1C, 0x00},  // U
+    {0x22, 0x22, 0x22, 0x22, 0x22, 0x14, 0x08, 0x00},  // V
+    {0x22, 0x22, 0x22, 0x2A, 0x2A, 0x2A, 0x14, 0x00},  // W
+    {0x22, 0x22, 0x14, 0x08, 0x14, 0x22, 0x22, 0x00},  // X
+    {0x22, 0x22, 0x14, 0x08, 0x08, 0x08, 0x08, 0x00},  // Y
+    {0x3E, 0x02, 0x04, 0x1C, 0x10, 0x20, 0x3E, 0x00},  // Z
+    {0x1E, 0x10, 0x10, 0x10, 0x10, 0x10, 0x1E, 0x00},  // [
+    {0x00, 0x20, 0x10, 0x08, 0x04, 0x02, 0x00, 0x00},  // backslash
+    {0x1E, 0x02, 0x02, 0x02, 0x02, 0x02, 0x1E, 0x00},  // ]
+    {0x08, 0x14, 0x22, 0x00, 0x00, 0x00, 0x00, 0x00},  // ^
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x3E, 0x00},  // _
+    {0x18, 0x18, 0x08, 0x04, 0x00, 0x00, 0x00, 0x00},  // `
+    {0x00, 0x00, 0x18, 0x04, 0x1C, 0x24, 0x1E, 0x00},  // a
+    {0x20, 0x20, 0x2C, 0x32, 0x22, 0x32, 0x2C, 0x00},  // b
+    {0x00, 0x00, 0x1C, 0x22, 0x20, 0x22, 0x1C, 0x00},  // c
+    {0x02, 0x02, 0x1A, 0x26, 0x22, 0x26, 0x1A, 0x00},  // d
+    {0x00, 0x00, 0x1C, 0x22, 0x3E, 0x20, 0x1C, 0x00},  // e
+    {0x04, 0x0A, 0x08, 0x1C, 0x08, 0x08, 0x08, 0x00},  // f
+    {0x00, 0x00, 0x1C, 0x26, 0x26, 0x1A, 0x02, 0x1C},  // g
+    {0x20, 0x20, 0x2C, 0x32, 0x22, 0x22, 0x22, 0x00},  // h
+    {0x08, 0x00, 0x18, 0x08, 0x08, 0x08, 0x1C, 0x00},  // i
+    {0x04, 0x00, 0x04, 0x04, 0x04, 0x24, 0x18, 0x00},  // j
+    {0x20, 0x20, 0x24, 0x28, 0x30, 0x28, 0x24, 0x00},  // k
+    {0x18, 0x08, 0x08, 0x08, 0x08, 0x08, 0x1C, 0x00},  // l
+    {0x00, 0x00, 0x34, 0x2A, 0x2A, 0x2A, 0x2A, 0x00},  // m
+    {0x00, 0x00, 0x2C, 0x32, 0x22, 0x22, 0x22, 0x00},  // n
+    {0x00, 0x00, 0x1C, 0x22, 0x22, 0x22, 0x1C, 0x00},  // o
+    {0x00, 0x00, 0x2C, 0x32, 0x32, 0x2C, 0x20, 0x20},  // p
+    {0x00, 0x00, 0x1A, 0x26, 0x26, 0x1A, 0x02, 0x02},  // q
+    {0x00, 0x00, 0x2C, 0x32, 0x20, 0x20, 0x20, 0x00},  // r
+    {0x00, 0x00, 0x1E, 0x20, 0x1C, 0x02, 0x3C, 0x00},  // s
+    {0x08, 0x08, 0x3E, 0x08, 0x08, 0x0A, 0x04, 0x00},  // t
+    {0x00, 0x00, 0x22, 0x22, 0x22, 0x26, 0x1A, 0x00},  // u
+    {0x00, 0x00, 0x22, 0x22, 0x22, 0x14, 0x08, 0x00},  // v
+    {0x00, 0x00, 0x22, 0x22, 0x2A, 0x2A, 0x14, 0x00},  // w
+    {0x00, 0x00, 0x22, 0x14, 0x08, 0x14, 0x22, 0x00},  // x
+    {0x00, 0x00, 0x22, 0x22, 0x1E, 0x02, 0x22, 0x1C},  // y
+    {0x00, 0x00, 0x3E, 0x04, 0x08, 0x10, 0x3E, 0x00},  // z
+    {0x04, 0x08, 0x08, 0x10, 0x08, 0x08, 0x04, 0x00},  // {
+    {0x08, 0x08, 0x08, 0x00, 0x08, 0x08, 0x08, 0x00},  // |
+    {0x10, 0x08, 0x08, 0x04, 0x08, 0x08, 0x10, 0x00},  // }
+    {0x10, 0x2A, 0x04, 0x00, 0x00, 0x00, 0x00, 0x00},  // ~
+};
+
+bool GlyphAtlas::canRender(const char* text, size_t len) {
+    for (size_t i = 0; i < len; ++i) {
+        if (text[i] < 0x20 || text[i] > 0x7E) {
+            return false;
+        }
+    }
+    return true;
+}
+
+const uint8_t* GlyphAtlas::glyphRows(char c) {
+    return FONT_ROWS[static_cast<uint8_t>(c) - 0x20];
+}
+
+void GlyphAtlas::buildRuns(uint16_t fg, uint16_t bg, uint8_t size) {
+    for (uint8_t mask = 0; mask < 64; ++mask) {
+        uint16_t* run = _runs[mask];
+        for (uint8_t col = 0; col < GLYPH_WIDTH; ++col) {
+            uint16_t color = (mask & (0x20 >> col)) ? fg : bg;
+            for (uint8_t s = 0; s < size; ++s) {
+                run[col * size + s] = color;
+            }
+        }
+    }
+    _runFg = fg;
+    _runBg = bg;
+    _runSize = size;
+}
+
+void GlyphAtlas::rasterize(const char* text, size_t len, uint8_t size,
+                           uint16_t fg, uint16_t bg, uint16_t* dst, uint16_t stride) {
+    if (!text || !dst || size == 0) {
+        return;
+    }
+
+    const uint16_t runWidth = GLYPH_WIDTH * size;
+
+    if (size <= MAX_RUN_SCALE) {
+        if (_runSize != size || _runFg != fg || _runBg != bg) {
+            buildRuns(fg, bg, size);
+        }
+
+        for (uint8_t row = 0; row < GLYPH_HEIGHT; ++row) {
+            uint16_t* line = dst + (row * size) * stride;
+            uint16_t* out = line;
+            for (size_t i = 0; i < len; ++i) {
+                memcpy(out, _runs[glyphRows(text[i])[row]], runWidth * sizeof(uint16_t));
+                out += runWidth;
+            }
+            // Vertical scaling: duplicate the finished row
+            for (uint8_t s = 1; s < size; ++s) {
+                memcpy(line + s * stride, line, len * runWidth * sizeof(uint16_t));
+            }
+        }
+        return;
+    }
+
+    // Large sizes (splash screens) expand pixel by pixel
+    for (uint8_t row = 0; row < GLYPH_HEIGHT; ++row) {
+        uint16_t* line = dst + (row * size) * stride;
+        uint16_t* out = line;
+        for (size_t i = 0; i < len; ++i) {
+            uint8_t mask = glyphRows(text[i])[row];
+            for (uint8_t col = 0; col < GLYPH_WIDTH; ++col) {
+                uint16_t color = (mask & (0x20 >> col)) ? fg : bg;
+                for (uint8_t s = 0; s < size; ++s) {
+                    *out++ = color;
+                }
+            }
+        }
+        for (uint8_t s = 1; s < size; ++s) {
+            memcpy(line + s * stride, line, len * runWidth * sizeof(uint16_t));
+        }
+    }
+}
+
+} // namespace Core
+} // namespace NightStrike
@@ -0,0 +1,228 @@
+#include "core/spectrum_chart.h"
+#include <Arduino.h>
+#include <algorithm>
+
+namespace NightStrike {
+namespace Core {
+
+static const uint16_t BAR_COLOR = 0x07E0;     // Green
+static const uint16_t PEAK_COLOR = 0xFFFF;    // White
+static const uint16_t CURSOR_COLOR = 0x7BEF;  // Grey
+static const uint16_t BACKGROUND = 0x0000;
+
+// Waterfall palette: black -> blue -> cyan -> yellow -> red
+static const uint16_t HEAT_PALETTE[16] = {
+    0x0000, 0x0008, 0x0010, 0x0018, 0x001F, 0x019F, 0x031F, 0x049F,
+    0x07FF, 0x07F0, 0x07E0, 0x5FE0, 0xBFE0, 0xFFE0, 0xFC00, 0xF800,
+};
+
+const int16_t SpectrumChart::NO_SAMPLE;
+
+SpectrumChart::SpectrumChart(const Config& config) : _config(config) {
+    if (_config.bins == 0) {
+        _config.bins = 1;
+    }
+    if (_config.smoothing == 0) {
+        _config.smoothing = 1;
+    }
+    if (_config.maxLevel <= _config.minLevel) {
+        _config.maxLevel = _config.minLevel + 1;
+    }
+
+    // Bins get whole pixels; the plot is centered in whatever width is left over
+    _binWidth = std::max<uint16_t>(1, _config.size.width / _config.bins);
+    uint16_t plotWidth = _binWidth * _config.bins;
+    _plotX = _config.origin.x + (static_cast<int16_t>(_config.size.width) - plotWidth) / 2;
+
+    _fallHeight = _config.size.height * std::min<uint8_t>(_config.waterfallPercent, 100) / 100;
+    _barHeight = _config.size.height - _fallHeight;
+    _barTop = _config.origin.y;
+    _fallTop = _barTop + _barHeight;
+
+    _pending.assign(_config.bins, NO_SAMPLE);
+    _average.assign(_config.bins, static_cast<int32_t>(_config.minLevel) * 16);
+    _recent.assign(_config.bins, NO_SAMPLE);
+    _snapAverage.assign(_config.bins, 0);
+    _snapRecent.assign(_config.bins, NO_SAMPLE);
+    _peak.assign(_config.bins, _config.minLevel);
+    _peakTime.assign(_config.bins, 0);
+    _barDrawn.assign(_config.bins, 0);
+    _peakDrawn.assign(_config.bins, 0);
+    _line.assign(plotWidth, BACKGROUND);
+}
+
+void SpectrumChart::addSample(uint16_t bin, int16_t level) {
+    if (bin >= _config.bins) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> guard(_lock);
+    _pending[bin] = std::max(_pending[bin], level);
+}
+
+void SpectrumChart::addSweep(const int16_t* levels, uint16_t count) {
+    if (!levels) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> guard(_lock);
+        count = std::min(count, _config.bins);
+        for (uint16_t i = 0; i < count; ++i) {
+            _pending[i] = std::max(_pending[i], levels[i]);
+        }
+    }
+    endSweep();
+}
+
+void SpectrumChart::endSweep() {
+    std::lock_guard<std::mutex> guard(_lock);
+    for (uint16_t i = 0; i < _config.bins; ++i) {
+        int16_t level = _pending[i];
+        if (level == NO_SAMPLE) {
+            continue;
+        }
+        // Fixed-point EMA: avg += (sample - avg) / N
+        _average[i] += (static_cast<int32_t>(level) * 16 - _average[i]) / _config.smoothing;
+        _recent[i] = std::max(_recent[i], level);
+        _pending[i] = NO_SAMPLE;
+    }
+    _sweeps++;
+}
+
+uint32_t SpectrumChart::getSweepCount() {
+    std::lock_guard<std::mutex> guard(_lock);
+    return _sweeps;
+}
+
+void SpectrumChart::getLevels(std::vector<int16_t>& levels) {
+    std::lock_guard<std::mutex> guard(_lock);
+    levels.resize(_config.bins);
+    for (uint16_t i = 0; i < _config.bins; ++i) {
+        levels[i] = _average[i] / 16;
+    }
+}
+
+void SpectrumChart::invalidate() {
+    _fullRedraw = true;
+}
+
+void SpectrumChart::reset() {
+    {
+        std::lock_guard<std::mutex> guard(_lock);
+        std::fill(_pending.begin(), _pending.end(), NO_SAMPLE);
+        std::fill(_average.begin(), _average.end(), static_cast<int32_t>(_config.minLevel) * 16);
+        std::fill(_recent.begin(), _recent.end(), NO_SAMPLE);
+        _sweeps = 0;
+    }
+    std::fill(_peak.begin(), _peak.end(), _config.minLevel);
+    _renderedSweeps = 0;
+    _fullRedraw = true;
+}
+
+uint16_t SpectrumChart::levelToHeight(int32_t level, uint16_t span) const {
+    if (level <= _config.minLevel) {
+        return 0;
+    }
+    if (level >= _config.maxLevel) {
+        return span;
+    }
+    return (level - _config.minLevel) * span / (_config.maxLevel - _config.minLevel);
+}
+
+uint16_t SpectrumChart::levelToColor(int16_t level) const {
+    if (level == NO_SAMPLE) {
+        return BACKGROUND;
+    }
+    return HEAT_PALETTE[levelToHeight(level, 15)];
+}
+
+void SpectrumChart::render(Display& display) {
+    bool newSweeps;
+    {
+        std::lock_guard<std::mutex> guard(_lock);
+        newSweeps = _sweeps != _renderedSweeps;
+        if (!newSweeps && !_fullRedraw) {
+            return;
+        }
+        _snapAverage = _average;
+        _snapRecent.swap(_recent);
+        std::fill(_recent.begin(), _recent.end(), NO_SAMPLE);
+        _renderedSweeps = _sweeps;
+    }
+
+    if (_fullRedraw) {
+        display.drawRect(_config.origin, _config.size, Display::Color(BACKGROUND), true);
+        std::fill(_barDrawn.begin(), _barDrawn.end(), 0);
+        std::fill(_peakDrawn.begin(), _peakDrawn.end(), 0);
+        _cursor = 0;
+        _fullRedraw = false;
+    }
+
+    uint32_t now = millis();
+    for (uint16_t bin = 0; bin < _config.bins; ++bin) {
+        int16_t recent = _snapRecent[bin];
+        if (_config.peakHoldMs > 0 && recent != NO_SAMPLE &&
+            (recent >= _peak[bin] || now - _peakTime[bin] > _config.peakHoldMs)) {
+            _peak[bin] = recent;
+            _peakTime[bin] = now;
+        }
+
+        uint16_t height = levelToHeight(_snapAverage[bin] / 16, _barHeight);
+        uint16_t peakHeight = _config.peakHoldMs > 0 ? levelToHeight(_peak[bin], _barHeight) : 0;
+        drawBar(display, bin, height, peakHeight);
+    }
+
+    if (newSweeps && _fallHeight > 0) {
+        for (uint16_t bin = 0; bin < _config.bins; ++bin) {
+            uint16_t color = levelToColor(_snapRecent[bin]);
+            std::fill_n(&_line[bin * _binWidth], _binWidth, color);
+        }
+        display.drawImage(Display::Point(_plotX, _fallTop + _cursor),
+                          Display::Size(_line.size(), 1), _line.data());
+
+        // The line after the newest one is the oldest; mark it so the wrap point is visible
+        _cursor = (_cursor + 1) % _fallHeight;
+        display.drawRect(Display::Point(_plotX, _fallTop + _cursor),
+                         Display::Size(_line.size(), 1), Display::Color(CURSOR_COLOR), true);
+    }
+}
+
+void SpectrumChart::drawBar(Display& display, uint16_t bin, uint16_t height,
+                            uint16_t peakHeight) {
+    uint16_t drawn = _barDrawn[bin];
+    uint16_t peakDrawn = _peakDrawn[bin];
+    if (height == drawn && peakHeight == peakDrawn) {
+        return;
+    }
+
+    int16_t x = _plotX + bin * _binWidth;
+    uint16_t width = _binWidth > 2 ? _binWidth - 1 : _binWidth;  // 1 px gap when there's room
+    int16_t bottom = _barTop + _barHeight;
+
+    // Grow or shrink only the segment between the old and new heights
+    if (height > drawn) {
+        display.drawRect(Display::Point(x, bottom - height), Display::Size(width, height - drawn),
+                         Display::Color(BAR_COLOR), true);
+    } else if (height < drawn) {
+        display.drawRect(Display::Point(x, bottom - drawn), Display::Size(width, drawn - height),
+                         Display::Color(BACKGROUND), true);
+    }
+
+    // Peak marker: restore what was under the old one, then draw the new one
+    if (peakDrawn > 0 && peakDrawn != peakHeight) {
+        Display::Color under(peakDrawn <= height ? BAR_COLOR : BACKGROUND);
+        display.drawRect(Display::Point(x, bottom - peakDrawn), Display::Size(width, 1), under,
+                         true);
+    }
+    if (peakHeight > 0) {
+        display.drawRect(Display::Point(x, bottom - peakHeight), Display::Size(width, 1),
+                         Display::Color(PEAK_COLOR), true);
+    }
+
+    _barDrawn[bin] = height;
+    _peakDrawn[bin] = peakHeight;
+}
+
+} // namespace Core
+} // namespace NightStrike
@@ -0,0 +1,79 @@
+#include "core/text_cache.h"
+#include <cstring>
+
+namespace NightStrike {
+namespace Core {
+
+uint32_t TextCache::hashKey(const char* text, size_t len, uint16_t fg, uint16_t bg, uint8_t size) {
+    // FNV-1a over the text, then mix in the style
+    uint32_t h = 2166136261u;
+    for (size_t i = 0; i < len; ++i) {
+        h = (h ^ static_cast<uint8_t>(text[i])) * 16777619u;
+    }
+    h = (h ^ fg) * 16777619u;
+    h = (h ^ bg) * 16777619u;
+    h = (h ^ size) * 16777619u;
+    return h;
+}
+
+const TextCache::Entry* TextCache::find(const char* text, size_t len, uint16_t fg, uint16_t bg,
+                                        uint8_t size) {
+    uint32_t h = hashKey(text, len, fg, bg, size);
+    for (auto& entry : _entries) {
+        if (entry.hash == h && entry.fg == fg && entry.bg == bg && entry.size == size &&
+            entry.text.size() == len && memcmp(entry.text.data(), text, len) == 0) {
+            entry.lastUse = ++_clock;
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+TextCache::Entry* TextCache::insert(const char* text, size_t len, uint16_t fg, uint16_t bg,
+                                    uint8_t size, uint16_t width, uint16_t height) {
+    size_t bytes = static_cast<size_t>(width) * height * sizeof(uint16_t);
+    if (bytes == 0 || bytes > _budget / 2) {
+        return nullptr;
+    }
+
+    while (!_entries.empty() && (_entries.size() >= MAX_ENTRIES || _used + bytes > _budget)) {
+        evictOldest();
+    }
+
+    _entries.emplace_back();
+    Entry& entry = _entries.back();
+    entry.text.assign(text, len);
+    entry.fg = fg;
+    entry.bg = bg;
+    entry.size = size;
+    entry.width = width;
+    entry.height = height;
+    entry.hash = hashKey(text, len, fg, bg, size);
+    entry.lastUse = ++_clock;
+    entry.pixels.resize(static_cast<size_t>(width) * height);
+    _used += bytes;
+    return &entry;
+}
+
+void TextCache::evictOldest() {
+    size_t oldest = 0;
+    for (size_t i = 1; i < _entries.size(); ++i) {
+        if (_entries[i].lastUse < _entries[oldest].lastUse) {
+            oldest = i;
+        }
+    }
+
+    _used -= _entries[oldest].pixels.size() * sizeof(uint16_t);
+    if (oldest != _entries.size() - 1) {
+        _entries[oldest] = std::move(_entries.back());
+    }
+    _entries.pop_back();
+}
+
+void TextCache::clear() {
+    _entries.clear();
+    _used = 0;
+}
+
+} // namespace Core
+} // namespace NightStrike
@@ -1,5 +1,6 @@
 #include "core/input.h"
 #include "core/hardware_detection.h"
+#include "core/logger.h"
 #include <Arduino.h>
 
 namespace NightStrike {
@@ -17,9 +18,9 @@ Error Input::initialize() {
 
     // Initialize hardware buttons based on board
 #ifdef M5STICKC_PLUS2
-    // M5StickC PLUS2: Button A (GPIO 37), Button B (GPIO 39)
-    pinMode(37, INPUT_PULLUP);
-    pinMode(39, INPUT_PULLUP);
+    // M5StickC PLUS2: Button A (GPIO 37), Button B (GPIO 39); edges arrive via interrupts
+    addButton(Button::SELECT, 37);
+    addButton(Button::BACK, 39);
     Serial.println("[Input] M5StickC PLUS2 buttons initialized (A: GPIO37, B: GPIO39)");
 #else
     // Generic ESP32 - use serial input as fallback
@@ -35,6 +36,10 @@ Error Input::shutdown() {
         return Error(ErrorCode::NOT_INITIALIZED);
     }
 
+    for (uint8_t i = 0; i < _buttonCount; ++i) {
+        detachInterrupt(_buttons[i].pin);
+    }
+    _buttonCount = 0;
     _buttonCallback = nullptr;
     _touchCallback = nullptr;
     _initialized = false;
@@ -72,64 +77,134 @@ bool Input::isTouchPressed() const {
     return _touchPoint.pressed;
 }
 
+void Input::addButton(Button button, uint8_t pin) {
+    if (_buttonCount >= MAX_BUTTONS) {
+        return;
+    }
+
+    ButtonState& state = _buttons[_buttonCount];
+    state = ButtonState();
+    state.owner = this;
+    state.index = _buttonCount;
+    state.button = button;
+    state.pin = pin;
+
+    pinMode(pin, INPUT_PULLUP);
+    state.pressed = digitalRead(pin) == LOW;
+    attachInterruptArg(pin, onButtonEdge, &state, CHANGE);
+    _buttonCount++;
+}
+
+void IRAM_ATTR Input::onButtonEdge(void* arg) {
+    ButtonState* state = static_cast<ButtonState*>(arg);
+    state->owner->pushEdge(state->index, digitalRead(state->pin) == LOW, micros());
+}
+
+void IRAM_ATTR Input::pushEdge(uint8_t button, bool pressed, uint32_t micros) {
+    uint8_t head = _edgeHead.load(std::memory_order_relaxed);
+    uint8_t next = (head + 1) & (EDGE_QUEUE_SIZE - 1);
+    if (next == _edgeTail.load(std::memory_order_acquire)) {
+        _droppedEdges.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    _edges[head] = {button, pressed, micros};
+    _edgeHead.store(next, std::memory_order_release);
+}
+
+Input::LatencyStats Input::getLatencyStats() const {
+    LatencyStats stats = _latency;
+    stats.droppedEdges = _droppedEdges.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void Input::resetLatencyStats() {
+    _latency = LatencyStats();
+    _droppedEdges.store(0, std::memory_order_relaxed);
+}
+
+void Input::processEdge(ButtonState& state, bool pressed, uint32_t micros) {
+    // Contact bounce: ignore anything that doesn't change the level or follows too closely
+    if (pressed == state.pressed || micros - state.lastEdgeMicros < DEBOUNCE_MICROS) {
+        return;
+    }
+
+    state.pressed = pressed;
+    state.lastEdgeMicros = micros;
+
+    if (pressed) {
+        state.pressMicros = micros;
+        state.longFired = false;
+        _lastButton = state.button;
+        if (state.lastPressMicros != 0 && micros - state.lastPressMicros < DOUBLE_PRESS_MICROS) {
+            state.lastPressMicros = 0;
+            emit(state.button, EventType::DOUBLE_PRESS, micros);
+        } else {
+            state.lastPressMicros = micros;
+            emit(state.button, EventType::PRESS, micros);
+        }
+    } else {
+        emit(state.button, EventType::RELEASE, micros);
+    }
+}
+
+void Input::emit(Button button, EventType type, uint32_t edgeMicros) {
+    if (_eventObserver) {
+        _eventObserver(button, type, edgeMicros);
+    }
+
+    if (!_buttonCallback) {
+        return;
+    }
+
+    if (type == EventType::PRESS || type == EventType::DOUBLE_PRESS) {
+        uint32_t latency = micros() - edgeMicros;
+        if (_latency.samples == 0 || latency < _latency.minMicros) {
+            _latency.minMicros = latency;
+        }
+        if (latency > _latency.maxMicros) {
+            _latency.maxMicros = latency;
+        }
+        _latency.totalMicros += latency;
+        _latency.samples++;
+        LOG_DEBUG("[Input] Press latency %u us (avg %u, max %u)", latency,
+                  _latency.averageMicros(), _latency.maxMicros);
+    }
+
+    _buttonCallback(button, type);
+}
+
 void Input::update() {
     if (!_initialized) {
         return;
     }
 
 #ifdef M5STICKC_PLUS2
-    // Read M5StickC PLUS2 hardware buttons
-    static unsigned long lastDebounceTime = 0;
-    static Button lastButtonState = Button::NONE;
-    static unsigned long buttonPressStart = 0;
-    const unsigned long debounceDelay = 50;
-    const unsigned long longPressDelay = 800; // 800ms for long press
-    
-    Button currentState = Button::NONE;
-    
-    // Check Button A (SELECT) - GPIO 37
-    if (digitalRead(37) == LOW) {
-        currentState = Button::SELECT;
-    }
-    // Check Button B (BACK) - GPIO 39
-    else if (digitalRead(39) == LOW) {
-        currentState = Button::BACK;
-    }
-    
-    // Debounce
-    if (currentState != lastButtonState) {
-        lastDebounceTime = millis();
-        if (currentState != Button::NONE) {
-            buttonPressStart = millis();
-        }
+    // Drain edges captured by the interrupts, oldest first
+    uint8_t tail = _edgeTail.load(std::memory_order_relaxed);
+    while (tail != _edgeHead.load(std::memory_order_acquire)) {
+        Edge edge = _edges[tail];
+        tail = (tail + 1) & (EDGE_QUEUE_SIZE - 1);
+        _edgeTail.store(tail, std::memory_order_release);
+        processEdge(_buttons[edge.button], edge.pressed, edge.micros);
     }
-    
-    if ((millis() - lastDebounceTime) > debounceDelay) {
-        if (currentState != Button::NONE && currentState != _currentButtonState) {
-            _lastButton = currentState;
-            _currentButtonState = currentState;
-            buttonPressStart = millis();
-            if (_buttonCallback) {
-                _buttonCallback(currentState, EventType::PRESS);
-            }
-        } else if (currentState == Button::NONE && _currentButtonState != Button::NONE) {
-            if (_buttonCallback) {
-                _buttonCallback(_currentButtonState, EventType::RELEASE);
-            }
-            _currentButtonState = Button::NONE;
-            buttonPressStart = 0;
-        } else if (currentState != Button::NONE && _currentButtonState == currentState) {
-            // Check for long press
-            if (buttonPressStart > 0 && (millis() - buttonPressStart) > longPressDelay) {
-                if (_buttonCallback) {
-                    _buttonCallback(currentState, EventType::LONG_PRESS);
-                }
-                buttonPressStart = 0; // Prevent multiple long press events
-            }
+
+    uint32_t now = micros();
+    for (uint8_t i = 0; i < _buttonCount; ++i) {
+        ButtonState& state = _buttons[i];
+
+        // A bounce that ended inside the debounce window leaves no further edge; resync
+        // from the pin once the window has passed
+        bool level = digitalRead(state.pin) == LOW;
+        if (level != state.pressed && now - state.lastEdgeMicros >= DEBOUNCE_MICROS) {
+            processEdge(state, level, now);
+        }
+
+        if (state.pressed && !state.longFired && now - state.pressMicros > LONG_PRESS_MICROS) {
+            state.longFired = true;
+            emit(state.button, EventType::LONG_PRESS, now);
         }
     }
-    
-    lastButtonState = currentState;
 #else
     // Fallback: check serial for keyboard input
     if (Serial.available()) {
@@ -146,14 +221,49 @@ void Input::update() {
             case 'm': case 'M': btn = Button::MENU; break;
         }
 
-        if (btn != Button::NONE && _buttonCallback) {
+        if (btn != Button::NONE) {
+            // Same double-press rule as the hardware buttons (a terminal's "\r\n" is one)
+            uint32_t now = micros();
+            EventType type = EventType::PRESS;
+            if (btn == Button::SELECT) {
+                if (_serialSelectMicros != 0 && now - _serialSelectMicros < DOUBLE_PRESS_MICROS) {
+                    type = EventType::DOUBLE_PRESS;
+                    _serialSelectMicros = 0;
+                } else {
+                    _serialSelectMicros = now;
+                }
+            }
             _lastButton = btn;
-            _buttonCallback(btn, EventType::PRESS);
+            emit(btn, type, now);
         }
     }
 #endif
 }
 
+void Input::injectEvent(Button button, EventType type) {
+    if (button == Button::NONE) {
+        return;
+    }
+
+    if (type != EventType::RELEASE) {
+        _lastButton = button;
+    }
+    emit(button, type, micros());
+}
+
+void Input::discardPendingEvents() {
+    _edgeTail.store(_edgeHead.load(std::memory_order_acquire), std::memory_order_release);
+
+    uint32_t now = micros();
+    for (uint8_t i = 0; i < _buttonCount; ++i) {
+        ButtonState& state = _buttons[i];
+        state.pressed = digitalRead(state.pin) == LOW;
+        state.longFired = state.pressed;  // A press still held doesn't turn into LONG_PRESS
+        state.lastEdgeMicros = now;
+        state.lastPressMicros = 0;
+    }
+}
+
 Error Input::processKeyboardInput(const char* input) {
     if (!input) {
         return Error(ErrorCode::INVALID_PARAMETER);
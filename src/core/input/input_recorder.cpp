@@ -0,0 +1,306 @@
+#include "core/input_recorder.h"
+#include "core/display.h"
+#include "core/storage.h"
+#include <Arduino.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+namespace NightStrike {
+namespace Core {
+
+InputRecorder& InputRecorder::getInstance() {
+    static InputRecorder instance;
+    return instance;
+}
+
+Error InputRecorder::startRecording() {
+    if (_recording || _replaying) {
+        return Error(ErrorCode::ALREADY_INITIALIZED);
+    }
+
+    _events.clear();
+    _recording = true;
+    beginSession();
+    Serial.println("[InputRecorder] Recording started");
+    return Error(ErrorCode::SUCCESS);
+}
+
+Error InputRecorder::stopRecording() {
+    if (!_recording) {
+        return Error(ErrorCode::NOT_INITIALIZED);
+    }
+
+    // The menu activation that stopped the recording must not be replayed
+    for (size_t i = _events.size(); i > 0; --i) {
+        Input::EventType type = _events[i - 1].type;
+        if (type == Input::EventType::DOUBLE_PRESS || type == Input::EventType::LONG_PRESS) {
+            _events.resize(i - 1);
+            break;
+        }
+    }
+
+    _recording = false;
+    endSession();
+    Serial.printf("[InputRecorder] Recorded %u events\n", static_cast<unsigned>(_events.size()));
+    return Error(ErrorCode::SUCCESS);
+}
+
+Error InputRecorder::startReplay(float speed) {
+    if (_recording || _replaying) {
+        return Error(ErrorCode::ALREADY_INITIALIZED);
+    }
+
+    if (speed <= 0.0f) {
+        return Error(ErrorCode::INVALID_PARAMETER);
+    }
+
+    if (_events.empty()) {
+        return Error(ErrorCode::INVALID_PARAMETER, "Empty session");
+    }
+
+    _speed = speed;
+    _nextEvent = 0;
+    _replaying = true;
+    beginSession();
+    Serial.printf("[InputRecorder] Replaying %u events at %.1fx\n",
+                  static_cast<unsigned>(_events.size()), speed);
+    return Error(ErrorCode::SUCCESS);
+}
+
+void InputRecorder::stopReplay() {
+    if (!_replaying) {
+        return;
+    }
+
+    _replaying = false;
+    endSession();
+    printLatencyReport();
+}
+
+void InputRecorder::update() {
+    if (!_recording && !_replaying) {
+        return;
+    }
+
+    uint32_t now = micros();
+    checkFrameTimeout(now);
+
+    if (!_replaying) {
+        return;
+    }
+
+    // Inject every event that is due; an event that blocks (e.g. opens a message)
+    // simply delays the ones after it, like a real user would be delayed
+    uint64_t elapsedMs = static_cast<uint64_t>((now - _startMicros) * _speed) / 1000;
+    while (_replaying && _nextEvent < _events.size() &&
+           _events[_nextEvent].offsetMs <= elapsedMs) {
+        const Event& event = _events[_nextEvent++];
+        Input::getInstance().injectEvent(event.button, event.type);
+    }
+
+    // Give the last event's frame a chance to arrive before reporting
+    if (_replaying && _nextEvent >= _events.size() && !_awaitingFrame) {
+        stopReplay();
+    }
+}
+
+void InputRecorder::beginSession() {
+    _startMicros = micros();
+    _awaitingFrame = false;
+    _samples.clear();
+    _missed = 0;
+
+    Input::getInstance().setEventObserver(
+        [this](Input::Button button, Input::EventType type, uint32_t micros) {
+            onEvent(button, type, micros);
+        });
+    Display::getInstance().setFrameObserver([this](uint32_t) { onFrame(); });
+}
+
+void InputRecorder::endSession() {
+    Input::getInstance().setEventObserver(nullptr);
+    Display::getInstance().setFrameObserver(nullptr);
+    _awaitingFrame = false;
+}
+
+void InputRecorder::onEvent(Input::Button button, Input::EventType type, uint32_t micros) {
+    if (_recording) {
+        _events.push_back({(micros - _startMicros) / 1000, button, type});
+    }
+
+    // RELEASE doesn't change the UI; only probe events that should produce a frame
+    if (type == Input::EventType::RELEASE) {
+        return;
+    }
+
+    checkFrameTimeout(micros);
+    if (_awaitingFrame) {
+        _missed++;  // Superseded before anything was drawn
+    }
+    _awaitingFrame = true;
+    _eventMicros = micros;
+}
+
+void InputRecorder::onFrame() {
+    if (!_awaitingFrame) {
+        return;
+    }
+
+    _awaitingFrame = false;
+    if (_samples.size() < MAX_SAMPLES) {
+        _samples.push_back(micros() - _eventMicros);
+    }
+}
+
+void InputRecorder::checkFrameTimeout(uint32_t now) {
+    if (_awaitingFrame && now - _eventMicros > FRAME_TIMEOUT_MICROS) {
+        _awaitingFrame = false;
+        _missed++;
+    }
+}
+
+InputRecorder::LatencyReport InputRecorder::getLatencyReport() const {
+    LatencyReport report;
+    report.samples = _samples.size();
+    report.missed = _missed;
+    if (_samples.empty()) {
+        return report;
+    }
+
+    std::vector<uint32_t> sorted(_samples);
+    std::sort(sorted.begin(), sorted.end());
+
+    // Nearest-rank percentiles
+    auto percentile = [&sorted](uint32_t p) {
+        size_t rank = (p * sorted.size() + 99) / 100;
+        return sorted[std::max<size_t>(rank, 1) - 1];
+    };
+    report.p50Micros = percentile(50);
+    report.p90Micros = percentile(90);
+    report.p99Micros = percentile(99);
+    report.maxMicros = sorted.back();
+    return report;
+}
+
+void InputRecorder::printLatencyReport() const {
+    LatencyReport report = getLatencyReport();
+    Serial.printf("[InputRecorder] Input-to-frame latency: %u samples, p50 %u us, p90 %u us, "
+                  "p99 %u us, max %u us, %u without frame\n",
+                  report.samples, report.p50Micros, report.p90Micros, report.p99Micros,
+                  report.maxMicros, report.missed);
+}
+
+std::string InputRecorder::toText() const {
+    std::string text = "# NightStrike input session: <offset ms> <button> <event>\n";
+    char line[48];
+    for (const auto& event : _events) {
+        snprintf(line, sizeof(line), "%u %s %s\n", event.offsetMs, buttonName(event.button),
+                 eventName(event.type));
+        text += line;
+    }
+    return text;
+}
+
+Error InputRecorder::fromText(const char* text) {
+    if (!text) {
+        return Error(ErrorCode::INVALID_PARAMETER);
+    }
+
+    if (_recording || _replaying) {
+        return Error(ErrorCode::OPERATION_FAILED, "Session in progress");
+    }
+
+    std::vector<Event> events;
+    const char* line = text;
+    unsigned lineNumber = 0;
+    while (*line) {
+        const char* end = strchr(line, '\n');
+        size_t len = end ? static_cast<size_t>(end - line) : strlen(line);
+        lineNumber++;
+
+        char buffer[64];
+        if (len > 0 && line[0] != '#' && len < sizeof(buffer)) {
+            memcpy(buffer, line, len);
+            buffer[len] = '\0';
+
+            unsigned offset;
+            char button[16];
+            char type[16];
+            Event event;
+            if (sscanf(buffer, "%u %15s %15s", &offset, button, type) != 3 ||
+                !parseButton(button, event.button) || !parseEvent(type, event.type)) {
+                Serial.printf("[InputRecorder] Bad session line %u\n", lineNumber);
+                return Error(ErrorCode::INVALID_PARAMETER, "Malformed session");
+            }
+            event.offsetMs = offset;
+            events.push_back(event);
+        }
+
+        line += len;
+        if (*line == '\n') {
+            line++;
+        }
+    }
+
+    std::stable_sort(events.begin(), events.end(),
+                     [](const Event& a, const Event& b) { return a.offsetMs < b.offsetMs; });
+    _events.swap(events);
+    return Error(ErrorCode::SUCCESS);
+}
+
+Error InputRecorder::saveSession(const std::string& path, bool preferSD) const {
+    std::string text = toText();
+    std::vector<uint8_t> data(text.begin(), text.end());
+    return Storage::getInstance().writeFile(path, data, preferSD);
+}
+
+Error InputRecorder::loadSession(const std::string& path, bool preferSD) {
+    std::vector<uint8_t> data;
+    Error err = Storage::getInstance().readFile(path, data, preferSD);
+    if (err.isError()) {
+        return err;
+    }
+
+    data.push_back('\0');
+    return fromText(reinterpret_cast<const char*>(data.data()));
+}
+
+static const char* const BUTTON_NAMES[] = {
+    "NONE", "UP", "DOWN", "LEFT", "RIGHT", "SELECT", "BACK", "MENU",
+};
+
+static const char* const EVENT_NAMES[] = {
+    "PRESS", "RELEASE", "LONG_PRESS", "DOUBLE_PRESS",
+};
+
+const char* InputRecorder::buttonName(Input::Button button) {
+    return BUTTON_NAMES[static_cast<size_t>(button)];
+}
+
+const char* InputRecorder::eventName(Input::EventType type) {
+    return EVENT_NAMES[static_cast<size_t>(type)];
+}
+
+bool InputRecorder::parseButton(const char* name, Input::Button& button) {
+    for (size_t i = 1; i < sizeof(BUTTON_NAMES) / sizeof(BUTTON_NAMES[0]); ++i) {
+        if (strcmp(name, BUTTON_NAMES[i]) == 0) {
+            button = static_cast<Input::Button>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool InputRecorder::parseEvent(const char* name, Input::EventType& type) {
+    for (size_t i = 0; i < sizeof(EVENT_NAMES) / sizeof(EVENT_NAMES[0]); ++i) {
+        if (strcmp(name, EVENT_NAMES[i]) == 0) {
+            type = static_cast<Input::EventType>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace Core
+} // namespace NightStrike
@@ -1,6 +1,7 @@
 #include "core/menu.h"
 #include "core/display.h"
 #include "core/input.h"
+#include "core/notifications.h"
 #include "core/power_management.h"
 #include <Arduino.h>
 #include <algorithm>
@@ -22,8 +23,7 @@ Error Menu::initialize() {
     // For M5StickC PLUS2: Button A (SELECT) = navigate/select, Button B (BACK) = back
     // Navigation: Short press A = next item, Double press A = select, Button B = back
     auto& input = Input::getInstance();
-    static unsigned long lastSelectPress = 0;
-    
+
     input.registerButtonCallback([this](Input::Button btn, Input::EventType type) {
         if (!_visible) return;
         
@@ -36,21 +36,11 @@ Error Menu::initialize() {
                 break;
             case Input::Button::SELECT:
                 if (type == Input::EventType::PRESS) {
-                    unsigned long now = millis();
-                    // Double-click detection (within 400ms) = select
-                    if (lastSelectPress > 0 && (now - lastSelectPress) < 400) {
-                        // Double-click = select item
-                        if (_selectedIndex < _items.size() && _items[_selectedIndex].enabled) {
-                            _items[_selectedIndex].action();
-                        }
-                        lastSelectPress = 0; // Reset
-                    } else {
-                        // Single click = next item
-                        selectNext();
-                        lastSelectPress = now;
-                    }
-                } else if (type == Input::EventType::LONG_PRESS) {
-                    // Long press = select item
+                    // Single click = next item
+                    selectNext();
+                } else if (type == Input::EventType::DOUBLE_PRESS ||
+                           type == Input::EventType::LONG_PRESS) {
+                    // Double click or long press = select item
                     if (_selectedIndex < _items.size() && _items[_selectedIndex].enabled) {
                         _items[_selectedIndex].action();
                     }
@@ -118,10 +108,18 @@ Error Menu::show() {
 Error Menu::hide() {
     _visible = false;
     auto& display = Display::getInstance();
+    display.beginFrame();
     display.clear();
+    display.endFrame();
     return Error(ErrorCode::SUCCESS);
 }
 
+void Menu::refresh() {
+    if (_visible && _initialized) {
+        render();
+    }
+}
+
 void Menu::update() {
     if (!_visible || !_initialized) {
         return;
@@ -166,6 +164,7 @@ void Menu::render() {
     }
 
     auto& display = Display::getInstance();
+    display.beginFrame();
     display.clear();
 
     // Draw battery indicator in top-right corner
@@ -205,6 +204,9 @@ void Menu::render() {
             y += 15;
         }
     }
+
+    Notifications::getInstance().render(display);
+    display.endFrame();
 }
 
 void Menu::handleInput() {
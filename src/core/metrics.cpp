@@ -0,0 +1,233 @@
+#include "core/metrics.h"
+#include <cstdio>
+#include <cstring>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+namespace NightStrike {
+namespace Core {
+
+Metrics::Histogram::Histogram(const char* name, const char* help, const uint32_t* bounds,
+                              size_t count)
+    : Metric(name, help, Type::HISTOGRAM), _count(count < MAX_BUCKETS ? count : MAX_BUCKETS) {
+    for (size_t i = 0; i < _count; ++i) {
+        _bounds[i] = bounds[i];
+    }
+    for (size_t i = 0; i <= MAX_BUCKETS; ++i) {
+        _buckets[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+void Metrics::Histogram::observe(uint32_t value) {
+    size_t i = 0;
+    while (i < _count && value > _bounds[i]) {
+        i++;
+    }
+    _buckets[i].fetch_add(1, std::memory_order_relaxed);
+    _observations.fetch_add(1, std::memory_order_relaxed);
+    _sum.fetch_add(value, std::memory_order_relaxed);
+}
+
+Metrics& Metrics::getInstance() {
+    static Metrics instance;
+    return instance;
+}
+
+Metrics::Metrics() {
+    registerSystemMetrics();
+}
+
+void Metrics::registerSystemMetrics() {
+    gauge("nightstrike_heap_free_bytes", "Free internal heap",
+          []() { return static_cast<int32_t>(ESP.getFreeHeap()); });
+    gauge("nightstrike_heap_min_free_bytes", "Lowest free heap since boot",
+          []() { return static_cast<int32_t>(ESP.getMinFreeHeap()); });
+    gauge("nightstrike_heap_max_alloc_bytes", "Largest allocatable heap block",
+          []() { return static_cast<int32_t>(ESP.getMaxAllocHeap()); });
+    gauge("nightstrike_psram_free_bytes", "Free PSRAM",
+          []() { return static_cast<int32_t>(ESP.getFreePsram()); });
+    gauge("nightstrike_tasks", "FreeRTOS tasks",
+          []() { return static_cast<int32_t>(uxTaskGetNumberOfTasks()); });
+    gauge("nightstrike_uptime_seconds", "Time since boot",
+          []() { return static_cast<int32_t>(millis() / 1000); });
+}
+
+// Length of the family part of "family{labels}"
+static size_t familyLength(const char* name) {
+    const char* brace = strchr(name, '{');
+    return brace ? static_cast<size_t>(brace - name) : strlen(name);
+}
+
+// One family has one type: a second TYPE line would make the exposition invalid
+Metrics::Metric* Metrics::find(const char* name, Type type, bool& conflict) {
+    conflict = false;
+    size_t family = familyLength(name);
+    for (Metric* metric : _metrics) {
+        if (familyLength(metric->name()) != family ||
+            strncmp(metric->name(), name, family) != 0) {
+            continue;
+        }
+        if (metric->type() != type) {
+            conflict = true;
+            Serial.printf("[Metrics] %s is already registered with another type\n", name);
+            return nullptr;
+        }
+        if (strcmp(metric->name(), name) == 0) {
+            return metric;
+        }
+    }
+    return nullptr;
+}
+
+Metrics::Counter& Metrics::counter(const char* name, const char* help) {
+    std::lock_guard<std::mutex> guard(_lock);
+    bool conflict;
+    Metric* existing = find(name, Type::COUNTER, conflict);
+    if (existing) {
+        return *static_cast<Counter*>(existing);
+    }
+
+    Counter* metric = new Counter(name, help);
+    if (!conflict) {
+        _metrics.push_back(metric);
+    }
+    return *metric;
+}
+
+Metrics::Gauge& Metrics::gauge(const char* name, const char* help, Gauge::Sampler sampler) {
+    std::lock_guard<std::mutex> guard(_lock);
+    bool conflict;
+    Metric* existing = find(name, Type::GAUGE, conflict);
+    if (existing) {
+        return *static_cast<Gauge*>(existing);
+    }
+
+    Gauge* metric = new Gauge(name, help, sampler);
+    if (!conflict) {
+        _metrics.push_back(metric);
+    }
+    return *metric;
+}
+
+Metrics::Histogram& Metrics::histogram(const char* name, const char* help,
+                                       const uint32_t* bounds, size_t count) {
+    std::lock_guard<std::mutex> guard(_lock);
+    bool conflict;
+    Metric* existing = find(name, Type::HISTOGRAM, conflict);
+    if (existing) {
+        return *static_cast<Histogram*>(existing);
+    }
+
+    Histogram* metric = new Histogram(name, help, bounds, count);
+    if (!conflict) {
+        _metrics.push_back(metric);
+    }
+    return *metric;
+}
+
+static const char* typeName(Metrics::Type type) {
+    switch (type) {
+        case Metrics::Type::COUNTER: return "counter";
+        case Metrics::Type::GAUGE: return "gauge";
+        default: return "histogram";
+    }
+}
+
+// Text exposition escaping for help text and label values: backslash and newline.
+// Label names can't contain either, so a whole "{...}" block can go through here.
+static void escape(const char* text, size_t length, char* out, size_t size) {
+    size_t used = 0;
+    for (size_t i = 0; i < length && used + 2 < size; ++i) {
+        if (text[i] == '\\' || text[i] == '\n') {
+            out[used++] = '\\';
+            out[used++] = text[i] == '\n' ? 'n' : '\\';
+        } else {
+            out[used++] = text[i];
+        }
+    }
+    out[used] = '\0';
+}
+
+// snprintf result, clamped to what actually fit
+static void emit(Print& out, const char* line, int len, size_t size) {
+    if (len <= 0) {
+        return;
+    }
+    size_t length = static_cast<size_t>(len) < size ? len : size - 1;
+    out.write(reinterpret_cast<const uint8_t*>(line), length);
+}
+
+void Metrics::write(Print& out) {
+    std::lock_guard<std::mutex> guard(_lock);
+    char line[192];
+    char help[96];
+    char labels[96];  // Escaped, without the braces
+    const char* lastFamily = nullptr;
+    size_t lastLength = 0;
+
+    for (Metric* metric : _metrics) {
+        // "family{labels}": HELP/TYPE once per family
+        const char* name = metric->name();
+        const char* brace = strchr(name, '{');
+        int family = brace ? static_cast<int>(brace - name) : static_cast<int>(strlen(name));
+        if (!lastFamily || lastLength != static_cast<size_t>(family) ||
+            strncmp(lastFamily, name, family) != 0) {
+            escape(metric->help(), strlen(metric->help()), help, sizeof(help));
+            int len = snprintf(line, sizeof(line), "# HELP %.*s %s\n# TYPE %.*s %s\n", family,
+                               name, help, family, name, typeName(metric->type()));
+            emit(out, line, len, sizeof(line));
+            lastFamily = name;
+            lastLength = family;
+        }
+
+        // Inside the braces; an unterminated block is taken to the end of the name
+        labels[0] = '\0';
+        if (brace) {
+            size_t length = strlen(brace + 1);
+            if (length > 0 && brace[length] == '}') {
+                length--;
+            }
+            escape(brace + 1, length, labels, sizeof(labels));
+        }
+        const char* open = brace ? "{" : "";
+        const char* close = brace ? "}" : "";
+
+        int len = 0;
+        if (metric->type() == Type::COUNTER) {
+            len = snprintf(line, sizeof(line), "%.*s%s%s%s %llu\n", family, name, open, labels,
+                           close,
+                           static_cast<unsigned long long>(static_cast<Counter*>(metric)->value()));
+        } else if (metric->type() == Type::GAUGE) {
+            len = snprintf(line, sizeof(line), "%.*s%s%s%s %d\n", family, name, open, labels,
+                           close, static_cast<int>(static_cast<Gauge*>(metric)->value()));
+        }
+        if (len > 0) {
+            emit(out, line, len, sizeof(line));
+            continue;
+        }
+
+        // Histogram: cumulative buckets, then sum and count, keeping any fixed labels
+        auto* histogram = static_cast<Histogram*>(metric);
+        const char* separator = labels[0] ? "," : "";
+        uint32_t cumulative = 0;
+        for (size_t i = 0; i <= histogram->bucketCount(); ++i) {
+            cumulative += histogram->bucket(i);
+            char bound[12];
+            if (i < histogram->bucketCount()) {
+                snprintf(bound, sizeof(bound), "%u", histogram->bound(i));
+            } else {
+                strcpy(bound, "+Inf");
+            }
+            len = snprintf(line, sizeof(line), "%.*s_bucket{%s%sle=\"%s\"} %u\n", family, name,
+                           labels, separator, bound, cumulative);
+            emit(out, line, len, sizeof(line));
+        }
+        len = snprintf(line, sizeof(line), "%.*s_sum%s%s%s %u\n%.*s_count%s%s%s %u\n", family,
+                       name, open, labels, close, histogram->sum(), family, name, open, labels,
+                       close, histogram->observations());
+        emit(out, line, len, sizeof(line));
+    }
+}
+
+} // namespace Core
+} // namespace NightStrike
@@ -0,0 +1,170 @@
+#include "core/notifications.h"
+#include "core/logger.h"
+#include "core/menu.h"
+#include <Arduino.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+namespace NightStrike {
+namespace Core {
+
+static const uint16_t TOAST_BACKGROUND = 0x2104;  // Dark grey
+static const uint8_t LINE_HEIGHT = 10;
+static const uint8_t PADDING = 4;
+
+Notifications& Notifications::getInstance() {
+    static Notifications instance;
+    return instance;
+}
+
+void Notifications::post(const char* message, uint32_t durationMs, Level level) {
+    if (!message || !*message) {
+        return;
+    }
+
+    LOG_DEBUG("[Notify] %s", message);
+
+    // Coalesce: the same text again just extends the existing toast
+    for (size_t i = 0; i < _queue.size(); ++i) {
+        Toast& toast = _queue[i];
+        if (toast.message == message) {
+            toast.repeats++;
+            toast.level = std::max(toast.level, level);
+            toast.durationMs = std::max(toast.durationMs, durationMs);
+            if (i == 0) {
+                showFront();  // Restart its timer
+                repaint();
+            }
+            return;
+        }
+    }
+
+    // Full queue: drop the oldest waiting toast, never the one on screen
+    if (_queue.size() >= MAX_QUEUED) {
+        _queue.erase(_queue.begin() + 1);
+    }
+
+    _queue.push_back({message, level, durationMs, 0, 0});
+    if (_queue.size() == 1) {
+        showFront();
+        repaint();
+    }
+}
+
+void Notifications::dismiss() {
+    if (_queue.empty()) {
+        return;
+    }
+
+    _queue.erase(_queue.begin());
+    if (!_queue.empty()) {
+        showFront();
+    }
+    repaint();
+}
+
+void Notifications::clear() {
+    if (_queue.empty()) {
+        return;
+    }
+
+    _queue.clear();
+    repaint();
+}
+
+void Notifications::update() {
+    if (_queue.empty()) {
+        return;
+    }
+
+    const Toast& front = _queue.front();
+    if (millis() - front.shownAt >= front.durationMs) {
+        dismiss();
+    }
+}
+
+void Notifications::showFront() {
+    _queue.front().shownAt = millis();
+}
+
+void Notifications::repaint() {
+    // The menu redraws its own content and overlays us; other screens only get
+    // the toast area refreshed
+    auto& menu = Menu::getInstance();
+    if (menu.isVisible()) {
+        menu.refresh();
+        return;
+    }
+
+    auto& display = Display::getInstance();
+    if (!display.isInitialized()) {
+        return;
+    }
+
+    display.beginFrame();
+    if (_boxSize.width > 0) {
+        display.drawRect(_boxPos, _boxSize, Display::Color::Black(), true);
+        _boxSize = Display::Size();
+    }
+    render(display);
+    display.endFrame();
+}
+
+void Notifications::render(Display& display) {
+    if (_queue.empty() || !display.isInitialized()) {
+        return;
+    }
+
+    const Toast& toast = _queue.front();
+    Display::Size screen = display.getSize();
+    size_t maxChars = (screen.width - 8 - 2 * PADDING) / GlyphAtlas::GLYPH_WIDTH;
+
+    // Split into lines, truncating each to the box width
+    std::string lines[MAX_LINES];
+    uint8_t lineCount = 0;
+    size_t start = 0;
+    while (lineCount < MAX_LINES && start <= toast.message.size()) {
+        size_t end = toast.message.find('\n', start);
+        if (end == std::string::npos) {
+            end = toast.message.size();
+        }
+        lines[lineCount++] = toast.message.substr(start, std::min(end - start, maxChars));
+        start = end + 1;
+    }
+
+    if (toast.repeats > 0) {
+        char suffix[12];
+        snprintf(suffix, sizeof(suffix), " (x%u)", toast.repeats + 1);
+        std::string& last = lines[lineCount - 1];
+        last = last.substr(0, maxChars - std::min(maxChars, strlen(suffix))) + suffix;
+    }
+
+    Display::Color accent = Display::Color::Green();
+    if (toast.level == Level::WARNING) {
+        accent = Display::Color(0xFFE0);  // Yellow
+    } else if (toast.level == Level::ERROR) {
+        accent = Display::Color::Red();
+    }
+
+    _boxSize = Display::Size(screen.width - 8, lineCount * LINE_HEIGHT + 2 * PADDING - 2);
+    _boxPos = Display::Point(4, screen.height - _boxSize.height - 4);
+    display.drawRect(_boxPos, _boxSize, Display::Color(TOAST_BACKGROUND), true);
+    display.drawRect(_boxPos, _boxSize, accent);
+
+    // Keep the caller's text style
+    Display::Color savedFg = display.getTextColor();
+    Display::Color savedBg = display.getTextBackground();
+    uint8_t savedSize = display.getTextSize();
+    display.setTextColor(Display::Color::White(), Display::Color(TOAST_BACKGROUND));
+    display.setTextSize(1);
+    for (uint8_t i = 0; i < lineCount; ++i) {
+        display.drawText(Display::Point(_boxPos.x + PADDING, _boxPos.y + PADDING + i * LINE_HEIGHT),
+                         lines[i].c_str());
+    }
+    display.setTextColor(savedFg, savedBg);
+    display.setTextSize(savedSize);
+}
+
+} // namespace Core
+} // namespace NightStrike
@@ -1,4 +1,5 @@
 #include "core/storage.h"
+#include "core/metrics.h"
 #include <LittleFS.h>
 #include <SD.h>
 #include <SPI.h>
@@ -86,6 +87,21 @@ bool Storage::setupSDCard() {
     return true;
 }
 
+void Storage::recordWrite(size_t bytes, bool preferSD) {
+    static const char* HELP = "Bytes written to storage";
+    static Metrics::Counter& littlefsBytes = Metrics::getInstance().counter(
+        "nightstrike_storage_bytes_written_total{storage=\"littlefs\"}", HELP);
+    static Metrics::Counter& sdBytes = Metrics::getInstance().counter(
+        "nightstrike_storage_bytes_written_total{storage=\"sd\"}", HELP);
+
+    // Same fallback as getStorage(): SD only when it is actually mounted
+    if (preferSD && _sdcardMounted) {
+        sdBytes.inc(bytes);
+    } else {
+        littlefsBytes.inc(bytes);
+    }
+}
+
 fs::FS* Storage::getStorage(bool preferSD) {
     if (preferSD && _sdcardMounted) {
         return &SD;
@@ -133,6 +149,7 @@ Error Storage::writeFile(const std::string& path, const std::vector<uint8_t>& da
 
     size_t written = file.write(data.data(), data.size());
     file.close();
+    recordWrite(written, preferSD);
 
     if (written != data.size()) {
         return Error(ErrorCode::FILE_WRITE_ERROR);
@@ -158,6 +175,28 @@ Error Storage::deleteFile(const std::string& path, bool preferSD) {
     return Error(ErrorCode::SUCCESS);
 }
 
+Error Storage::renameFile(const std::string& from, const std::string& to, bool preferSD) {
+    fs::FS* fs = getStorage(preferSD);
+    if (!fs) {
+        return Error(ErrorCode::STORAGE_NOT_MOUNTED);
+    }
+
+    if (!fs->exists(from.c_str())) {
+        return Error(ErrorCode::FILE_NOT_FOUND);
+    }
+
+    // FS::rename doesn't replace an existing target on every filesystem
+    if (fs->exists(to.c_str()) && !fs->remove(to.c_str())) {
+        return Error(ErrorCode::FILE_DELETE_ERROR);
+    }
+
+    if (!fs->rename(from.c_str(), to.c_str())) {
+        return Error(ErrorCode::FILE_WRITE_ERROR);
+    }
+
+    return Error(ErrorCode::SUCCESS);
+}
+
 Error Storage::listFiles(const std::string& path, std::vector<std::string>& files, bool preferSD) {
     fs::FS* fs = getStorage(preferSD);
     if (!fs) {
@@ -180,6 +219,31 @@ Error Storage::listFiles(const std::string& path, std::vector<std::string>& file
     return Error(ErrorCode::SUCCESS);
 }
 
+Error Storage::openFile(const std::string& path, fs::File& file, const char* mode,
+                        bool preferSD) {
+    fs::FS* fs = getStorage(preferSD);
+    if (!fs) {
+        return Error(ErrorCode::STORAGE_NOT_MOUNTED);
+    }
+
+    bool reading = mode[0] == 'r';
+    if (reading && !fs->exists(path.c_str())) {
+        return Error(ErrorCode::FILE_NOT_FOUND);
+    }
+
+    file = fs->open(path.c_str(), mode);
+    if (!file) {
+        return Error(reading ? ErrorCode::FILE_READ_ERROR : ErrorCode::FILE_WRITE_ERROR);
+    }
+
+    if (file.isDirectory()) {
+        file.close();
+        return Error(ErrorCode::INVALID_PARAMETER, "Is a directory");
+    }
+
+    return Error(ErrorCode::SUCCESS);
+}
+
 bool Storage::fileExists(const std::string& path, bool preferSD) {
     fs::FS* fs = getStorage(preferSD);
     if (!fs) {
@@ -199,9 +263,7 @@ uint64_t Storage::getFreeSpace(bool preferSD) {
         return (SD.totalBytes() - SD.usedBytes());
     }
 
-    // LittleFS doesn't have a direct free space API
-    // Would need to calculate manually
-    return 0;
+    return LittleFS.totalBytes() - LittleFS.usedBytes();
 }
 
 } // namespace Core
@@ -1,11 +1,24 @@
 #include "core/web_ui.h"
 #include "core/system.h"
 #include "core/storage.h"
+#include "core/logger.h"
+#include "core/metrics.h"
+#include "utils/json_writer.h"
+#include "generated/web_assets.h"
 #include <ESPAsyncWebServer.h>
 #include <WiFi.h>
-#include <LittleFS.h>
-#include <SD.h>
 #include <ArduinoJson.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/queue.h>
+#include <freertos/semphr.h>
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
 
 namespace NightStrike {
 namespace Core {
@@ -13,6 +26,196 @@ namespace Core {
 WebUI* g_webUIInstance = nullptr;
 AsyncWebServer* g_webServer = nullptr;
 
+// Push channel: latest payload per event name, drained by the push task
+struct PushTopic {
+    std::string event;
+    std::string data;
+    bool dirty;
+};
+
+static std::vector<PushTopic> s_topics;
+static std::vector<PushTopic> s_outbox;  // Copies sent outside the lock; reused between rounds
+static std::mutex s_topicLock;
+static TaskHandle_t s_pushTask = nullptr;
+static std::atomic<bool> s_pushRunning(false);
+static std::atomic<bool> s_resync(false);  // A client connected: resend everything in full
+static std::atomic<uint32_t> s_eventId(0);
+
+// One /api/events connection. The push task only appends formatted events to
+// pending; the response's filler drains it on the async_tcp task. The library's
+// client list is never touched from the push task, so nothing it changes on
+// connect or disconnect can race a send. The response owns the client: once the
+// connection is gone the weak reference expires and the next round prunes it.
+struct EventClient {
+    std::string pending;
+};
+static std::vector<std::weak_ptr<EventClient>> s_eventClients;
+static std::mutex s_eventLock;  // s_eventClients and every client's pending
+
+// Status as last pushed, for deltas
+static uint32_t s_lastFreeHeap = 0;
+static uint32_t s_lastTotalHeap = 0;
+static uint32_t s_lastAssetBytes = 0;
+
+// Uploads: the async TCP task fills one buffer while the writer task stores the other.
+// Data goes to "<path>.part", renamed over <path> only once complete. The async TCP
+// task never waits on the writer: it holds back acks instead, and fails the upload
+// if the writer still falls behind.
+struct UploadContext {
+    std::string path;
+    bool sdCard = false;
+    File file;
+    uint8_t* buffers[2] = {nullptr, nullptr};
+    uint8_t active = 0;
+    size_t fill = 0;                             // Bytes in buffers[active]
+    SemaphoreHandle_t freeBuffers = nullptr;     // Counting: buffers not held by the writer
+    SemaphoreHandle_t done = nullptr;            // Given once the writer has finished the file
+    std::atomic<int> refs{1};                    // TCP side + writer while the final job is queued
+    bool locked = false;                         // Holds the path in s_uploadPaths
+    bool finalQueued = false;
+    size_t heldAcks = 0;                         // Left unacknowledged (async TCP task)
+    size_t written = 0;
+    uint32_t startMicros = 0;
+    uint32_t kibps = 0;
+    volatile int status = 0;                     // HTTP status of the reply; 0 while running
+    const char* error = nullptr;
+};
+
+struct UploadJob {
+    UploadContext* upload;
+    uint8_t buffer;
+    size_t length;
+    bool final;
+    bool abort;  // Client went away: drop the partial file
+};
+
+static QueueHandle_t s_uploadJobs = nullptr;
+static TaskHandle_t s_uploadTask = nullptr;
+static std::map<AsyncWebServerRequest*, UploadContext*> s_uploads;  // Async TCP task only
+static std::vector<std::string> s_uploadPaths;                       // "<storage>:<path>" in flight
+static std::mutex s_uploadLock;
+
+// How the last few uploads ended, for clients that got 202 while the writer finished
+struct UploadResult {
+    std::string key;
+    int status;
+    const char* error;
+    size_t bytes;
+    uint32_t kibps;
+};
+static std::vector<UploadResult> s_uploadResults;  // Oldest first, under s_uploadLock
+
+// Heap held by a response that is fully built but not yet sent, reported in a
+// header and the debug log. A delta, not a peak: memory the handler freed again
+// is not seen, and the heap's low-water mark is global since boot, so it can't
+// be attributed to one request.
+static void sendWithHeapReport(AsyncWebServerRequest* request, AsyncWebServerResponse* response,
+                               uint32_t heapBefore) {
+    uint32_t heapAfter = ESP.getFreeHeap();
+    uint32_t delta = heapBefore > heapAfter ? heapBefore - heapAfter : 0;
+    response->addHeader("X-Heap-Delta", String(delta));
+    LOG_DEBUG("[WebUI] %s: heap delta %u bytes", request->url().c_str(), delta);
+    request->send(response);
+}
+
+static void sendFileList(const WebUI::Request& request, WebUI::Response& response,
+                         bool preferSD) {
+    std::string path = request.hasParam("path") ? request.param("path").str() : "/";
+
+    std::vector<std::string> files;
+    Error err = Storage::getInstance().listFiles(path, files, preferSD);
+    if (err.isError()) {
+        response.setStatus(500);
+        response.send("{\"error\":\"Failed to list files\"}");
+        return;
+    }
+
+    Utils::JsonWriter& json = response.json();
+    json.beginObject().field("path", path).key("files").beginArray();
+    for (const auto& file : files) {
+        json.value(file);
+    }
+    json.endArray().endObject();
+}
+
+static void sendStorageInfo(WebUI::Response& response, bool sdCard) {
+    auto& storage = Storage::getInstance();
+    bool mounted = sdCard ? storage.isSDCardMounted() : storage.isLittleFSMounted();
+    Utils::JsonWriter& json = response.json();
+    json.beginObject().field("mounted", mounted);
+    if (mounted) {
+        json.field("freeSpace", storage.getFreeSpace(sdCard));
+    }
+    json.endObject();
+}
+
+enum class RangeResult {
+    NONE,           // No (usable) Range header: send everything
+    SATISFIABLE,
+    UNSATISFIABLE
+};
+
+// Single byte range: "bytes=a-b", "bytes=a-" or "bytes=-n"; [start, end] inclusive
+static RangeResult parseRange(const char* header, size_t size, size_t& start, size_t& end) {
+    if (strncmp(header, "bytes=", 6) != 0 || strchr(header, ',')) {
+        return RangeResult::NONE;  // Other units and multipart ranges are ignored, as allowed
+    }
+
+    const char* spec = header + 6;
+    char* rest;
+    if (*spec == '-') {
+        unsigned long long suffix = strtoull(spec + 1, &rest, 10);
+        if (rest == spec + 1 || *rest) {
+            return RangeResult::NONE;
+        }
+        if (suffix == 0 || size == 0) {
+            return RangeResult::UNSATISFIABLE;
+        }
+        start = suffix >= size ? 0 : size - suffix;
+        end = size - 1;
+        return RangeResult::SATISFIABLE;
+    }
+
+    unsigned long long first = strtoull(spec, &rest, 10);
+    if (rest == spec || *rest != '-') {
+        return RangeResult::NONE;
+    }
+    const char* last = rest + 1;
+    unsigned long long lastByte = size - 1;
+    if (*last) {
+        lastByte = strtoull(last, &rest, 10);
+        if (rest == last || *rest || lastByte < first) {
+            return RangeResult::NONE;
+        }
+    }
+
+    if (first >= size) {
+        return RangeResult::UNSATISFIABLE;
+    }
+    start = first;
+    end = std::min<unsigned long long>(lastByte, size - 1);
+    return RangeResult::SATISFIABLE;
+}
+
+static const char* downloadContentType(const String& path) {
+    if (path.endsWith(".txt") || path.endsWith(".log")) {
+        return "text/plain";
+    }
+    if (path.endsWith(".json")) {
+        return "application/json";
+    }
+    if (path.endsWith(".html")) {
+        return "text/html";
+    }
+    if (path.endsWith(".csv")) {
+        return "text/csv";
+    }
+    if (path.endsWith(".pcap")) {
+        return "application/vnd.tcpdump.pcap";
+    }
+    return "application/octet-stream";
+}
+
 WebUI& WebUI::getInstance() {
     if (!g_webUIInstance) {
         g_webUIInstance = new WebUI();
@@ -31,254 +234,722 @@ Error WebUI::initialize(uint16_t port) {
         g_webServer = new AsyncWebServer(port);
     }
 
-    // Default routes
-    g_webServer->on("/", HTTP_GET, [](AsyncWebServerRequest* request) {
-        request->send(200, "text/html", R"html(
-<!DOCTYPE html>
-<html>
-<head>
-    <title>NightStrike Control Panel</title>
-    <meta name="viewport" content="width=device-width, initial-scale=1">
-    <style>
-        body { font-family: Arial; background: #000; color: #0f0; padding: 20px; }
-        .container { max-width: 800px; margin: 0 auto; }
-        h1 { color: #0f0; text-shadow: 0 0 10px #0f0; }
-        .module { background: #111; border: 1px solid #0f0; padding: 15px; margin: 10px 0; }
-        button { background: #0f0; color: #000; border: none; padding: 10px 20px; cursor: pointer; }
-        button:hover { background: #0a0; }
-        .status { color: #0f0; }
-    </style>
-</head>
-<body>
-    <div class="container">
-        <h1>🌑 NightStrike Control Panel</h1>
-        <div class="module">
-            <h2>System Status</h2>
-            <p class="status" id="status">Loading...</p>
-        </div>
-        <div class="module">
-            <h2>WiFi Module</h2>
-            <button onclick="scanWiFi()">Scan Networks</button>
-            <button onclick="startAP()">Start AP</button>
-            <div id="wifiResults"></div>
-        </div>
-        <div class="module">
-            <h2>BLE Module</h2>
-            <button onclick="scanBLE()">Scan BLE</button>
-            <button onclick="spamBLE()">Start BLE Spam</button>
-        </div>
-    </div>
-    <script>
-        function updateStatus() {
-            fetch('/api/status').then(r => r.json()).then(data => {
-                document.getElementById('status').innerHTML =
-                    'Free Heap: ' + data.freeHeap + ' bytes<br>' +
-                    'Uptime: ' + data.uptime + ' ms';
-            });
+    registerAssets();
+    registerEvents();
+
+    if (!_coreRoutesAdded) {
+        registerCoreRoutes();
+        _coreRoutesAdded = true;
+    }
+    for (size_t i = 0; i < _routes.size(); ++i) {
+        registerRoute(i);
+    }
+
+    // File upload endpoint: chunks go through a double buffer to the upload writer task
+    g_webServer->on("/api/storage/upload", HTTP_POST,
+        [this](AsyncWebServerRequest* request) {
+            finishUpload(request);
+        },
+        [this](AsyncWebServerRequest* request, const String&, size_t index, uint8_t* data,
+               size_t len, bool final) {
+            receiveUpload(request, index, data, len, final);
+        });
+
+    // File download endpoint (Range-capable, so interrupted transfers can resume)
+    g_webServer->on("/api/storage/download", HTTP_GET, [this](AsyncWebServerRequest* request) {
+        sendDownload(request);
+    });
+
+    g_webServer->begin();
+    _active = true;
+    _initialized = true;
+
+    // Created once; it idles on its queue across shutdown()/initialize()
+    if (!s_uploadTask) {
+        // A slot for each buffer of each upload, so queueing never waits
+        s_uploadJobs = xQueueCreate(2 * MAX_UPLOADS, sizeof(UploadJob));
+        if (s_uploadJobs &&
+            xTaskCreate(uploadTask, "WebUpload", 4096, this, 2, &s_uploadTask) != pdPASS) {
+            vQueueDelete(s_uploadJobs);
+            s_uploadJobs = nullptr;
+            s_uploadTask = nullptr;
         }
-        function scanWiFi() {
-            fetch('/api/wifi/scan').then(r => r.json()).then(data => {
-                document.getElementById('wifiResults').innerHTML =
-                    'Found ' + data.count + ' networks';
-            });
+        if (!s_uploadJobs) {
+            Serial.println("[WebUI] Upload writer failed to start; uploads are refused");
+        }
+    }
+
+    s_pushRunning = true;
+    if (xTaskCreate(pushTask, "WebPush", 4096, this, 1, &s_pushTask) != pdPASS) {
+        s_pushRunning = false;
+        s_pushTask = nullptr;
+        Serial.println("[WebUI] Push task failed to start; /api/events stays idle");
+    }
+
+    Serial.printf("[WebUI] Started on port %d\n", port);
+    return Error(ErrorCode::SUCCESS);
+}
+
+void WebUI::registerAssets() {
+    for (size_t i = 0; i < WEB_ASSET_COUNT; ++i) {
+        const WebAsset* asset = &WEB_ASSETS[i];
+        g_webServer->on(asset->url, HTTP_GET, [this, asset](AsyncWebServerRequest* request) {
+            _assetStats.requests++;
+
+            // The browser revalidates on every load (no-cache); unchanged assets cost a 304
+            if (request->hasHeader("If-None-Match") &&
+                request->getHeader("If-None-Match")->value().indexOf(asset->etag) >= 0) {
+                AsyncWebServerResponse* response = request->beginResponse(304);
+                response->addHeader("ETag", asset->etag);
+                request->send(response);
+                _assetStats.notModified++;
+                return;
+            }
+
+            AsyncWebServerResponse* response =
+                request->beginResponse_P(200, asset->contentType, asset->data, asset->size);
+            response->addHeader("Content-Encoding", "gzip");
+            response->addHeader("ETag", asset->etag);
+            response->addHeader("Cache-Control", "no-cache");
+            request->send(response);
+
+            _assetStats.bytesSent += asset->size;
+            _assetStats.bytesUncompressed += asset->uncompressedSize;
+            LOG_DEBUG("[WebUI] %s: %u bytes (%u uncompressed)", asset->url,
+                      static_cast<unsigned>(asset->size),
+                      static_cast<unsigned>(asset->uncompressedSize));
+        });
+    }
+}
+
+void WebUI::sendDownload(AsyncWebServerRequest* request) {
+    if (!request->hasParam("path") || !request->hasParam("storage")) {
+        request->send(400, "application/json", "{\"error\":\"Missing parameters\"}");
+        return;
+    }
+
+    String path = request->getParam("path")->value();
+    bool sdCard = request->getParam("storage")->value() == "sdcard";
+
+    // Owned by the response's filler; the file closes when the response is freed
+    struct Download {
+        File file;
+        size_t remaining;
+        size_t length;
+        uint32_t startMicros;
+    };
+    std::shared_ptr<Download> download(new Download());
+
+    Error err = Storage::getInstance().openFile(path.c_str(), download->file, "r", sdCard);
+    if (err.isError()) {
+        AsyncResponseStream* response = request->beginResponseStream("application/json");
+        int code = 500;
+        if (err.code == ErrorCode::FILE_NOT_FOUND) {
+            code = 404;
+        } else if (err.code == ErrorCode::INVALID_PARAMETER) {
+            code = 400;  // A directory
         }
-        function startAP() {
-            fetch('/api/wifi/ap/start', {method: 'POST'}).then(r => r.json());
+        response->setCode(code);
+        {
+            Utils::JsonWriter json(*response);
+            json.beginObject()
+                .field("error", err.message ? err.message : getErrorMessage(err.code))
+                .endObject();
+        }
+        request->send(response);
+        return;
+    }
+
+    size_t size = download->file.size();
+    size_t start = 0;
+    size_t end = size > 0 ? size - 1 : 0;
+    RangeResult range = RangeResult::NONE;
+    if (request->hasHeader("Range")) {
+        range = parseRange(request->getHeader("Range")->value().c_str(), size, start, end);
+    }
+
+    char contentRange[48];
+    if (range == RangeResult::UNSATISFIABLE) {
+        snprintf(contentRange, sizeof(contentRange), "bytes */%u", static_cast<unsigned>(size));
+        AsyncWebServerResponse* response = request->beginResponse(416);
+        response->addHeader("Content-Range", contentRange);
+        request->send(response);
+        return;
+    }
+
+    if (start > 0 && !download->file.seek(start)) {
+        request->send(500, "application/json", "{\"error\":\"Seek failed\"}");
+        return;
+    }
+
+    download->length = size > 0 ? end - start + 1 : 0;
+    download->remaining = download->length;
+    download->startMicros = micros();
+
+    // Fixed chunks straight from the file into the TCP buffer
+    AsyncWebServerResponse* response = request->beginResponse(
+        downloadContentType(path), download->length,
+        [this, download, sdCard](uint8_t* buffer, size_t maxLen, size_t) -> size_t {
+            size_t chunk = std::min(std::min(maxLen, download->remaining), DOWNLOAD_CHUNK_SIZE);
+            if (chunk == 0) {
+                return 0;
+            }
+
+            size_t read = download->file.read(buffer, chunk);
+            if (read == 0) {
+                LOG_WARN("[WebUI] Download read failed, %u bytes short",
+                         static_cast<unsigned>(download->remaining));
+                download->remaining = 0;
+                return 0;
+            }
+
+            download->remaining -= read;
+            if (download->remaining == 0) {
+                recordTransfer(_downloadStats[sdCard ? 1 : 0], "Download", sdCard,
+                               download->length, micros() - download->startMicros);
+            }
+            return read;
+        });
+
+    if (range == RangeResult::SATISFIABLE) {
+        snprintf(contentRange, sizeof(contentRange), "bytes %u-%u/%u", static_cast<unsigned>(start),
+                 static_cast<unsigned>(end), static_cast<unsigned>(size));
+        response->setCode(206);
+        response->addHeader("Content-Range", contentRange);
+    }
+    response->addHeader("Accept-Ranges", "bytes");
+
+    int slash = path.lastIndexOf('/');
+    String disposition = "attachment; filename=\"";
+    disposition += slash >= 0 ? path.substring(slash + 1) : path;
+    disposition += "\"";
+    response->addHeader("Content-Disposition", disposition);
+    request->send(response);
+}
+
+void WebUI::recordTransfer(TransferStats& stats, const char* what, bool sdCard, uint32_t bytes,
+                           uint32_t elapsedMicros) {
+    stats.transfers++;
+    stats.bytes += bytes;
+    stats.lastBytes = bytes;
+    stats.lastMicros = elapsedMicros;
+    stats.lastKiBps = elapsedMicros > 0
+        ? static_cast<uint32_t>(static_cast<uint64_t>(bytes) * 1000000 / 1024 / elapsedMicros)
+        : 0;
+
+    LOG_INFO("[WebUI] %s %s: %u bytes in %u ms (%u KiB/s)", what, sdCard ? "SD" : "LittleFS",
+             bytes, elapsedMicros / 1000, stats.lastKiBps);
+}
+
+static String uploadParam(AsyncWebServerRequest* request, const char* name) {
+    if (request->hasParam(name, true)) {
+        return request->getParam(name, true)->value();
+    }
+    if (request->hasParam(name)) {
+        return request->getParam(name)->value();
+    }
+    return String();
+}
+
+static void releaseUpload(UploadContext* upload) {
+    if (--upload->refs > 0) {
+        return;
+    }
+
+    free(upload->buffers[0]);
+    free(upload->buffers[1]);
+    if (upload->freeBuffers) {
+        vSemaphoreDelete(upload->freeBuffers);
+    }
+    if (upload->done) {
+        vSemaphoreDelete(upload->done);
+    }
+    delete upload;
+}
+
+static void rejectUpload(UploadContext* upload, int status, const char* error) {
+    if (upload->status == 0) {
+        upload->status = status;
+        upload->error = error;
+    }
+}
+
+static UploadContext* beginUpload(AsyncWebServerRequest* request) {
+    UploadContext* upload = new UploadContext();
+    upload->sdCard = uploadParam(request, "storage") == "sdcard";
+    upload->path = uploadParam(request, "path").c_str();
+    upload->startMicros = micros();
+
+    // Everything is checked before a byte is stored. The length is the whole
+    // multipart body, so an upper bound on the file: an upload that would only
+    // just fit may be refused, and the writer still fails on a short write.
+    size_t length = request->contentLength();
+    auto& storage = Storage::getInstance();
+    if (upload->path.empty() || upload->path[0] != '/') {
+        rejectUpload(upload, 400, "Missing or relative path");
+        return upload;
+    }
+    if (length == 0) {
+        rejectUpload(upload, 411, "Empty upload");
+        return upload;
+    }
+    if (storage.getFreeSpace(upload->sdCard) < length) {
+        rejectUpload(upload, 507, "Not enough free space");
+        return upload;
+    }
+
+    std::string key = (upload->sdCard ? "sd:" : "fs:") + upload->path;
+    {
+        std::lock_guard<std::mutex> guard(s_uploadLock);
+        if (std::find(s_uploadPaths.begin(), s_uploadPaths.end(), key) != s_uploadPaths.end()) {
+            rejectUpload(upload, 409, "Upload to this path already in progress");
+            return upload;
         }
-        function scanBLE() {
-            fetch('/api/ble/scan').then(r => r.json());
+        if (s_uploadPaths.size() >= WebUI::MAX_UPLOADS || !s_uploadJobs) {
+            rejectUpload(upload, 503, "Too many uploads");
+            return upload;
         }
-        function spamBLE() {
-            fetch('/api/ble/spam', {method: 'POST'}).then(r => r.json());
+        s_uploadPaths.push_back(key);
+        upload->locked = true;
+    }
+
+    upload->buffers[0] = static_cast<uint8_t*>(malloc(WebUI::UPLOAD_BUFFER_SIZE));
+    upload->buffers[1] = static_cast<uint8_t*>(malloc(WebUI::UPLOAD_BUFFER_SIZE));
+    upload->freeBuffers = xSemaphoreCreateCounting(2, 2);
+    upload->done = xSemaphoreCreateBinary();
+    if (!upload->buffers[0] || !upload->buffers[1] || !upload->freeBuffers || !upload->done) {
+        rejectUpload(upload, 503, "Out of memory");
+        return upload;
+    }
+
+    Error err = storage.openFile(upload->path + ".part", upload->file, "w", upload->sdCard);
+    if (err.isError()) {
+        rejectUpload(upload, 500, "Cannot create file");
+        return upload;
+    }
+
+    xSemaphoreTake(upload->freeBuffers, 0);  // The first buffer to fill
+    return upload;
+}
+
+// Hands the active buffer to the writer; for non-final jobs, switches to the other one
+static bool queueUpload(UploadContext* upload, bool final) {
+    UploadJob job = {upload, upload->active, upload->fill, final, false};
+    if (final) {
+        upload->refs++;
+    }
+    if (xQueueSend(s_uploadJobs, &job, 0) != pdTRUE) {
+        if (final) {
+            upload->refs--;
         }
-        setInterval(updateStatus, 1000);
-        updateStatus();
-    </script>
-</body>
-</html>
-        )html");
-    });
+        rejectUpload(upload, 503, "Storage writer stalled");
+        return false;
+    }
+
+    if (final) {
+        upload->finalQueued = true;
+        return true;
+    }
+
+    // The held acks did not slow the sender enough; failing beats parking async_tcp
+    if (xSemaphoreTake(upload->freeBuffers, 0) != pdTRUE) {
+        rejectUpload(upload, 503, "Storage too slow");
+        return false;
+    }
+    upload->active ^= 1;
+    upload->fill = 0;
+    return true;
+}
 
-    // API routes
-    g_webServer->on("/api/status", HTTP_GET, [](AsyncWebServerRequest* request) {
-        using namespace NightStrike::Core;
-        auto& system = System::getInstance();
-        auto info = system.getSystemInfo();
+// Client disconnected (after the reply, or mid-upload)
+static void endUpload(AsyncWebServerRequest* request) {
+    auto it = s_uploads.find(request);
+    if (it == s_uploads.end()) {
+        return;
+    }
 
-        String json = "{";
-        json += "\"freeHeap\":" + String(info.freeHeap) + ",";
-        json += "\"totalHeap\":" + String(info.totalHeap) + ",";
-        json += "\"uptime\":" + String(millis());
-        json += "}";
+    UploadContext* upload = it->second;
+    s_uploads.erase(it);
 
-        request->send(200, "application/json", json);
-    });
+    if (upload->file && !upload->finalQueued) {
+        // At most the other buffer is queued, so its second slot is free
+        upload->refs++;
+        UploadJob job = {upload, 0, 0, true, true};
+        if (xQueueSend(s_uploadJobs, &job, 0) != pdTRUE) {
+            upload->refs--;
+            LOG_ERROR("[WebUI] Upload %s: abort not queued", upload->path.c_str());
+        }
+    } else if (upload->locked && !upload->file) {
+        std::lock_guard<std::mutex> guard(s_uploadLock);
+        std::string key = (upload->sdCard ? "sd:" : "fs:") + upload->path;
+        s_uploadPaths.erase(std::remove(s_uploadPaths.begin(), s_uploadPaths.end(), key),
+                            s_uploadPaths.end());
+    }
+    releaseUpload(upload);
+}
 
-    // Storage API - LittleFS Manager
-    g_webServer->on("/api/storage/littlefs/list", HTTP_GET, [](AsyncWebServerRequest* request) {
-        using namespace NightStrike::Core;
-        auto& storage = Storage::getInstance();
-        std::vector<std::string> files;
-        std::string path = "/";
-        
-        if (request->hasParam("path")) {
-            path = request->getParam("path")->value().c_str();
-        }
-        
-        Error err = storage.listFiles(path, files, false);
-        
-        if (err.isError()) {
-            request->send(500, "application/json", "{\"error\":\"Failed to list files\"}");
+void WebUI::receiveUpload(AsyncWebServerRequest* request, size_t index, uint8_t* data,
+                          size_t len, bool final) {
+    UploadContext* upload;
+    if (index == 0) {
+        upload = beginUpload(request);
+        s_uploads[request] = upload;
+        request->onDisconnect([request]() { endUpload(request); });
+    } else {
+        auto it = s_uploads.find(request);
+        if (it == s_uploads.end()) {
             return;
         }
-        
-        String json = "{\"path\":\"" + String(path.c_str()) + "\",\"files\":[";
-        for (size_t i = 0; i < files.size(); ++i) {
-            if (i > 0) json += ",";
-            json += "\"" + String(files[i].c_str()) + "\"";
-        }
-        json += "]}";
-        request->send(200, "application/json", json);
-    });
+        upload = it->second;
+    }
 
-    g_webServer->on("/api/storage/littlefs/info", HTTP_GET, [](AsyncWebServerRequest* request) {
-        String json = "{";
-        json += "\"mounted\":" + String(LittleFS.begin() ? "true" : "false");
-        json += "}";
-        request->send(200, "application/json", json);
-    });
+    // Backpressure: while the writer holds the other buffer, this data is left
+    // unacknowledged so the sender's window shrinks. Once it has caught up, the
+    // next chunk releases them; ack() clamps to what is pending, so all of it.
+    AsyncClient* client = request->client();
+    bool writerBehind = upload->status == 0 && !final && upload->freeBuffers &&
+                        uxSemaphoreGetCount(upload->freeBuffers) == 0;
+    if (!writerBehind && upload->heldAcks > 0) {
+        client->ack(SIZE_MAX);
+        upload->heldAcks = 0;
+    } else if (writerBehind && upload->heldAcks + len <= UPLOAD_ACK_HOLD) {
+        client->ackLater();
+        upload->heldAcks += len;
+    }
 
-    // Storage API - SD Card Manager
-    g_webServer->on("/api/storage/sdcard/list", HTTP_GET, [](AsyncWebServerRequest* request) {
-        using namespace NightStrike::Core;
-        auto& storage = Storage::getInstance();
-        std::vector<std::string> files;
-        std::string path = "/";
-        
-        if (request->hasParam("path")) {
-            path = request->getParam("path")->value().c_str();
-        }
-        
-        Error err = storage.listFiles(path, files, true);
-        
-        if (err.isError()) {
-            request->send(500, "application/json", "{\"error\":\"Failed to list files\"}");
+    // Rejected or failed: the rest of the body is read and dropped
+    if (upload->status != 0) {
+        return;
+    }
+
+    while (len > 0) {
+        size_t chunk = std::min(len, UPLOAD_BUFFER_SIZE - upload->fill);
+        memcpy(upload->buffers[upload->active] + upload->fill, data, chunk);
+        upload->fill += chunk;
+        data += chunk;
+        len -= chunk;
+        if (upload->fill == UPLOAD_BUFFER_SIZE && !queueUpload(upload, false)) {
             return;
         }
-        
-        String json = "{\"path\":\"" + String(path.c_str()) + "\",\"files\":[";
-        for (size_t i = 0; i < files.size(); ++i) {
-            if (i > 0) json += ",";
-            json += "\"" + String(files[i].c_str()) + "\"";
+    }
+
+    if (final) {
+        queueUpload(upload, true);
+    }
+}
+
+void WebUI::finishUpload(AsyncWebServerRequest* request) {
+    auto it = s_uploads.find(request);
+    if (it == s_uploads.end()) {
+        request->send(400, "application/json", "{\"error\":\"No file in request\"}");
+        return;
+    }
+
+    // The writer may still be on the last buffer and the rename: rather than
+    // wait in async_tcp, answer 202 and let the client ask GET /api/storage/upload
+    UploadContext* upload = it->second;
+    if (upload->finalQueued && xSemaphoreTake(upload->done, 0) != pdTRUE) {
+        request->send(202, "application/json", "{\"status\":\"writing\"}");
+        return;
+    }
+
+    AsyncResponseStream* response = request->beginResponseStream("application/json");
+    response->setCode(upload->status != 0 ? upload->status : 500);
+    {
+        Utils::JsonWriter json(*response);
+        json.beginObject();
+        if (upload->status == 200) {
+            json.field("status", "ok")
+                .field("bytes", upload->written)
+                .field("kibps", upload->kibps);
+        } else {
+            json.field("error", upload->error ? upload->error : "Upload incomplete");
         }
-        json += "]}";
-        request->send(200, "application/json", json);
-    });
+        json.endObject();
+    }
+    request->send(response);
+}
 
-    g_webServer->on("/api/storage/sdcard/info", HTTP_GET, [](AsyncWebServerRequest* request) {
-        using namespace NightStrike::Core;
-        auto& storage = Storage::getInstance();
-        String json = "{";
-        json += "\"mounted\":" + String(storage.isSDCardMounted() ? "true" : "false");
-        if (storage.isSDCardMounted()) {
-            uint64_t freeSpace = storage.getFreeSpace(true);
-            json += ",\"freeSpace\":" + String(freeSpace);
-        }
-        json += "}";
-        request->send(200, "application/json", json);
-    });
+// GET /api/storage/upload?storage=&path=: the outcome of an upload answered with 202
+static void sendUploadStatus(const WebUI::Request& request, WebUI::Response& response) {
+    std::string key = (request.param("storage") == "sdcard" ? "sd:" : "fs:") +
+                      request.param("path").str();
 
-    // File upload endpoint
-    g_webServer->on("/api/storage/upload", HTTP_POST, [](AsyncWebServerRequest* request) {
-        request->send(200, "application/json", "{\"status\":\"ok\"}");
-    }, [](AsyncWebServerRequest* request, String filename, size_t index, uint8_t* data, size_t len, bool final) {
-        using namespace NightStrike::Core;
-        static File uploadFile;
-        static std::string uploadPath;
-        
-        if (index == 0) {
-            String storage = request->getParam("storage", true)->value();
-            String path = request->getParam("path", true)->value();
-            uploadPath = path.c_str();
-            
-            if (storage == "sdcard") {
-                uploadFile = SD.open(uploadPath.c_str(), "w");
-            } else {
-                uploadFile = LittleFS.open(uploadPath.c_str(), "w");
-            }
+    std::lock_guard<std::mutex> guard(s_uploadLock);
+    if (std::find(s_uploadPaths.begin(), s_uploadPaths.end(), key) != s_uploadPaths.end()) {
+        response.setStatus(202);
+        response.send("{\"status\":\"writing\"}");
+        return;
+    }
+    for (const auto& result : s_uploadResults) {
+        if (result.key != key) {
+            continue;
         }
-        
-        if (uploadFile) {
-            uploadFile.write(data, len);
+        response.setStatus(result.status);
+        auto& json = response.json().beginObject();
+        if (result.status == 200) {
+            json.field("status", "ok").field("bytes", result.bytes).field("kibps", result.kibps);
+        } else {
+            json.field("error", result.error ? result.error : "Upload incomplete");
         }
-        
-        if (final) {
-            if (uploadFile) {
-                uploadFile.close();
+        json.endObject();
+        return;
+    }
+    response.setStatus(404);
+    response.send("{\"error\":\"No recent upload to this path\"}");
+}
+
+void WebUI::uploadTask(void* param) {
+    auto* self = static_cast<WebUI*>(param);
+    auto& storage = Storage::getInstance();
+    UploadJob job;
+
+    for (;;) {
+        if (xQueueReceive(s_uploadJobs, &job, portMAX_DELAY) != pdTRUE) {
+            continue;
+        }
+
+        UploadContext* upload = job.upload;
+        if (!job.abort && upload->status == 0 && job.length > 0) {
+            size_t written = upload->file.write(upload->buffers[job.buffer], job.length);
+            upload->written += written;
+            storage.recordWrite(written, upload->sdCard);
+            if (written != job.length) {
+                rejectUpload(upload, 507, "Write failed");
             }
         }
-    });
 
-    // File download endpoint
-    g_webServer->on("/api/storage/download", HTTP_GET, [](AsyncWebServerRequest* request) {
-        if (!request->hasParam("path") || !request->hasParam("storage")) {
-            request->send(400, "application/json", "{\"error\":\"Missing parameters\"}");
-            return;
+        if (!job.final) {
+            xSemaphoreGive(upload->freeBuffers);
+            continue;
         }
-        
-        String path = request->getParam("path")->value();
-        String storage = request->getParam("storage")->value();
-        
-        File file;
-        if (storage == "sdcard") {
-            file = SD.open(path.c_str(), "r");
+
+        upload->file.close();
+        std::string partPath = upload->path + ".part";
+        if (job.abort || upload->status != 0) {
+            storage.deleteFile(partPath, upload->sdCard);
+            LOG_WARN("[WebUI] Upload %s failed: %s", upload->path.c_str(),
+                     job.abort ? "client disconnected" : upload->error);
+        } else if (storage.renameFile(partPath, upload->path, upload->sdCard).isError()) {
+            storage.deleteFile(partPath, upload->sdCard);
+            rejectUpload(upload, 500, "Rename failed");
         } else {
-            file = LittleFS.open(path.c_str(), "r");
+            TransferStats& stats = self->_uploadStats[upload->sdCard ? 1 : 0];
+            self->recordTransfer(stats, "Upload", upload->sdCard, upload->written,
+                                 micros() - upload->startMicros);
+            upload->kibps = stats.lastKiBps;
+            upload->status = 200;
         }
-        
-        if (!file) {
-            request->send(404, "application/json", "{\"error\":\"File not found\"}");
-            return;
+
+        {
+            std::lock_guard<std::mutex> guard(s_uploadLock);
+            std::string key = (upload->sdCard ? "sd:" : "fs:") + upload->path;
+            s_uploadPaths.erase(std::remove(s_uploadPaths.begin(), s_uploadPaths.end(), key),
+                                s_uploadPaths.end());
+
+            // Same file again replaces its result, otherwise the oldest goes
+            auto same = std::find_if(s_uploadResults.begin(), s_uploadResults.end(),
+                                     [&key](const UploadResult& r) { return r.key == key; });
+            if (same != s_uploadResults.end()) {
+                s_uploadResults.erase(same);
+            } else if (s_uploadResults.size() >= MAX_UPLOAD_RESULTS) {
+                s_uploadResults.erase(s_uploadResults.begin());
+            }
+            s_uploadResults.push_back({key, upload->status != 0 ? upload->status : 500,
+                                       job.abort ? "Client disconnected" : upload->error,
+                                       upload->written, upload->kibps});
         }
-        
-        String contentType = "application/octet-stream";
-        if (path.endsWith(".txt")) contentType = "text/plain";
-        else if (path.endsWith(".json")) contentType = "application/json";
-        else if (path.endsWith(".html")) contentType = "text/html";
-        
-        AsyncWebServerResponse* response = request->beginResponse(file, path.c_str(), contentType);
+
+        xSemaphoreGive(upload->done);
+        releaseUpload(upload);
+    }
+}
+
+static void appendEvent(std::string& out, const char* event, const char* data, uint32_t id) {
+    // Payloads are single-line JSON, so one data field each
+    out.append("id: ").append(std::to_string(id));
+    out.append("\nevent: ").append(event);
+    out.append("\ndata: ").append(data).append("\n\n");
+}
+
+void WebUI::registerEvents() {
+    g_webServer->on("/api/events", HTTP_GET, [](AsyncWebServerRequest* request) {
+        std::shared_ptr<EventClient> client(new EventClient());
+        // Reconnect after 2 s if the link drops; the snapshot follows with the next push round
+        client->pending = "retry: 2000\n";
+        appendEvent(client->pending, "hello", "{}", s_eventId);
+        {
+            std::lock_guard<std::mutex> guard(s_eventLock);
+            s_eventClients.push_back(client);
+        }
+        s_resync = true;
+
+        // Runs on the async_tcp task whenever the connection can take more
+        AsyncWebServerResponse* response = request->beginChunkedResponse(
+            "text/event-stream", [client](uint8_t* buffer, size_t maxLen, size_t) -> size_t {
+                std::lock_guard<std::mutex> guard(s_eventLock);
+                if (client->pending.empty()) {
+                    return RESPONSE_TRY_AGAIN;  // Polled again on the next ack or TCP poll
+                }
+                size_t length = std::min(maxLen, client->pending.size());
+                memcpy(buffer, client->pending.data(), length);
+                client->pending.erase(0, length);
+                return length;
+            });
+        response->addHeader("Cache-Control", "no-cache");
         request->send(response);
-        file.close();
     });
+}
 
-    // File delete endpoint
-    g_webServer->on("/api/storage/delete", HTTP_DELETE, [](AsyncWebServerRequest* request) {
-        using namespace NightStrike::Core;
-        if (!request->hasParam("path") || !request->hasParam("storage")) {
-            request->send(400, "application/json", "{\"error\":\"Missing parameters\"}");
+void WebUI::publish(const char* event, const std::string& data) {
+    if (!event) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> guard(s_topicLock);
+    _pushStats.published++;
+    for (auto& topic : s_topics) {
+        if (topic.event == event) {
+            if (topic.dirty) {
+                _pushStats.coalesced++;
+            }
+            topic.data = data;
+            topic.dirty = true;
             return;
         }
-        
-        String path = request->getParam("path")->value();
-        String storage = request->getParam("storage")->value();
-        bool preferSD = (storage == "sdcard");
-        
-        auto& storageMgr = Storage::getInstance();
-        Error err = storageMgr.deleteFile(path.c_str(), preferSD);
-        
-        if (err.isError()) {
-            request->send(500, "application/json", "{\"error\":\"Delete failed\"}");
-        } else {
-            request->send(200, "application/json", "{\"status\":\"ok\"}");
+    }
+
+    if (s_topics.size() >= MAX_PUSH_TOPICS) {
+        LOG_WARN("[WebUI] Too many push topics, dropping '%s'", event);
+        return;
+    }
+    s_topics.push_back({event, data, true});
+}
+
+// Drops closed connections; returns the bytes still queued for the open ones
+static size_t pruneEventClients(size_t& clients) {
+    std::lock_guard<std::mutex> guard(s_eventLock);
+    size_t backlog = 0;
+    clients = 0;
+    for (size_t i = 0; i < s_eventClients.size();) {
+        std::shared_ptr<EventClient> client = s_eventClients[i].lock();
+        if (!client) {
+            s_eventClients[i] = s_eventClients.back();
+            s_eventClients.pop_back();
+            continue;
         }
-    });
+        backlog += client->pending.size();
+        clients++;
+        ++i;
+    }
+    return backlog;
+}
 
-    g_webServer->begin();
-    _active = true;
-    _initialized = true;
+// Queues one event for every open connection
+static void broadcastEvent(const char* event, const char* data) {
+    uint32_t id = ++s_eventId;
+    std::lock_guard<std::mutex> guard(s_eventLock);
+    for (const auto& entry : s_eventClients) {
+        std::shared_ptr<EventClient> client = entry.lock();
+        if (client) {
+            appendEvent(client->pending, event, data, id);
+        }
+    }
+}
 
-    Serial.printf("[WebUI] Started on port %d\n", port);
-    return Error(ErrorCode::SUCCESS);
+bool WebUI::hasSubscribers() const {
+    std::lock_guard<std::mutex> guard(s_eventLock);
+    for (const auto& client : s_eventClients) {
+        if (!client.expired()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void WebUI::pushTask(void* param) {
+    auto* self = static_cast<WebUI*>(param);
+    uint32_t lastStatus = 0;
+
+    while (s_pushRunning) {
+        vTaskDelay(pdMS_TO_TICKS(PUSH_INTERVAL_MS));
+        size_t clients;
+        size_t backlog = pruneEventClients(clients);
+        if (clients == 0) {
+            continue;
+        }
+
+        // Clients that haven't drained what we already queued get nothing new;
+        // publishers keep overwriting their topic meanwhile, so nothing piles up
+        if (backlog / clients > MAX_CLIENT_BACKLOG) {
+            self->_pushStats.deferred++;
+            continue;
+        }
+
+        bool full = s_resync.exchange(false);
+        uint32_t now = millis();
+        if (full || now - lastStatus >= STATUS_INTERVAL_MS) {
+            lastStatus = now;
+            self->pushStatus(full);
+        }
+        self->pushPending(full);
+    }
+
+    s_pushTask = nullptr;
+    vTaskDelete(nullptr);
+}
+
+void WebUI::pushPending(bool all) {
+    size_t count = 0;
+    {
+        std::lock_guard<std::mutex> guard(s_topicLock);
+        for (auto& topic : s_topics) {
+            if (!topic.dirty && !all) {
+                continue;
+            }
+            if (s_outbox.size() <= count) {
+                s_outbox.emplace_back();
+            }
+            s_outbox[count].event = topic.event;
+            s_outbox[count].data = topic.data;
+            count++;
+            topic.dirty = false;
+        }
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+        broadcastEvent(s_outbox[i].event.c_str(), s_outbox[i].data.c_str());
+        _pushStats.sent++;
+    }
+}
+
+void WebUI::pushStatus(bool full) {
+    auto info = System::getInstance().getSystemInfo();
+
+    // Only fields that changed; uptime always, as the heartbeat
+    std::string status;
+    Utils::StringPrint out(status);
+    {
+        Utils::JsonWriter json(out);
+        json.beginObject();
+        if (full || info.freeHeap != s_lastFreeHeap) {
+            json.field("freeHeap", info.freeHeap);
+        }
+        if (full || info.totalHeap != s_lastTotalHeap) {
+            json.field("totalHeap", info.totalHeap);
+        }
+        if (full || _assetStats.bytesSent != s_lastAssetBytes) {
+            json.field("assetBytes", _assetStats.bytesSent)
+                .field("assetBytesUncompressed", _assetStats.bytesUncompressed);
+        }
+        json.field("uptime", millis()).endObject();
+    }
+    s_lastFreeHeap = info.freeHeap;
+    s_lastTotalHeap = info.totalHeap;
+    s_lastAssetBytes = _assetStats.bytesSent;
+
+    broadcastEvent("status", status.c_str());
+    _pushStats.sent++;
 }
 
 Error WebUI::shutdown() {
@@ -286,27 +957,274 @@ Error WebUI::shutdown() {
         return Error(ErrorCode::NOT_INITIALIZED);
     }
 
+    // The push task uses the event source; let it finish its round and exit
+    s_pushRunning = false;
+    for (int i = 0; s_pushTask && i < 50; ++i) {
+        delay(PUSH_INTERVAL_MS / 10);
+    }
+
     if (g_webServer) {
-        g_webServer->end();
+        g_webServer->end();  // Closes the event streams with every other connection
         delete g_webServer;
         g_webServer = nullptr;
     }
+    {
+        std::lock_guard<std::mutex> guard(s_eventLock);
+        s_eventClients.clear();
+    }
 
     _active = false;
     _initialized = false;
     return Error(ErrorCode::SUCCESS);
 }
 
-Error WebUI::addRoute(const std::string& method, const std::string& path, RouteHandler handler) {
-    if (!_initialized || !g_webServer) {
-        return Error(ErrorCode::NOT_INITIALIZED);
+Error WebUI::addRoute(Method method, const char* path, RouteHandler handler) {
+    if (!path || path[0] != '/' || !handler) {
+        return Error(ErrorCode::INVALID_PARAMETER);
     }
 
-    // TODO: Implement custom route handling
-    Serial.printf("[WebUI] Route added: %s %s\n", method.c_str(), path.c_str());
+    _routes.push_back({method, path, handler});
+    if (_initialized && g_webServer) {
+        registerRoute(_routes.size() - 1);
+    }
     return Error(ErrorCode::SUCCESS);
 }
 
+void WebUI::registerCoreRoutes() {
+    addRoute(Method::GET, "/api/status", [this](const Request&, Response& response) {
+        auto info = System::getInstance().getSystemInfo();
+        response.json()
+            .beginObject()
+            .field("freeHeap", info.freeHeap)
+            .field("totalHeap", info.totalHeap)
+            .field("uptime", millis())
+            .field("assetBytes", _assetStats.bytesSent)
+            .field("assetBytesUncompressed", _assetStats.bytesUncompressed)
+            .endObject();
+    });
+
+    // Storage API - LittleFS and SD card managers
+    addRoute(Method::GET, "/api/storage/littlefs/list",
+             [](const Request& request, Response& response) {
+                 sendFileList(request, response, false);
+             });
+    addRoute(Method::GET, "/api/storage/littlefs/info", [](const Request&, Response& response) {
+        sendStorageInfo(response, false);
+    });
+    addRoute(Method::GET, "/api/storage/sdcard/list",
+             [](const Request& request, Response& response) {
+                 sendFileList(request, response, true);
+             });
+    addRoute(Method::GET, "/api/storage/sdcard/info", [](const Request&, Response& response) {
+        sendStorageInfo(response, true);
+    });
+
+    addRoute(Method::GET, "/api/storage/upload", [](const Request& request, Response& response) {
+        sendUploadStatus(request, response);
+    });
+
+    addRoute(Method::DELETE, "/api/storage/delete", [](const Request& request, Response& response) {
+        if (!request.hasParam("path") || !request.hasParam("storage")) {
+            response.setStatus(400);
+            response.send("{\"error\":\"Missing parameters\"}");
+            return;
+        }
+
+        bool preferSD = request.param("storage") == "sdcard";
+        Error err = Storage::getInstance().deleteFile(request.param("path").str(), preferSD);
+        if (err.isError()) {
+            response.setStatus(500);
+            response.send("{\"error\":\"Delete failed\"}");
+        } else {
+            response.send("{\"status\":\"ok\"}");
+        }
+    });
+
+    addRoute(Method::GET, "/metrics", [](const Request&, Response& response) {
+        response.setContentType("text/plain; version=0.0.4");
+        Metrics::getInstance().write(response.stream());
+    });
+}
+
+static WebRequestMethodComposite toServerMethod(WebUI::Method method) {
+    switch (method) {
+        case WebUI::Method::GET: return HTTP_GET;
+        case WebUI::Method::POST: return HTTP_POST;
+        case WebUI::Method::PUT: return HTTP_PUT;
+        case WebUI::Method::DELETE: return HTTP_DELETE;
+        default: return HTTP_ANY;
+    }
+}
+
+// Bodies of routed requests are kept in _tempObject, which the server frees with the request
+struct RequestBody {
+    size_t length;
+    char data[1];
+};
+
+static void collectBody(AsyncWebServerRequest* request, uint8_t* data, size_t len, size_t index,
+                        size_t total) {
+    if (total > WebUI::MAX_BODY_SIZE) {
+        return;  // Too large: body() stays empty
+    }
+    if (index == 0) {
+        request->_tempObject = malloc(sizeof(RequestBody) + total);
+        if (request->_tempObject) {
+            static_cast<RequestBody*>(request->_tempObject)->length = 0;
+        }
+    }
+
+    auto* body = static_cast<RequestBody*>(request->_tempObject);
+    if (!body || index + len > total) {
+        return;
+    }
+    memcpy(body->data + index, data, len);
+    body->length = index + len;
+    body->data[body->length] = '\0';
+}
+
+void WebUI::registerRoute(size_t index) {
+    const Route& route = _routes[index];
+    g_webServer->on(route.path.c_str(), toServerMethod(route.method),
+                    [this, index](AsyncWebServerRequest* request) { dispatch(index, request); },
+                    nullptr, collectBody);
+}
+
+void WebUI::dispatch(size_t index, AsyncWebServerRequest* request) {
+    static const uint32_t LATENCY_BOUNDS_MS[] = {1, 2, 5, 10, 25, 50, 100, 250, 500, 1000};
+    static Metrics::Counter& requests = Metrics::getInstance().counter(
+        "nightstrike_http_requests_total", "Routed API requests");
+    static Metrics::Histogram& latency = Metrics::getInstance().histogram(
+        "nightstrike_http_request_duration_ms", "Time spent in route handlers",
+        LATENCY_BOUNDS_MS, sizeof(LATENCY_BOUNDS_MS) / sizeof(LATENCY_BOUNDS_MS[0]));
+
+    uint32_t heapBefore = ESP.getFreeHeap();
+    uint32_t start = micros();
+    Request req(request);
+    Response res(request);
+    _routes[index].handler(req, res);
+    res.finish(heapBefore);
+
+    requests.inc();
+    latency.observe((micros() - start) / 1000);
+}
+
+WebUI::Method WebUI::Request::method() const {
+    switch (_request->method()) {
+        case HTTP_GET: return Method::GET;
+        case HTTP_POST: return Method::POST;
+        case HTTP_PUT: return Method::PUT;
+        case HTTP_DELETE: return Method::DELETE;
+        default: return Method::ANY;
+    }
+}
+
+WebUI::StringRef WebUI::Request::path() const {
+    const String& url = _request->url();
+    return StringRef(url.c_str(), url.length());
+}
+
+bool WebUI::Request::hasParam(const char* name) const {
+    return _request->hasParam(name, true) || _request->hasParam(name);
+}
+
+WebUI::StringRef WebUI::Request::param(const char* name) const {
+    AsyncWebParameter* param = _request->getParam(name, true);
+    if (!param) {
+        param = _request->getParam(name);
+    }
+    if (!param) {
+        return StringRef();
+    }
+    return StringRef(param->value().c_str(), param->value().length());
+}
+
+WebUI::StringRef WebUI::Request::header(const char* name) const {
+    AsyncWebHeader* header = _request->getHeader(name);
+    if (!header) {
+        return StringRef();
+    }
+    return StringRef(header->value().c_str(), header->value().length());
+}
+
+WebUI::StringRef WebUI::Request::body() const {
+    auto* body = static_cast<RequestBody*>(_request->_tempObject);
+    if (!body) {
+        return StringRef();
+    }
+    return StringRef(body->data, body->length);
+}
+
+void WebUI::Response::setStatus(int status) {
+    _status = status;
+    if (_stream) {
+        _stream->setCode(status);
+    }
+}
+
+void WebUI::Response::setContentType(const char* contentType) {
+    _contentType = contentType;
+    if (_stream) {
+        _stream->setContentType(contentType);
+    }
+}
+
+void WebUI::Response::addHeader(const char* name, const char* value) {
+    _headers.emplace_back(name, value);
+}
+
+void WebUI::Response::send(const char* body) {
+    Print& out = stream();
+    out.write(reinterpret_cast<const uint8_t*>(body), strlen(body));
+}
+
+Utils::JsonWriter& WebUI::Response::json() {
+    if (!_json) {
+        _json.reset(new Utils::JsonWriter(*open()));
+    }
+    return *_json;
+}
+
+Print& WebUI::Response::stream() {
+    if (_json) {
+        _json->flush();  // Keep ordering when both are used
+    }
+    return *open();
+}
+
+void WebUI::Response::sendChunked(Filler filler) {
+    _filler = filler;
+}
+
+AsyncResponseStream* WebUI::Response::open() {
+    if (!_stream) {
+        _stream = _request->beginResponseStream(_contentType);
+        _stream->setCode(_status);
+    }
+    return _stream;
+}
+
+void WebUI::Response::finish(uint32_t heapBefore) {
+    _json.reset();  // Flushes into the stream
+
+    AsyncWebServerResponse* response;
+    if (_filler) {
+        delete _stream;  // Anything written before sendChunked() is dropped
+        _stream = nullptr;
+        response = _request->beginChunkedResponse(_contentType, _filler);
+        response->setCode(_status);
+    } else if (_stream) {
+        response = _stream;
+    } else {
+        response = _request->beginResponse(_status);
+    }
+
+    for (const auto& header : _headers) {
+        response->addHeader(header.first.c_str(), header.second.c_str());
+    }
+    sendWithHeapReport(_request, response, heapBefore);
+}
+
 std::string WebUI::getURL() const {
     if (!_active) {
         return "";
@@ -8,6 +8,8 @@
 #include "core/config.h"
 #include "core/display.h"
 #include "core/input.h"
+#include "core/input_recorder.h"
+#include "core/notifications.h"
 #include "core/menu.h"
 #include "core/web_ui.h"
 #include "core/storage.h"
@@ -244,6 +246,15 @@ void setup() {
         Serial.printf("[WebUI] Started at %s\n", webUI.getURL().c_str());
     }
 
+    // Draw off-screen and push frames with DMA when there is memory for two buffers
+    if (display.isInitialized()) {
+        err = display.enableAsyncFlush(true);
+        if (err.isError()) {
+            Serial.printf("[WARN] Async display flush unavailable: %s\n",
+                          getErrorMessage(err.code));
+        }
+    }
+
     // Show menu
     menu.show();
 
@@ -255,9 +266,18 @@ void loop() {
     auto& input = Input::getInstance();
     input.update();
 
+    // Inject replayed input sessions
+    InputRecorder::getInstance().update();
+
     // Update menu
     auto& menu = Menu::getInstance();
     menu.update();
 
+    // Expire toasts
+    Notifications::getInstance().update();
+
+    // Push anything drawn outside a frame
+    Display::getInstance().update();
+
     delay(10);
 }
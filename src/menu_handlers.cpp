@@ -6,7 +6,16 @@
 #include "core/menu.h"
 #include "core/display.h"
 #include "core/errors.h"
+#include "core/input.h"
+#include "core/input_recorder.h"
+#include "core/notifications.h"
+#include "core/spectrum_chart.h"
+#include "core/web_ui.h"
 #include "modules/wifi_module.h"
+#include "modules/scan_store.h"
+#include "modules/pcap_writer.h"
+#include "modules/channel_hopper.h"
+#include "modules/device_table.h"
 #include "modules/ble_module.h"
 #include "modules/rf_module.h"
 #include "modules/rfid_module.h"
@@ -22,6 +31,8 @@
 #include "modules/interpreter_module.h"
 #include "modules/others_module.h"
 #include "core/config.h"
+#include "utils/json_writer.h"
+#include "utils/string_utils.h"
 #include <Arduino.h>
 
 using namespace NightStrike::Core;
@@ -49,7 +60,12 @@ void setupMainMenu();
 void showPhysicalHackMenu();
 void showWiFiMenu();
 void showWiFiNetworkList();
-void showWiFiNetworkActions(size_t networkIndex);
+// Menu entries keep the AP's BSSID: rescans move rows, the BSSID stays
+struct NetworkRef {
+    uint8_t bssid[6];
+};
+void showWiFiNetworkActions(const NetworkRef& network);
+void showWiFiDeviceList();
 void showBLEMenu();
 void showBLEDeviceList();
 void showBLEDeviceActions(size_t deviceIndex);
@@ -68,21 +84,108 @@ void showEthernetMenu();
 void showInterpreterMenu();
 void showOthersMenu();
 
-// Helper to show message on display
+// Helper to show a message as a toast over the current screen (non-blocking)
 void showMessage(const char* msg, uint32_t duration = 2000) {
+    Notifications::getInstance().post(msg, duration);
+}
+
+// Full-screen spectrum view; runs until a button (or serial key) is pressed.
+// `sweep` is called every frame for analyzers that scan synchronously.
+// Mirror the chart to web clients, a few times a second at most
+static void publishSpectrum(const char* title, SpectrumChart& chart) {
+    auto& webUI = WebUI::getInstance();
+    if (!webUI.hasSubscribers()) {
+        return;
+    }
+
+    static std::vector<int16_t> levels;
+    chart.getLevels(levels);
+
+    std::string data;
+    NightStrike::Utils::StringPrint out(data);
+    {
+        NightStrike::Utils::JsonWriter json(out);
+        json.beginObject()
+            .field("title", title)
+            .field("minLevel", chart.getConfig().minLevel)
+            .field("maxLevel", chart.getConfig().maxLevel)
+            .key("levels")
+            .beginArray();
+        for (int16_t level : levels) {
+            json.value(level);
+        }
+        json.endArray().endObject();
+    }
+    webUI.publish("spectrum", data);
+}
+
+static void runSpectrumView(const char* title, SpectrumChart& chart, std::function<void()> sweep) {
     auto& display = Display::getInstance();
+    auto& input = Input::getInstance();
+    const unsigned long frameInterval = 33;  // ~30 fps
+    const unsigned long publishInterval = 250;
+
+    // Let go of the button that opened the view
+    while (input.isButtonPressed(Input::Button::SELECT)) {
+        delay(10);
+    }
+
+    display.beginFrame();
     display.clear();
     display.setTextColor(Display::Color::Green(), Display::Color::Black());
     display.setTextSize(1);
-    display.drawTextCentered(Display::Point(display.getSize().width / 2,
-                                            display.getSize().height / 2),
-                             msg);
-    delay(duration);
-    // Don't auto-show menu - caller should call menu.show() or setupMainMenu()
+    display.drawText(Display::Point(2, 2), title);
+    display.endFrame();
+    chart.invalidate();
+
+    unsigned long nextFrame = millis();
+    unsigned long lastPublish = 0;
+    while (!input.isButtonPressed(Input::Button::SELECT) &&
+           !input.isButtonPressed(Input::Button::BACK) && !Serial.available()) {
+        if (sweep) {
+            sweep();
+        }
+
+        if (millis() - lastPublish >= publishInterval) {
+            lastPublish = millis();
+            publishSpectrum(title, chart);
+        }
+
+        display.beginFrame();
+        chart.render(display);
+        display.endFrame();
+
+        nextFrame += frameInterval;
+        long wait = static_cast<long>(nextFrame - millis());
+        if (wait > 0) {
+            delay(wait);
+        } else {
+            nextFrame = millis();
+        }
+    }
+
+    while (Serial.available()) {
+        Serial.read();
+    }
+    while (input.isButtonPressed(Input::Button::SELECT) ||
+           input.isButtonPressed(Input::Button::BACK)) {
+        delay(10);
+    }
+    input.discardPendingEvents();
+}
+
+static SpectrumChart::Config spectrumLayout(uint16_t bins, int16_t minLevel, int16_t maxLevel) {
+    auto& display = Display::getInstance();
+    SpectrumChart::Config config;
+    config.origin = Display::Point(0, 12);
+    config.size = Display::Size(display.getSize().width, display.getSize().height - 12);
+    config.bins = bins;
+    config.minLevel = minLevel;
+    config.maxLevel = maxLevel;
+    return config;
 }
 
-// Global storage for scanned networks/devices
-static std::vector<WiFiModule::AccessPoint> g_scannedAPs;
+// Global storage for scanned devices; WiFi networks live in ScanStore
 static std::vector<BLEModule::BLEDeviceInfo> g_scannedBLEDevices;
 static std::vector<std::string> g_scannedHosts;
 static std::vector<PhysicalHackModule::ExploitPayload> g_availableExploits;
@@ -92,28 +195,33 @@ void showWiFiNetworkList() {
     auto& menu = Menu::getInstance();
     menu.clear();
 
-    if (g_scannedAPs.empty()) {
+    size_t count;
+    {
+        // Labels straight from the store; the reader is dropped before the menu runs
+        ScanStore::Reader reader = ScanStore::getInstance().read();
+        count = reader.size();
+        for (size_t i = 0; i < 15 && i < count; ++i) {
+            ScanStore::Entry ap = reader.entry(i);
+            char label[64];
+            // Format: "SSID (RSSI: -XX Ch:XX)"
+            snprintf(label, sizeof(label), "%s (%ddBm Ch%d)", *ap.ssid ? ap.ssid : "(hidden)",
+                     ap.rssi, ap.channel);
+
+            NetworkRef network;
+            memcpy(network.bssid, ap.bssid, sizeof(network.bssid));
+            menu.addItem(Menu::MenuItem(label, [network]() {
+                // Show network actions menu
+                showWiFiNetworkActions(network);
+            }));
+        }
+    }
+
+    if (count == 0) {
         showMessage("No networks found");
-        delay(2000);
         showWiFiMenu();
         return;
     }
 
-    // Add each network to menu
-    for (size_t i = 0; i < g_scannedAPs.size() && i < 15; ++i) {
-        const auto& ap = g_scannedAPs[i];
-        char label[64];
-        // Format: "SSID (RSSI: -XX Ch:XX)"
-        snprintf(label, sizeof(label), "%s (%ddBm Ch%d)", 
-                 ap.ssid.empty() ? "(hidden)" : ap.ssid.c_str(), 
-                 ap.rssi, ap.channel);
-        
-        menu.addItem(Menu::MenuItem(label, [i]() {
-            // Show network actions menu
-            showWiFiNetworkActions(i);
-        }));
-    }
-
     menu.addItem(Menu::MenuItem("Back", []() {
         showWiFiMenu();
     }));
@@ -122,38 +230,39 @@ void showWiFiNetworkList() {
 }
 
 // Show actions for selected WiFi network
-void showWiFiNetworkActions(size_t networkIndex) {
-    if (networkIndex >= g_scannedAPs.size()) {
+void showWiFiNetworkActions(const NetworkRef& network) {
+    WiFiModule::ScanRecord record;
+    if (!ScanStore::getInstance().find(network.bssid, record)) {
+        // Gone from the results since the list was shown
+        showMessage("List is stale, rescan");
         showWiFiMenu();
         return;
     }
+    WiFiModule::AccessPoint ap;
+    WiFiModule::toAccessPoint(record, ap);
 
-    const auto& ap = g_scannedAPs[networkIndex];
     auto& menu = Menu::getInstance();
     menu.clear();
 
     char title[64];
     snprintf(title, sizeof(title), "Network: %s", ap.ssid.empty() ? "(hidden)" : ap.ssid.c_str());
     
-    menu.addItem(Menu::MenuItem("Info", [networkIndex]() {
-        const auto& ap = g_scannedAPs[networkIndex];
+    menu.addItem(Menu::MenuItem("Info", [network, ap]() {
         char info[128];
         snprintf(info, sizeof(info), "SSID: %s\nRSSI: %d dBm\nCh: %d\nEnc: %s",
                  ap.ssid.empty() ? "(hidden)" : ap.ssid.c_str(),
                  ap.rssi, ap.channel, ap.encrypted ? "Yes" : "No");
         showMessage(info, 3000);
-        delay(3000);
-        showWiFiNetworkActions(networkIndex);
+        showWiFiNetworkActions(network);
     }));
 
-    menu.addItem(Menu::MenuItem("Deauth Attack", [networkIndex]() {
+    menu.addItem(Menu::MenuItem("Deauth Attack", [network, ap]() {
         if (!g_wifiModule || !g_wifiModule->isInitialized()) {
             showMessage("WiFi not initialized");
-            showWiFiNetworkActions(networkIndex);
+            showWiFiNetworkActions(network);
             return;
         }
 
-        const auto& ap = g_scannedAPs[networkIndex];
         showMessage("Starting Deauth...", 1000);
         
         // Use AccessPoint directly for deauthAttack
@@ -163,18 +272,16 @@ void showWiFiNetworkActions(size_t networkIndex) {
         } else {
             showMessage("Deauth active");
         }
-        delay(2000);
-        showWiFiNetworkActions(networkIndex);
+        showWiFiNetworkActions(network);
     }));
 
-    menu.addItem(Menu::MenuItem("Clone AP", [networkIndex]() {
+    menu.addItem(Menu::MenuItem("Clone AP", [network, ap]() {
         if (!g_wifiModule || !g_wifiModule->isInitialized()) {
             showMessage("WiFi not initialized");
-            showWiFiNetworkActions(networkIndex);
+            showWiFiNetworkActions(network);
             return;
         }
 
-        const auto& ap = g_scannedAPs[networkIndex];
         showMessage("Cloning AP...", 1000);
         
         auto err = g_wifiModule->startAP(ap.ssid, "");
@@ -183,17 +290,79 @@ void showWiFiNetworkActions(size_t networkIndex) {
         } else {
             showMessage("AP cloned");
         }
-        delay(2000);
-        showWiFiNetworkActions(networkIndex);
+        showWiFiNetworkActions(network);
     }));
 
-    menu.addItem(Menu::MenuItem("Back", [networkIndex]() {
+    menu.addItem(Menu::MenuItem("Clients", [network, ap]() {
+        std::vector<WiFiModule::Client> clients;
+        if (g_wifiModule) {
+            g_wifiModule->getClients(ap, clients);
+        }
+        if (clients.empty()) {
+            showMessage(g_wifiModule && g_wifiModule->isInventoryRunning()
+                            ? "No clients seen"
+                            : "No clients seen\nStart Device Inventory");
+            showWiFiNetworkActions(network);
+            return;
+        }
+
+        char info[160];
+        int length = snprintf(info, sizeof(info), "%u clients",
+                              static_cast<unsigned>(clients.size()));
+        for (size_t i = 0; i < clients.size() && i < 4; ++i) {
+            length += snprintf(info + length, sizeof(info) - length, "\n%s %d",
+                               clients[i].mac.c_str(), clients[i].rssi);
+        }
+        showMessage(info, 4000);
+        showWiFiNetworkActions(network);
+    }));
+
+    menu.addItem(Menu::MenuItem("Back", []() {
         showWiFiNetworkList();
     }));
 
     menu.show();
 }
 
+// Devices from the passive inventory, most recently seen first
+void showWiFiDeviceList() {
+    auto& menu = Menu::getInstance();
+    menu.clear();
+
+    std::vector<DeviceTable::Device> devices;
+    DeviceTable::getInstance().recent(devices, 15);
+    if (devices.empty()) {
+        showMessage("No devices seen");
+        showWiFiMenu();
+        return;
+    }
+
+    for (const auto& device : devices) {
+        char label[64];
+        // Format: "AP AA:BB:CC:DD:EE:FF -XX"
+        std::string mac = NightStrike::Utils::macToString(device.mac);
+        snprintf(label, sizeof(label), "%s %s %d", device.isAP ? "AP" : "ST", mac.c_str(),
+                 device.rssiAvg);
+
+        menu.addItem(Menu::MenuItem(label, [device, mac]() {
+            std::string bssid =
+                device.associated ? NightStrike::Utils::macToString(device.bssid) : "-";
+            char info[160];
+            snprintf(info, sizeof(info), "%s\n%s\nBSSID: %s\nRSSI: %d/%d/%d Ch%u\nFrames: %u",
+                     mac.c_str(), device.isAP ? "Access point" : "Station", bssid.c_str(),
+                     device.rssiMin, device.rssiAvg, device.rssiMax, device.channel, device.frames);
+            showMessage(info, 4000);
+            showWiFiDeviceList();
+        }));
+    }
+
+    menu.addItem(Menu::MenuItem("Back", []() {
+        showWiFiMenu();
+    }));
+
+    menu.show();
+}
+
 // BLE Device List Menu
 void showBLEDeviceList() {
     auto& menu = Menu::getInstance();
@@ -201,7 +370,6 @@ void showBLEDeviceList() {
 
     if (g_scannedBLEDevices.empty()) {
         showMessage("No devices found");
-        delay(2000);
         showBLEMenu();
         return;
     }
@@ -247,7 +415,6 @@ void showBLEDeviceActions(size_t deviceIndex) {
                  dev.rssi,
                  dev.connectable ? "Yes" : "No");
         showMessage(info, 3000);
-        delay(3000);
         showBLEDeviceActions(deviceIndex);
     }));
 
@@ -267,7 +434,6 @@ void showBLEDeviceActions(size_t deviceIndex) {
         } else {
             showMessage("Keyboard active");
         }
-        delay(2000);
         showBLEDeviceActions(deviceIndex);
     }));
 
@@ -303,7 +469,6 @@ void showWiFiMenu() {
         } else {
             showMessage("WiFi initialized");
         }
-        delay(2000);
         showWiFiMenu();
     }));
 
@@ -317,27 +482,25 @@ void showWiFiMenu() {
             return;
         }
 
-        g_scannedAPs.clear();
-        auto err = g_wifiModule->scanNetworks(g_scannedAPs);
+        std::vector<WiFiModule::AccessPoint> aps;
+        auto err = g_wifiModule->scanNetworks(aps);
         
         if (err.isError()) {
             Serial.printf("[WiFi] Scan failed: %s\n", getErrorMessage(err.code));
             showMessage("Scan failed");
-            delay(2000);
             showWiFiMenu();
             return;
         }
 
-        Serial.printf("[WiFi] Found %zu networks\n", g_scannedAPs.size());
-        for (size_t i = 0; i < g_scannedAPs.size() && i < 10; ++i) {
+        Serial.printf("[WiFi] Found %zu networks\n", aps.size());
+        for (size_t i = 0; i < aps.size() && i < 10; ++i) {
             Serial.printf("  %zu. %s (RSSI: %d, Ch: %d)\n", 
-                i+1, g_scannedAPs[i].ssid.c_str(), g_scannedAPs[i].rssi, g_scannedAPs[i].channel);
+                i+1, aps[i].ssid.c_str(), aps[i].rssi, aps[i].channel);
         }
         
         // Show network list menu
-        if (g_scannedAPs.empty()) {
+        if (aps.empty()) {
             showMessage("No networks found");
-            delay(2000);
             showWiFiMenu();
         } else {
             showWiFiNetworkList();
@@ -404,8 +567,9 @@ void showWiFiMenu() {
             return;
         }
 
-        auto err = g_wifiModule->startSniffer([](const uint8_t* data, size_t len) {
-            Serial.printf("[WiFi] Packet: %zu bytes\n", len);
+        auto err = g_wifiModule->startSniffer([](const WiFiModule::SnifferPacket& packet) {
+            Serial.printf("[WiFi] Packet: %u bytes ch%u %d dBm\n", packet.length, packet.channel,
+                          packet.rssi);
         });
         
         if (err.isError()) {
@@ -416,6 +580,90 @@ void showWiFiMenu() {
         showWiFiMenu();
     }));
 
+    menu.addItem(Menu::MenuItem(g_wifiModule && g_wifiModule->isCapturing() ? "Stop PCAP Capture"
+                                                                             : "PCAP Capture",
+                                []() {
+        if (!g_wifiModule || !g_wifiModule->isInitialized()) {
+            showMessage("WiFi not initialized");
+            showWiFiMenu();
+            return;
+        }
+
+        if (g_wifiModule->isCapturing()) {
+            g_wifiModule->stopCapture();
+            PcapWriter::Stats stats;
+            PcapWriter::getInstance().getStats(stats);
+            char info[96];
+            snprintf(info, sizeof(info), "Saved %u frames\n%u dropped, %u files",
+                     stats.framesWritten, stats.framesDropped, stats.files);
+            showMessage(info, 3000);
+            showWiFiMenu();
+            return;
+        }
+
+        auto err = g_wifiModule->startCapture();
+        if (err.isError()) {
+            showMessage(err.code == ErrorCode::STORAGE_NOT_MOUNTED ? "No SD card"
+                                                                   : "Capture failed");
+        } else {
+            showMessage("Capturing to SD");
+        }
+        showWiFiMenu();
+    }));
+
+    menu.addItem(Menu::MenuItem(g_wifiModule && g_wifiModule->isHopping() ? "Stop Channel Hop"
+                                                                           : "Channel Hop",
+                                []() {
+        if (!g_wifiModule || !g_wifiModule->isInitialized()) {
+            showMessage("WiFi not initialized");
+            showWiFiMenu();
+            return;
+        }
+
+        if (g_wifiModule->isHopping()) {
+            ChannelHopper::Stats stats;
+            ChannelHopper::getInstance().getStats(stats);
+            g_wifiModule->stopChannelHopper();
+            char info[64];
+            snprintf(info, sizeof(info), "%u devices\n%u per minute", stats.devices,
+                     stats.devicesPerMinute);
+            showMessage(info, 3000);
+        } else if (g_wifiModule->startChannelHopper().isError()) {
+            showMessage("Hopper failed");
+        } else {
+            showMessage("Hopping channels");
+        }
+        showWiFiMenu();
+    }));
+
+    menu.addItem(Menu::MenuItem(g_wifiModule && g_wifiModule->isInventoryRunning()
+                                    ? "Stop Device Inventory"
+                                    : "Device Inventory",
+                                []() {
+        if (!g_wifiModule || !g_wifiModule->isInitialized()) {
+            showMessage("WiFi not initialized");
+            showWiFiMenu();
+            return;
+        }
+
+        if (g_wifiModule->isInventoryRunning()) {
+            g_wifiModule->stopInventory();
+            char info[64];
+            snprintf(info, sizeof(info), "%u devices",
+                     static_cast<unsigned>(DeviceTable::getInstance().size()));
+            showMessage(info, 3000);
+        } else if (g_wifiModule->startInventory().isError()) {
+            showMessage("Inventory failed");
+        } else {
+            showMessage("Listening for devices");
+        }
+        showWiFiMenu();
+    }));
+
+    menu.addItem(Menu::MenuItem("Devices", []() {
+        showWiFiDeviceList();
+    }));
+
     menu.addItem(Menu::MenuItem("Back", []() {
         setupMainMenu();
     }));
@@ -444,7 +692,6 @@ void showBLEMenu() {
         if (err.isError()) {
             Serial.printf("[BLE] Scan failed: %s\n", getErrorMessage(err.code));
             showMessage("Scan failed");
-            delay(2000);
             showBLEMenu();
             return;
         }
@@ -458,7 +705,6 @@ void showBLEMenu() {
         // Show device list menu
         if (g_scannedBLEDevices.empty()) {
             showMessage("No devices found");
-            delay(2000);
             showBLEMenu();
         } else {
             showBLEDeviceList();
@@ -552,7 +798,6 @@ void showRFMenu() {
         } else {
             showMessage("RF initialized");
         }
-        delay(2000);
         showRFMenu();
     }));
 
@@ -577,7 +822,29 @@ void showRFMenu() {
         } else {
             showMessage("Jammer active");
         }
-        delay(2000);
+        showRFMenu();
+    }));
+
+    menu.addItem(Menu::MenuItem("Spectrum", []() {
+        if (!g_rfModule || !g_rfModule->isInitialized()) {
+            showMessage("RF not initialized");
+            showRFMenu();
+            return;
+        }
+
+        // One bin per probed frequency, in the order the analyzer reports them
+        static SpectrumChart chart(spectrumLayout(12, -100, -30));
+        static uint16_t bin = 0;
+        chart.reset();
+        runSpectrumView("Sub-GHz spectrum", chart, []() {
+            bin = 0;
+            g_rfModule->stopSpectrumAnalyzer();
+            g_rfModule->startSpectrumAnalyzer([](uint32_t freq, int8_t rssi) {
+                chart.addSample(bin++, rssi);
+            });
+            chart.endSweep();
+        });
+        g_rfModule->stopSpectrumAnalyzer();
         showRFMenu();
     }));
 
@@ -633,7 +900,6 @@ void showBlackHatMenu() {
         if (err.isError()) {
             Serial.printf("[BlackHat] Scan failed: %s\n", getErrorMessage(err.code));
             showMessage("Scan failed");
-            delay(2000);
             showBlackHatMenu();
             return;
         }
@@ -646,7 +912,6 @@ void showBlackHatMenu() {
         // Show host list menu
         if (g_scannedHosts.empty()) {
             showMessage("No hosts found");
-            delay(2000);
             showBlackHatMenu();
         } else {
             showBlackHatHostList();
@@ -662,7 +927,6 @@ void showBlackHatMenu() {
 
         Serial.println("[BlackHat] Port scan (use Serial for IP)");
         showMessage("Use Serial/WebUI");
-        delay(2000);
         showBlackHatMenu();
     }));
 
@@ -679,7 +943,6 @@ void showBlackHatMenu() {
         } else {
             showMessage("Harvester active");
         }
-        delay(2000);
         showBlackHatMenu();
     }));
 
@@ -695,7 +958,6 @@ void showBlackHatMenu() {
         
         if (err.isError()) {
             showMessage("Failed to get creds");
-            delay(2000);
             showBlackHatMenu();
             return;
         }
@@ -709,7 +971,6 @@ void showBlackHatMenu() {
         char msg[64];
         snprintf(msg, sizeof(msg), "Found %zu creds", creds.size());
         showMessage(msg);
-        delay(2000);
         showBlackHatMenu();
     }));
 
@@ -748,7 +1009,6 @@ void showPhysicalHackMenu() {
         } else {
             showMessage("Physical Hack initialized");
         }
-        delay(2000);
         showPhysicalHackMenu();
     }));
 
@@ -768,7 +1028,6 @@ void showPhysicalHackMenu() {
         } else {
             showMessage("Exploit executed!");
         }
-        delay(2000);
         showPhysicalHackMenu();
     }));
 
@@ -813,7 +1072,6 @@ void showPhysicalHackMenu() {
             Serial.printf("[PhysicalHack] Detected: %s\n", osName);
             showMessage(osName);
         }
-        delay(2000);
         showPhysicalHackMenu();
     }));
 
@@ -830,7 +1088,6 @@ void showPhysicalHackMenu() {
         } else {
             showMessage("USB connected");
         }
-        delay(2000);
         showPhysicalHackMenu();
     }));
 
@@ -847,7 +1104,6 @@ void showPhysicalHackMenu() {
         } else {
             showMessage("BLE connected");
         }
-        delay(2000);
         showPhysicalHackMenu();
     }));
 
@@ -865,7 +1121,6 @@ void showBlackHatHostList() {
 
     if (g_scannedHosts.empty()) {
         showMessage("No hosts found");
-        delay(2000);
         showBlackHatMenu();
         return;
     }
@@ -909,7 +1164,6 @@ void showBlackHatHostActions(size_t hostIndex) {
         // Port scan would be implemented here
         Serial.printf("[BlackHat] Port scanning %s\n", host.c_str());
         showMessage("Use Serial/WebUI");
-        delay(2000);
         showBlackHatHostActions(hostIndex);
     }));
 
@@ -918,7 +1172,6 @@ void showBlackHatHostActions(size_t hostIndex) {
         char info[128];
         snprintf(info, sizeof(info), "Host: %s\nStatus: Online", host.c_str());
         showMessage(info, 3000);
-        delay(3000);
         showBlackHatHostActions(hostIndex);
     }));
 
@@ -936,7 +1189,6 @@ void showPhysicalHackExploitList() {
 
     if (g_availableExploits.empty()) {
         showMessage("No exploits found");
-        delay(2000);
         showPhysicalHackMenu();
         return;
     }
@@ -975,7 +1227,6 @@ void showPhysicalHackExploitActions(size_t exploitIndex) {
                  exploit.description.c_str(),
                  "Target OS");
         showMessage(info, 3000);
-        delay(3000);
         showPhysicalHackExploitActions(exploitIndex);
     }));
 
@@ -998,7 +1249,6 @@ void showPhysicalHackExploitActions(size_t exploitIndex) {
         } else {
             showMessage("Exploit executed!");
         }
-        delay(2000);
         showPhysicalHackExploitActions(exploitIndex);
     }));
 
@@ -1026,6 +1276,48 @@ void showConfigMenu() {
         showMessage("Use Serial/WebUI");
     }));
 
+    // Input sessions start from the main menu so replays see the same screens
+    menu.addItem(Menu::MenuItem("Record Input", []() {
+        auto& recorder = InputRecorder::getInstance();
+        if (recorder.isRecording()) {
+            recorder.stopRecording();
+            auto err = recorder.saveSession("/input_session.txt");
+            showMessage(err.isError() ? "Save failed" : "Session saved");
+            recorder.printLatencyReport();
+            showConfigMenu();
+            return;
+        }
+
+        auto err = recorder.startRecording();
+        showMessage(err.isError() ? "Recorder busy" : "Recording (stop: Config)");
+        setupMainMenu();
+    }));
+
+    auto replay = [](float speed) {
+        auto& recorder = InputRecorder::getInstance();
+        auto err = recorder.loadSession("/input_session.txt");
+        if (err.isError()) {
+            showMessage("No recorded session");
+            showConfigMenu();
+            return;
+        }
+        setupMainMenu();
+        recorder.startReplay(speed);
+    };
+
+    menu.addItem(Menu::MenuItem("Replay Input", [replay]() { replay(1.0f); }));
+    menu.addItem(Menu::MenuItem("Replay Input x4", [replay]() { replay(4.0f); }));
+
+    menu.addItem(Menu::MenuItem("Input Latency", []() {
+        auto report = InputRecorder::getInstance().getLatencyReport();
+        InputRecorder::getInstance().printLatencyReport();
+        char msg[64];
+        snprintf(msg, sizeof(msg), "p50 %ums p90 %ums p99 %ums", report.p50Micros / 1000,
+                 report.p90Micros / 1000, report.p99Micros / 1000);
+        showMessage(msg, 3000);
+        showConfigMenu();
+    }));
+
     menu.addItem(Menu::MenuItem("Back", []() {
         setupMainMenu();
     }));
@@ -1053,13 +1345,11 @@ void showIRMenu() {
         } else {
             showMessage("IR initialized");
         }
-        delay(2000);
         showIRMenu();
     }));
 
     menu.addItem(Menu::MenuItem("Transmit Code", []() {
         showMessage("Use Serial/WebUI");
-        delay(2000);
         showIRMenu();
     }));
 
@@ -1077,7 +1367,6 @@ void showIRMenu() {
         } else {
             showMessage("Code received!");
         }
-        delay(2000);
         showIRMenu();
     }));
 
@@ -1092,7 +1381,6 @@ void showIRMenu() {
         if (err.isError()) {
             showMessage("TV-B-Gone failed");
         }
-        delay(2000);
         showIRMenu();
     }));
 
@@ -1108,7 +1396,6 @@ void showIRMenu() {
         } else {
             showMessage("Jammer started");
         }
-        delay(2000);
         showIRMenu();
     }));
 
@@ -1120,7 +1407,6 @@ void showIRMenu() {
         }
         g_irModule->stopJammer();
         showMessage("Jammer stopped");
-        delay(2000);
         showIRMenu();
     }));
 
@@ -1151,19 +1437,16 @@ void showBadUSBMenu() {
         } else {
             showMessage("BadUSB initialized");
         }
-        delay(2000);
         showBadUSBMenu();
     }));
 
     menu.addItem(Menu::MenuItem("Execute Script", []() {
         showMessage("Use Serial/WebUI");
-        delay(2000);
         showBadUSBMenu();
     }));
 
     menu.addItem(Menu::MenuItem("List Scripts", []() {
         showMessage("Use Serial/WebUI");
-        delay(2000);
         showBadUSBMenu();
     }));
 
@@ -1194,7 +1477,31 @@ void showGPSMenu() {
         } else {
             showMessage("GPS initialized");
         }
-        delay(2000);
+        showGPSMenu();
+    }));
+
+    menu.addItem(Menu::MenuItem("Position", []() {
+        if (!g_gpsModule || !g_gpsModule->isInitialized()) {
+            showMessage("GPS not initialized");
+            showGPSMenu();
+            return;
+        }
+        GPSModule::GPSPosition position;
+        NmeaParser::Stats stats;
+        g_gpsModule->getPosition(position);
+        g_gpsModule->getParserStats(stats);
+
+        char info[160];
+        if (position.valid) {
+            snprintf(info, sizeof(info), "%.6f\n%.6f\nAlt: %.1f m\nSats: %u HDOP: %.1f\n%.1f km/h",
+                     position.latitude, position.longitude, position.altitude,
+                     position.satellites, position.hdop, position.speedKmh);
+        } else {
+            snprintf(info, sizeof(info), "No fix\nSentences: %u\nBad checksum: %u",
+                     static_cast<unsigned>(stats.sentences),
+                     static_cast<unsigned>(stats.checksumErrors));
+        }
+        showMessage(info, 4000);
         showGPSMenu();
     }));
 
@@ -1205,7 +1512,6 @@ void showGPSMenu() {
             return;
         }
         showMessage("Tracking started");
-        delay(2000);
         showGPSMenu();
     }));
 
@@ -1216,7 +1522,6 @@ void showGPSMenu() {
             return;
         }
         showMessage("Wardriving started");
-        delay(2000);
         showGPSMenu();
     }));
 
@@ -1247,7 +1552,6 @@ void showFMMenu() {
         } else {
             showMessage("FM initialized");
         }
-        delay(2000);
         showFMMenu();
     }));
 
@@ -1258,7 +1562,6 @@ void showFMMenu() {
             return;
         }
         showMessage("Use Serial/WebUI");
-        delay(2000);
         showFMMenu();
     }));
 
@@ -1269,7 +1572,31 @@ void showFMMenu() {
             return;
         }
         showMessage("Scanning...");
-        delay(2000);
+        showFMMenu();
+    }));
+
+    menu.addItem(Menu::MenuItem("Spectrum", []() {
+        if (!g_fmModule || !g_fmModule->isInitialized()) {
+            showMessage("FM not initialized");
+            showFMMenu();
+            return;
+        }
+
+        // 76.0-108.0 MHz in 100 kHz steps, folded into 80 bins. Static so the
+        // analyzer task can never call into a destroyed chart.
+        static SpectrumChart chart(spectrumLayout(80, -100, -50));
+        static uint16_t lastFreq = 0;
+        chart.reset();
+        lastFreq = 0;
+        g_fmModule->startSpectrumAnalyzer([](uint16_t freq, int16_t rssi) {
+            if (freq < lastFreq) {
+                chart.endSweep();
+            }
+            lastFreq = freq;
+            chart.addSample(static_cast<uint32_t>(freq - 7600) * 80 / 3210, rssi);
+        });
+        runSpectrumView("FM spectrum", chart, nullptr);
+        g_fmModule->stopSpectrumAnalyzer();
         showFMMenu();
     }));
 
@@ -1300,19 +1627,16 @@ void showESPNOWMenu() {
         } else {
             showMessage("ESPNOW initialized");
         }
-        delay(2000);
         showESPNOWMenu();
     }));
 
     menu.addItem(Menu::MenuItem("Send File", []() {
         showMessage("Use Serial/WebUI");
-        delay(2000);
         showESPNOWMenu();
     }));
 
     menu.addItem(Menu::MenuItem("Receive File", []() {
         showMessage("Use Serial/WebUI");
-        delay(2000);
         showESPNOWMenu();
     }));
 
@@ -1343,7 +1667,6 @@ void showNRF24Menu() {
         } else {
             showMessage("NRF24 initialized");
         }
-        delay(2000);
         showNRF24Menu();
     }));
 
@@ -1354,7 +1677,6 @@ void showNRF24Menu() {
             return;
         }
         showMessage("Use Serial/WebUI");
-        delay(2000);
         showNRF24Menu();
     }));
 
@@ -1364,8 +1686,22 @@ void showNRF24Menu() {
             showNRF24Menu();
             return;
         }
-        showMessage("Use Serial/WebUI");
-        delay(2000);
+
+        // 126 channels, carrier-detect counts per sweep
+        static SpectrumChart chart(spectrumLayout(126, 0, 32));
+        chart.reset();
+        runSpectrumView("2.4GHz spectrum", chart, []() {
+            std::vector<NRF24Module::ChannelInfo> channels;
+            if (g_nrf24Module->scanSpectrum(channels).isError()) {
+                return;
+            }
+            int16_t levels[126];
+            uint16_t count = std::min<size_t>(channels.size(), 126);
+            for (uint16_t i = 0; i < count; ++i) {
+                levels[i] = channels[i].signal;
+            }
+            chart.addSweep(levels, count);
+        });
         showNRF24Menu();
     }));
 
@@ -1396,13 +1732,11 @@ void showEthernetMenu() {
         } else {
             showMessage("Ethernet initialized");
         }
-        delay(2000);
         showEthernetMenu();
     }));
 
     menu.addItem(Menu::MenuItem("ARP Spoof", []() {
         showMessage("Use Serial/WebUI");
-        delay(2000);
         showEthernetMenu();
     }));
 
@@ -1433,13 +1767,11 @@ void showInterpreterMenu() {
         } else {
             showMessage("Interpreter initialized");
         }
-        delay(2000);
         showInterpreterMenu();
     }));
 
     menu.addItem(Menu::MenuItem("Execute Script", []() {
         showMessage("Use Serial/WebUI");
-        delay(2000);
         showInterpreterMenu();
     }));
 
@@ -1470,7 +1802,6 @@ void showOthersMenu() {
         } else {
             showMessage("Others initialized");
         }
-        delay(2000);
         showOthersMenu();
     }));
 
@@ -1481,7 +1812,6 @@ void showOthersMenu() {
             return;
         }
         showMessage("Use Serial/WebUI");
-        delay(2000);
         showOthersMenu();
     }));
 
@@ -459,9 +459,9 @@ Core::Error BlackHatToolsModule::capturePackets(
     _capturedCount = 0;
     
     // Use WiFi module's sniffer
-    auto err = g_wifiModule->startSniffer([this](const uint8_t* data, size_t len) {
+    auto err = g_wifiModule->startSniffer([this](const WiFiModule::SnifferPacket& packet) {
         if (this->_captureCallback) {
-            this->_captureCallback(data, len);
+            this->_captureCallback(packet.data, packet.length);
             this->_capturedCount++;
             
             if (this->_captureCount > 0 && this->_capturedCount >= this->_captureCount) {
@@ -5,8 +5,8 @@
 #include <HardwareSerial.h>
 #include <LittleFS.h>
 #include <WiFi.h>
-#include <sstream>
-#include <iomanip>
+#include <esp_heap_caps.h>
+#include <cstring>
 
 namespace NightStrike {
 namespace Modules {
@@ -14,6 +14,64 @@ namespace Modules {
 // External WiFi module instance
 extern WiFiModule* g_wifiModule;
 
+static uint64_t packBssid(const uint8_t* mac) {
+    uint64_t key = 0;
+    for (int i = 0; i < 6; ++i) {
+        key = key << 8 | mac[i];
+    }
+    return key;
+}
+
+// Vendor prefixes cluster, so mix the whole address before masking
+static size_t hashBssid(const uint8_t* mac) {
+    uint64_t key = packBssid(mac);
+    key ^= key >> 29;
+    key *= 0xBF58476D1CE4E5B9ULL;
+    key ^= key >> 32;
+    return static_cast<size_t>(key);
+}
+
+static void writeWigleHeader(File& file) {
+    file.println("WigleWifi-1.4,appRelease=NightStrike,model=ESP32,release=1.0.0,device=ESP32,display=NightStrike,board=ESP32,brand=NightStrike");
+    file.println("MAC,SSID,AuthMode,FirstSeen,Channel,RSSI,CurrentLatitude,CurrentLongitude,AltitudeMeters,AccuracyMeters,Type");
+}
+
+static void writeWigleRow(File& file, const GPSModule::WiFiNetwork& net) {
+    // SSIDs are raw bytes: commas and quotes need quoting (worst case every character is a
+    // doubled quote), and control characters would end or corrupt the row, so they become '?'
+    char ssid[2 * sizeof(net.ssid) + 2];
+    bool quote = strpbrk(net.ssid, ",\"") != nullptr;
+    size_t length = 0;
+    if (quote) {
+        ssid[length++] = '"';
+    }
+    for (const char* c = net.ssid; *c; ++c) {
+        uint8_t byte = static_cast<uint8_t>(*c);
+        ssid[length++] = byte < 0x20 || byte == 0x7F ? '?' : *c;
+        if (*c == '"') {
+            ssid[length++] = '"';
+        }
+    }
+    if (quote) {
+        ssid[length++] = '"';
+    }
+    ssid[length] = '\0';
+
+    const uint8_t* mac = net.bssid;
+    file.printf("%02X:%02X:%02X:%02X:%02X:%02X,%s,%s,%04u-%02u-%02u %02u:%02u:%02u,%u,%d,"
+                "%.6f,%.6f,%.2f,0.0,WIFI\n",
+               mac[0], mac[1], mac[2], mac[3], mac[4], mac[5],
+               ssid,
+               net.encrypted ? "WPA2" : "Open",
+               net.firstYear, net.firstMonth, net.firstDay,
+               net.firstHour, net.firstMinute, net.firstSecond,
+               net.channel,
+               net.rssi,
+               net.latitude,
+               net.longitude,
+               net.altitude);
+}
+
 GPSModule::GPSModule() {
 }
 
@@ -22,13 +80,21 @@ Core::Error GPSModule::initialize() {
         return Core::Error(Core::ErrorCode::ALREADY_INITIALIZED);
     }
 
-    // Initialize GPS serial
-    // Note: TinyGPS++ library would be used here
-    // For now, create framework
-    
+    {
+        std::lock_guard<std::mutex> guard(_positionLock);
+        _parser.reset();
+        _lastPosition = GPSPosition();
+        _lastFixMs = 0;
+    }
+
+    // Parsed from the UART event task as bytes arrive, so a 10 Hz receiver at
+    // 115200 baud never has to wait for someone to call getPosition()
+    Serial2.setRxBufferSize(RX_BUFFER_SIZE);
+    Serial2.begin(_baud, SERIAL_8N1, _rxPin, _txPin);
+    Serial2.onReceive([this]() { parseGPSData(); });
+
     Serial.printf("[GPS] Module initialized (RX: %d, TX: %d, Baud: %lu)\n",
                  _rxPin, _txPin, _baud);
-    Serial.println("[GPS] Note: TinyGPS++ library required for full functionality");
     
     _initialized = true;
     return Core::Error(Core::ErrorCode::SUCCESS);
@@ -41,6 +107,9 @@ Core::Error GPSModule::shutdown() {
 
     stopTracking();
     stopWardriving();
+
+    Serial2.onReceive(nullptr);
+    Serial2.end();
     
     _initialized = false;
     return Core::Error(Core::ErrorCode::SUCCESS);
@@ -57,28 +126,19 @@ Core::Error GPSModule::getPosition(GPSPosition& position) {
         return Core::Error(Core::ErrorCode::NOT_INITIALIZED);
     }
 
-    // TODO: Parse GPS data from serial
-    // TinyGPS++ gps;
-    // while (Serial2.available() > 0) {
-    //     gps.encode(Serial2.read());
-    // }
-    // 
-    // if (gps.location.isValid()) {
-    //     position.latitude = gps.location.lat();
-    //     position.longitude = gps.location.lng();
-    //     position.altitude = gps.altitude.meters();
-    //     position.satellites = gps.satellites.value();
-    //     position.valid = true;
-    // } else {
-    //     position.valid = false;
-    // }
-
-    // For now, return last known position
+    std::lock_guard<std::mutex> guard(_positionLock);
     position = _lastPosition;
+    // A receiver that went quiet or lost its fix leaves a stale position behind
+    position.valid = _lastPosition.valid && millis() - _lastFixMs <= FIX_TIMEOUT_MS;
     
     return Core::Error(Core::ErrorCode::SUCCESS);
 }
 
+void GPSModule::getParserStats(NmeaParser::Stats& stats) {
+    std::lock_guard<std::mutex> guard(_positionLock);
+    stats = _parser.stats();
+}
+
 Core::Error GPSModule::startTracking() {
     if (!_initialized) {
         return Core::Error(Core::ErrorCode::NOT_INITIALIZED);
@@ -88,8 +148,13 @@ Core::Error GPSModule::startTracking() {
         return Core::Error(Core::ErrorCode::ALREADY_INITIALIZED);
     }
 
+    {
+        std::lock_guard<std::mutex> guard(_positionLock);
+        _trackPoints.clear();
+        _lastTrackMs = 0;
+        _trackIntervalMs = TRACK_INTERVAL_MS;
+    }
     _tracking = true;
-    _trackPoints.clear();
     
     Serial.println("[GPS] Tracking started");
     return Core::Error(Core::ErrorCode::SUCCESS);
@@ -101,6 +166,7 @@ Core::Error GPSModule::stopTracking() {
     }
 
     _tracking = false;
+    std::lock_guard<std::mutex> guard(_positionLock);
     Serial.printf("[GPS] Tracking stopped (%zu points recorded)\n", _trackPoints.size());
     return Core::Error(Core::ErrorCode::SUCCESS);
 }
@@ -115,6 +181,13 @@ Core::Error GPSModule::saveTrack(const std::string& filename) {
         return Core::Error(Core::ErrorCode::FILE_WRITE_ERROR);
     }
 
+    // Points keep arriving while tracking, so write from a copy
+    std::vector<GPSPosition> points;
+    {
+        std::lock_guard<std::mutex> guard(_positionLock);
+        points = _trackPoints;
+    }
+
     // Save track in GPX format
     file.println("<?xml version=\"1.0\" encoding=\"UTF-8\"?>");
     file.println("<gpx version=\"1.1\">");
@@ -122,7 +195,7 @@ Core::Error GPSModule::saveTrack(const std::string& filename) {
     file.println("<name>NightStrike Track</name>");
     file.println("<trkseg>");
     
-    for (const auto& point : _trackPoints) {
+    for (const auto& point : points) {
         if (point.valid) {
             file.printf("<trkpt lat=\"%.6f\" lon=\"%.6f\">", point.latitude, point.longitude);
             file.printf("<ele>%.2f</ele>", point.altitude);
@@ -139,7 +212,7 @@ Core::Error GPSModule::saveTrack(const std::string& filename) {
     return Core::Error(Core::ErrorCode::SUCCESS);
 }
 
-Core::Error GPSModule::startWardriving() {
+Core::Error GPSModule::startWardriving(const std::string& filename) {
     if (!_initialized) {
         return Core::Error(Core::ErrorCode::NOT_INITIALIZED);
     }
@@ -152,10 +225,49 @@ Core::Error GPSModule::startWardriving() {
         return Core::Error(Core::ErrorCode::ALREADY_INITIALIZED);
     }
 
+    if (!LittleFS.begin(true)) {
+        return Core::Error(Core::ErrorCode::STORAGE_NOT_MOUNTED);
+    }
+
+    {
+        std::lock_guard<std::mutex> guard(_networkLock);
+        // Allocated once and kept, so exportToWigle() still works after stopping
+        if (!_networks) {
+            _networks = static_cast<WiFiNetwork*>(
+                heap_caps_calloc(NETWORK_CAPACITY, sizeof(WiFiNetwork), MALLOC_CAP_SPIRAM));
+            _networkCapacity = NETWORK_CAPACITY;
+        }
+        if (!_networks) {
+            _networks = static_cast<WiFiNetwork*>(heap_caps_calloc(
+                NETWORK_CAPACITY_INTERNAL, sizeof(WiFiNetwork), MALLOC_CAP_8BIT));
+            _networkCapacity = NETWORK_CAPACITY_INTERNAL;
+        }
+        if (!_networks) {
+            _networkCapacity = 0;
+            return Core::Error(Core::ErrorCode::OUT_OF_MEMORY, "Wardriving table");
+        }
+        memset(_networks, 0, _networkCapacity * sizeof(WiFiNetwork));
+        _networkCount = 0;
+        _droppedNetworks = 0;
+        _wardrivePath = filename;
+    }
+
+    File file = LittleFS.open(filename.c_str(), "w");
+    if (!file) {
+        return Core::Error(Core::ErrorCode::FILE_WRITE_ERROR);
+    }
+    writeWigleHeader(file);
+    file.close();
+
     _wardriving = true;
-    _capturedNetworks.clear();
-    
-    Serial.println("[GPS] Wardriving started");
+    if (xTaskCreate(wardriveTask, "Wardrive", 4096, this, 1, &_scanTask) != pdPASS) {
+        _scanTask = nullptr;
+        _wardriving = false;
+        return Core::Error(Core::ErrorCode::OPERATION_FAILED, "Wardrive task");
+    }
+
+    Serial.printf("[GPS] Wardriving started (%s, %u slots)\n", filename.c_str(),
+                  static_cast<unsigned>(_networkCapacity));
     return Core::Error(Core::ErrorCode::SUCCESS);
 }
 
@@ -165,12 +277,27 @@ Core::Error GPSModule::stopWardriving() {
     }
 
     _wardriving = false;
-    Serial.printf("[GPS] Wardriving stopped (%zu networks captured)\n", _capturedNetworks.size());
+    // Cuts the wait short; a scan already running finishes first
+    xTaskNotifyGive(_scanTask);
+    while (_scanTask) {
+        vTaskDelay(pdMS_TO_TICKS(10));
+    }
+
+    std::lock_guard<std::mutex> guard(_networkLock);
+    Serial.printf("[GPS] Wardriving stopped (%zu networks captured, %u dropped)\n",
+                 _networkCount, static_cast<unsigned>(_droppedNetworks));
     return Core::Error(Core::ErrorCode::SUCCESS);
 }
 
 Core::Error GPSModule::getNetworks(std::vector<WiFiNetwork>& networks) {
-    networks = _capturedNetworks;
+    std::lock_guard<std::mutex> guard(_networkLock);
+    networks.clear();
+    networks.reserve(_networkCount);
+    for (size_t i = 0; i < _networkCapacity; ++i) {
+        if (_networks[i].sightings > 0) {
+            networks.push_back(_networks[i]);
+        }
+    }
     return Core::Error(Core::ErrorCode::SUCCESS);
 }
 
@@ -184,28 +311,23 @@ Core::Error GPSModule::exportToWigle(const std::string& filename) {
         return Core::Error(Core::ErrorCode::FILE_WRITE_ERROR);
     }
 
-    // Wigle CSV format header
-    file.println("WigleWifi-1.4,appRelease=NightStrike,model=ESP32,release=1.0.0,device=ESP32,display=NightStrike,board=ESP32,brand=NightStrike");
-    file.println("MAC,SSID,AuthMode,FirstSeen,Channel,RSSI,CurrentLatitude,CurrentLongitude,AltitudeMeters,AccuracyMeters,Type");
-
-    // Export networks
-    for (const auto& net : _capturedNetworks) {
-        file.printf("%s,%s,%s,%llu,%d,%d,%.6f,%.6f,%.2f,0.0,WIFI\n",
-                   net.bssid.c_str(),
-                   net.ssid.c_str(),
-                   net.encrypted ? "WPA2" : "Open",
-                   net.timestamp,
-                   net.channel,
-                   net.rssi,
-                   net.latitude,
-                   net.longitude,
-                   0.0);  // Altitude
+    // One row per network, at its strongest sighting; streamed from the table rather
+    // than copied, which holds off the scan task for the length of the write
+    writeWigleHeader(file);
+    size_t rows = 0;
+    {
+        std::lock_guard<std::mutex> guard(_networkLock);
+        for (size_t i = 0; i < _networkCapacity; ++i) {
+            if (_networks[i].sightings > 0) {
+                writeWigleRow(file, _networks[i]);
+                rows++;
+            }
+        }
     }
 
     file.close();
-    Serial.printf("[GPS] Exported %zu networks to Wigle format: %s\n",
-                 _capturedNetworks.size(), filename.c_str());
-    
+    Serial.printf("[GPS] Exported %zu networks to Wigle format: %s\n", rows, filename.c_str());
+
     return Core::Error(Core::ErrorCode::SUCCESS);
 }
 
@@ -223,26 +345,107 @@ Core::Error GPSModule::setSerialPort(uint8_t rxPin, uint8_t txPin, uint32_t baud
 }
 
 Core::Error GPSModule::parseGPSData() {
-    // TODO: Implement GPS parsing with TinyGPS++
-    // This would read from serial and parse NMEA sentences
-    
-    // For now, simulate
-    _lastPosition.valid = false;
+    char chunk[128];
+    size_t available;
+    while ((available = Serial2.available()) > 0) {
+        size_t length = Serial2.readBytes(chunk, available < sizeof(chunk) ? available
+                                                                          : sizeof(chunk));
+        if (length == 0) {
+            break;
+        }
+
+        std::lock_guard<std::mutex> guard(_positionLock);
+        uint32_t positions = _parser.stats().positions;
+        if (_parser.feed(chunk, length) == 0) {
+            continue;
+        }
+
+        // GSA / VTG alone keep a receiver that lost its position looking fresh
+        const NmeaParser::Fix& fix = _parser.fix();
+        _lastPosition.valid = fix.valid;
+        if (!fix.valid || _parser.stats().positions == positions) {
+            continue;
+        }
+
+        uint32_t now = millis();
+        _lastFixMs = now;
+        _lastPosition.latitude = fix.latitude;
+        _lastPosition.longitude = fix.longitude;
+        _lastPosition.altitude = fix.altitude;
+        _lastPosition.speedKmh = fix.speedKmh;
+        _lastPosition.course = fix.course;
+        _lastPosition.hdop = fix.hdop;
+        _lastPosition.satellites = fix.satellites;
+        _lastPosition.year = fix.year;
+        _lastPosition.month = fix.month;
+        _lastPosition.day = fix.day;
+        _lastPosition.hour = fix.hour;
+        _lastPosition.minute = fix.minute;
+        _lastPosition.second = fix.second;
+
+        // One track point per interval (a second at first), however fast the receiver reports
+        if (_tracking && (_lastTrackMs == 0 || now - _lastTrackMs >= _trackIntervalMs)) {
+            if (_trackPoints.size() >= MAX_TRACK_POINTS) {
+                // Full: keep every other point and record half as often, so the
+                // whole trip stays in the track at a coarser resolution
+                for (size_t i = 1; i < _trackPoints.size() / 2; ++i) {
+                    _trackPoints[i] = _trackPoints[2 * i];
+                }
+                _trackPoints.resize(_trackPoints.size() / 2);
+                _trackIntervalMs *= 2;
+            }
+            _trackPoints.push_back(_lastPosition);
+            _lastTrackMs = now;
+        }
+    }
     
     return Core::Error(Core::ErrorCode::SUCCESS);
 }
 
+void GPSModule::wardriveTask(void* param) {
+    auto* self = static_cast<GPSModule*>(param);
+
+    while (self->_wardriving) {
+        self->scanAndStoreNetworks();
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(SCAN_INTERVAL_MS));
+    }
+
+    self->_scanTask = nullptr;
+    vTaskDelete(nullptr);
+}
+
+// Caller holds _networkLock. Nothing is removed, so the first empty slot ends the probe;
+// filling stops at 3/4 so that probe stays short. nullptr when the table is full.
+GPSModule::WiFiNetwork* GPSModule::networkSlot(const uint8_t* bssid, bool& created) {
+    created = false;
+    size_t mask = _networkCapacity - 1;
+    for (size_t index = hashBssid(bssid) & mask;; index = (index + 1) & mask) {
+        WiFiNetwork& slot = _networks[index];
+        if (slot.sightings == 0) {
+            if (_networkCount >= _networkCapacity / 4 * 3) {
+                return nullptr;
+            }
+            memcpy(slot.bssid, bssid, sizeof(slot.bssid));
+            _networkCount++;
+            created = true;
+            return &slot;
+        }
+        if (memcmp(slot.bssid, bssid, sizeof(slot.bssid)) == 0) {
+            return &slot;
+        }
+    }
+}
+
 void GPSModule::scanAndStoreNetworks() {
     if (!g_wifiModule || !_wardriving) {
         return;
     }
 
-    // Get current position
+    // WiGLE wants a date, which only RMC carries; receivers send one every epoch
     GPSPosition position;
     getPosition(position);
-    
-    if (!position.valid) {
-        return;  // No GPS fix
+    if (!position.valid || position.year == 0) {
+        return;
     }
 
     // Scan WiFi networks
@@ -251,20 +454,62 @@ void GPSModule::scanAndStoreNetworks() {
         return;
     }
 
-    // Store networks with GPS coordinates
-    for (const auto& ap : aps) {
-        WiFiNetwork net;
-        net.ssid = ap.ssid;
-        net.bssid = ap.bssid;
-        net.rssi = ap.rssi;
-        net.channel = ap.channel;
-        net.encrypted = ap.encrypted;
-        net.latitude = position.latitude;
-        net.longitude = position.longitude;
-        net.timestamp = millis();
-        
-        _capturedNetworks.push_back(net);
+    // Merge into the table: one entry per BSSID, keeping where it was heard best
+    uint32_t now = millis();
+    std::vector<WiFiNetwork> discovered;
+    std::string path;
+    {
+        std::lock_guard<std::mutex> guard(_networkLock);
+        for (const auto& ap : aps) {
+            bool created;
+            WiFiNetwork* net = networkSlot(ap.bssidBytes, created);
+            if (!net) {
+                _droppedNetworks++;
+                continue;
+            }
+
+            // Hidden networks sometimes show their name later
+            if (net->ssid[0] == '\0') {
+                strncpy(net->ssid, ap.ssid.c_str(), sizeof(net->ssid) - 1);
+            }
+            net->lastSeenMs = now;
+            net->sightings++;
+            if (!created && ap.rssi <= net->rssi) {
+                continue;
+            }
+
+            net->rssi = ap.rssi;
+            net->channel = ap.channel;
+            net->latitude = position.latitude;
+            net->longitude = position.longitude;
+            net->altitude = static_cast<float>(position.altitude);
+            if (created) {
+                net->encrypted = ap.encrypted;
+                net->firstYear = position.year;
+                net->firstMonth = position.month;
+                net->firstDay = position.day;
+                net->firstHour = position.hour;
+                net->firstMinute = position.minute;
+                net->firstSecond = position.second;
+                discovered.push_back(*net);
+            }
+        }
+        path = _wardrivePath;
+    }
+
+    // Append only what is new, so the log survives a reset and never repeats a BSSID
+    if (discovered.empty() || path.empty()) {
+        return;
     }
+    File file = LittleFS.open(path.c_str(), "a");
+    if (!file) {
+        Serial.printf("[GPS] Cannot append to %s\n", path.c_str());
+        return;
+    }
+    for (const auto& net : discovered) {
+        writeWigleRow(file, net);
+    }
+    file.close();
 }
 
 } // namespace Modules
@@ -0,0 +1,318 @@
+#include "modules/nmea_parser.h"
+#include <cstring>
+
+namespace NightStrike {
+namespace Modules {
+
+static const float KNOTS_TO_KMH = 1.852f;
+
+static int hexValue(char c) {
+    if (c >= '0' && c <= '9') {
+        return c - '0';
+    }
+    if (c >= 'A' && c <= 'F') {
+        return c - 'A' + 10;
+    }
+    if (c >= 'a' && c <= 'f') {
+        return c - 'a' + 10;
+    }
+    return -1;
+}
+
+// Decimal number with optional sign and fraction; false for an empty or malformed field.
+// Integer and fraction digits are gathered as integers, so coordinates keep their precision.
+static bool parseNumber(const char* field, double& value) {
+    bool negative = *field == '-';
+    if (negative || *field == '+') {
+        field++;
+    }
+
+    uint64_t mantissa = 0;
+    uint64_t scale = 1;
+    bool digits = false;
+    bool fraction = false;
+    for (; *field; ++field) {
+        if (*field == '.' && !fraction) {
+            fraction = true;
+        } else if (*field >= '0' && *field <= '9' && mantissa < 100000000000000000ULL) {
+            mantissa = mantissa * 10 + (*field - '0');
+            if (fraction) {
+                scale *= 10;
+            }
+            digits = true;
+        } else {
+            return false;
+        }
+    }
+    if (!digits) {
+        return false;
+    }
+
+    value = static_cast<double>(mantissa) / static_cast<double>(scale);
+    if (negative) {
+        value = -value;
+    }
+    return true;
+}
+
+static bool parseNumber(const char* field, float& value) {
+    double number;
+    if (!parseNumber(field, number)) {
+        return false;
+    }
+    value = static_cast<float>(number);
+    return true;
+}
+
+static bool parseUnsigned(const char* field, uint32_t& value) {
+    double number;
+    if (!parseNumber(field, number) || number < 0) {
+        return false;
+    }
+    value = static_cast<uint32_t>(number);
+    return true;
+}
+
+// "ddmm.mmmm" / "dddmm.mmmm" plus hemisphere to signed degrees
+static bool parseCoordinate(const char* field, const char* hemisphere, double& degrees) {
+    double value;
+    if (!parseNumber(field, value) || value < 0) {
+        return false;
+    }
+
+    double whole = static_cast<double>(static_cast<uint32_t>(value / 100));
+    degrees = whole + (value - whole * 100) / 60.0;
+    if (*hemisphere == 'S' || *hemisphere == 'W') {
+        degrees = -degrees;
+    } else if (*hemisphere != 'N' && *hemisphere != 'E') {
+        return false;
+    }
+    return true;
+}
+
+// Two ASCII digits at field; false when either isn't one
+static bool twoDigits(const char* field, uint8_t& value) {
+    if (field[0] < '0' || field[0] > '9' || field[1] < '0' || field[1] > '9') {
+        return false;
+    }
+    value = (field[0] - '0') * 10 + (field[1] - '0');
+    return true;
+}
+
+void NmeaParser::reset() {
+    _state = State::IDLE;
+    _length = 0;
+    _fix = Fix();
+    _stats = Stats();
+}
+
+size_t NmeaParser::feed(const char* data, size_t length) {
+    size_t updates = 0;
+    for (size_t i = 0; i < length; ++i) {
+        if (feed(data[i])) {
+            updates++;
+        }
+    }
+    return updates;
+}
+
+bool NmeaParser::feed(char c) {
+    if (c == '$') {
+        // Also resynchronises on a sentence cut short by a dropped byte
+        _state = State::BODY;
+        _length = 0;
+        _checksum = 0;
+        return false;
+    }
+
+    switch (_state) {
+        case State::IDLE:
+            return false;
+
+        case State::BODY:
+            if (c == '*') {
+                _state = State::CHECKSUM1;
+            } else if (c == '\r' || c == '\n') {
+                _stats.checksumErrors++;  // No checksum: can't be trusted
+                _state = State::IDLE;
+            } else if (_length >= MAX_SENTENCE - 1) {
+                _stats.overflows++;
+                _state = State::IDLE;
+            } else {
+                _buffer[_length++] = c;
+                _checksum ^= static_cast<uint8_t>(c);
+            }
+            return false;
+
+        case State::CHECKSUM1: {
+            int digit = hexValue(c);
+            if (digit < 0) {
+                _stats.checksumErrors++;
+                _state = State::IDLE;
+                return false;
+            }
+            _expected = digit << 4;
+            _state = State::CHECKSUM2;
+            return false;
+        }
+
+        case State::CHECKSUM2: {
+            int digit = hexValue(c);
+            _state = State::IDLE;
+            if (digit < 0 || (_expected | digit) != _checksum) {
+                _stats.checksumErrors++;
+                return false;
+            }
+            _buffer[_length] = '\0';
+            _stats.sentences++;
+            return complete();
+        }
+    }
+    return false;
+}
+
+bool NmeaParser::complete() {
+    // Split in place: every ',' ends a field
+    char* fields[MAX_FIELDS];
+    uint8_t count = 0;
+    fields[count++] = _buffer;
+    for (size_t i = 0; i < _length && count < MAX_FIELDS; ++i) {
+        if (_buffer[i] == ',') {
+            _buffer[i] = '\0';
+            fields[count++] = &_buffer[i + 1];
+        }
+    }
+
+    // Talker ID first (GP, GN, ...), then the sentence type
+    size_t addressLength = strlen(fields[0]);
+    if (addressLength != 5) {
+        _stats.ignored++;
+        return false;
+    }
+    const char* type = fields[0] + 2;
+    if (strcmp(type, "GGA") == 0) {
+        parseGGA(fields, count);
+    } else if (strcmp(type, "RMC") == 0) {
+        parseRMC(fields, count);
+    } else if (strcmp(type, "GSA") == 0) {
+        parseGSA(fields, count);
+    } else if (strcmp(type, "VTG") == 0) {
+        parseVTG(fields, count);
+    } else {
+        _stats.ignored++;
+        return false;
+    }
+    return true;
+}
+
+// hhmmss or hhmmss.sss
+void NmeaParser::parseTime(const char* field) {
+    uint8_t hour;
+    uint8_t minute;
+    uint8_t second;
+    if (strlen(field) < 6 || !twoDigits(field, hour) || !twoDigits(field + 2, minute) ||
+        !twoDigits(field + 4, second)) {
+        return;
+    }
+
+    _fix.hour = hour;
+    _fix.minute = minute;
+    _fix.second = second;
+    _fix.millisecond = 0;
+    double fraction;
+    if (field[6] == '.' && parseNumber(field + 6, fraction)) {
+        _fix.millisecond = static_cast<uint16_t>(fraction * 1000 + 0.5);
+    }
+}
+
+// $xxGGA,time,lat,N,lon,E,quality,satellites,hdop,altitude,M,geoid,M,age,station
+void NmeaParser::parseGGA(char** fields, uint8_t count) {
+    if (count < 10) {
+        return;
+    }
+
+    parseTime(fields[1]);
+    uint32_t value;
+    _fix.quality = parseUnsigned(fields[6], value) ? value : 0;
+    if (parseUnsigned(fields[7], value)) {
+        _fix.satellites = value;
+    }
+    parseNumber(fields[8], _fix.hdop);
+
+    double latitude;
+    double longitude;
+    bool position = parseCoordinate(fields[2], fields[3], latitude) &&
+                    parseCoordinate(fields[4], fields[5], longitude);
+    if (position && _fix.quality > 0) {
+        _fix.latitude = latitude;
+        _fix.longitude = longitude;
+        parseNumber(fields[9], _fix.altitude);
+        _stats.positions++;
+    }
+    _fix.valid = position && _fix.quality > 0;
+}
+
+// $xxRMC,time,status,lat,N,lon,E,knots,course,ddmmyy,magvar,E[,mode[,navstatus]]
+void NmeaParser::parseRMC(char** fields, uint8_t count) {
+    if (count < 10) {
+        return;
+    }
+
+    parseTime(fields[1]);
+    const char* date = fields[9];
+    uint8_t day;
+    uint8_t month;
+    uint8_t year;
+    if (strlen(date) == 6 && twoDigits(date, day) && twoDigits(date + 2, month) &&
+        twoDigits(date + 4, year)) {
+        _fix.day = day;
+        _fix.month = month;
+        _fix.year = year < 80 ? 2000 + year : 1900 + year;
+    }
+
+    double latitude;
+    double longitude;
+    bool active = fields[2][0] == 'A';
+    if (active && parseCoordinate(fields[3], fields[4], latitude) &&
+        parseCoordinate(fields[5], fields[6], longitude)) {
+        _fix.latitude = latitude;
+        _fix.longitude = longitude;
+        float knots;
+        if (parseNumber(fields[7], knots)) {
+            _fix.speedKmh = knots * KNOTS_TO_KMH;
+        }
+        parseNumber(fields[8], _fix.course);
+        _fix.valid = true;
+        _stats.positions++;
+    } else {
+        _fix.valid = false;
+    }
+}
+
+// $xxGSA,mode,fix,prn x12,pdop,hdop,vdop[,system]
+void NmeaParser::parseGSA(char** fields, uint8_t count) {
+    if (count < 18) {
+        return;
+    }
+
+    uint32_t mode;
+    if (parseUnsigned(fields[2], mode) && mode >= 1 && mode <= 3) {
+        _fix.mode = mode;
+    }
+    parseNumber(fields[15], _fix.pdop);
+    parseNumber(fields[16], _fix.hdop);
+    parseNumber(fields[17], _fix.vdop);
+}
+
+// $xxVTG,course,T,magnetic,M,knots,N,kmh,K[,mode]
+void NmeaParser::parseVTG(char** fields, uint8_t count) {
+    if (count < 9 || fields[2][0] != 'T' || fields[8][0] != 'K') {
+        return;  // Pre-2.0 VTG without the unit fields
+    }
+
+    parseNumber(fields[1], _fix.course);
+    parseNumber(fields[7], _fix.speedKmh);
+}
+
+} // namespace Modules
+} // namespace NightStrike
@@ -100,6 +100,7 @@ Core::Error OthersModule::displayQRCode(const std::string& data) {
     
     // TODO: Render QR code on display
     // For now, just show text
+    display.beginFrame();
     display.clear();
     display.setTextColor(Core::Display::Color::Green(), Core::Display::Color::Black());
     display.setTextSize(1);
@@ -109,6 +110,7 @@ Core::Error OthersModule::displayQRCode(const std::string& data) {
     display.drawTextCentered(Core::Display::Point(display.getSize().width / 2,
                                                   display.getSize().height / 2 + 20),
                              data.c_str());
+    display.endFrame();
     
     Serial.printf("[Others] QR Code displayed: %s\n", data.c_str());
     return Core::Error(Core::ErrorCode::SUCCESS);
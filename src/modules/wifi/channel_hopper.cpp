@@ -0,0 +1,195 @@
+#include "modules/channel_hopper.h"
+#include <Arduino.h>
+#include <esp_wifi.h>
+#include <cstring>
+
+namespace NightStrike {
+namespace Modules {
+
+// FNV-1a over the address; 0 marks an empty slot, so it is never a hash
+static uint32_t hashMac(const uint8_t* mac) {
+    uint32_t hash = 2166136261u;
+    for (int i = 0; i < 6; ++i) {
+        hash = (hash ^ mac[i]) * 16777619u;
+    }
+    return hash ? hash : 1;
+}
+
+// Open addressing, linear probing; true when the hash was not there yet.
+// A full set stops counting rather than evicting.
+static bool insertHash(uint32_t* set, size_t size, uint32_t hash) {
+    size_t index = hash & (size - 1);
+    for (size_t probe = 0; probe < size; ++probe) {
+        uint32_t& slot = set[(index + probe) & (size - 1)];
+        if (slot == hash) {
+            return false;
+        }
+        if (slot == 0) {
+            slot = hash;
+            return true;
+        }
+    }
+    return false;
+}
+
+ChannelHopper& ChannelHopper::getInstance() {
+    static ChannelHopper instance;
+    return instance;
+}
+
+Core::Error ChannelHopper::configure(Mode mode, uint32_t dwellMs, uint32_t revisitMs) {
+    if (_task) {
+        return Core::Error(Core::ErrorCode::ALREADY_INITIALIZED);
+    }
+    if (dwellMs < MIN_DWELL_MS || dwellMs > MAX_DWELL_MS ||
+        revisitMs < CHANNEL_COUNT * MIN_DWELL_MS) {
+        return Core::Error(Core::ErrorCode::INVALID_PARAMETER);
+    }
+
+    _mode = mode;
+    _fixedDwellMs = dwellMs;
+    _revisitMs = revisitMs;
+    for (auto& channel : _channels) {
+        channel.frames = 0;
+        channel.bssidCount = 0;
+        memset(channel.bssids, 0, sizeof(channel.bssids));
+        channel.dwellMs = mode == Mode::FIXED ? dwellMs : MIN_DWELL_MS;
+        channel.visits = 0;
+        channel.rate = 0;
+        channel.lastVisitMs = 0;
+    }
+    memset(_devices, 0, sizeof(_devices));
+    _deviceCount = 0;
+    return Core::Error(Core::ErrorCode::SUCCESS);
+}
+
+Core::Error ChannelHopper::start() {
+    if (_task) {
+        return Core::Error(Core::ErrorCode::ALREADY_INITIALIZED);
+    }
+
+    _startMs = millis();
+    _stopping = false;
+    if (xTaskCreate(hopTask, "ChannelHop", 3072, this, 3, &_task) != pdPASS) {
+        _task = nullptr;
+        return Core::Error(Core::ErrorCode::OPERATION_FAILED, "Hopper task");
+    }
+
+    Serial.printf("[WiFi] Channel hopper started (%s)\n", modeName(_mode));
+    return Core::Error(Core::ErrorCode::SUCCESS);
+}
+
+Core::Error ChannelHopper::stop() {
+    if (!_task) {
+        return Core::Error(Core::ErrorCode::SUCCESS);
+    }
+
+    _stopping = true;
+    xTaskNotifyGive(_task);  // Cut the current dwell short
+    while (_task) {
+        vTaskDelay(pdMS_TO_TICKS(10));
+    }
+
+    Serial.printf("[WiFi] Channel hopper stopped: %u devices\n", _deviceCount.load());
+    return Core::Error(Core::ErrorCode::SUCCESS);
+}
+
+void ChannelHopper::onPacket(const WiFiModule::SnifferPacket& packet) {
+    if (packet.channel < 1 || packet.channel > CHANNEL_COUNT || packet.length < 16) {
+        return;
+    }
+
+    Channel& channel = _channels[packet.channel - 1];
+    channel.frames.fetch_add(1, std::memory_order_relaxed);
+
+    // Transmitter address of management and data frames; control frames may not carry one
+    uint8_t type = (packet.data[0] >> 2) & 0x3;
+    if (type != 0 && type != 2) {
+        return;
+    }
+    if (insertHash(_devices, DEVICE_SET_SIZE, hashMac(packet.data + 10))) {
+        _deviceCount.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // Beacons and probe responses name their BSSID in addr3
+    uint8_t subtype = (packet.data[0] >> 4) & 0xF;
+    if (type == 0 && (subtype == 8 || subtype == 5) && packet.length >= 22 &&
+        insertHash(channel.bssids, BSSID_SET_SIZE, hashMac(packet.data + 16))) {
+        channel.bssidCount.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void ChannelHopper::plan() {
+    uint32_t rates[CHANNEL_COUNT];
+    uint32_t bssids[CHANNEL_COUNT];
+    uint32_t dwellMs[CHANNEL_COUNT];
+    for (uint8_t i = 0; i < CHANNEL_COUNT; ++i) {
+        rates[i] = _channels[i].rate;
+        bssids[i] = _channels[i].bssidCount.load(std::memory_order_relaxed);
+    }
+    planDwell(rates, bssids, _revisitMs, dwellMs);
+    for (uint8_t i = 0; i < CHANNEL_COUNT; ++i) {
+        _channels[i].dwellMs = dwellMs[i];
+    }
+}
+
+void ChannelHopper::hopTask(void* param) {
+    auto* self = static_cast<ChannelHopper*>(param);
+
+    while (!self->_stopping) {
+        if (self->_mode == Mode::ADAPTIVE) {
+            self->plan();
+        }
+
+        for (uint8_t i = 0; i < CHANNEL_COUNT && !self->_stopping; ++i) {
+            Channel& channel = self->_channels[i];
+            esp_wifi_set_channel(i + 1, WIFI_SECOND_CHAN_NONE);
+
+            uint32_t before = channel.frames.load(std::memory_order_relaxed);
+            uint32_t entered = millis();
+            ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(channel.dwellMs));
+            uint32_t stayed = millis() - entered;
+
+            // Smoothed frame rate while listening here
+            if (stayed > 0) {
+                uint32_t frames = channel.frames.load(std::memory_order_relaxed) - before;
+                uint32_t rate = frames * 1000 / stayed;
+                channel.rate = channel.visits == 0 ? rate : (channel.rate * 3 + rate) / 4;
+            }
+            channel.visits++;
+            channel.lastVisitMs = millis();
+        }
+    }
+
+    self->_task = nullptr;
+    vTaskDelete(nullptr);
+}
+
+void ChannelHopper::getStats(Stats& stats) const {
+    stats.running = isRunning();
+    stats.mode = _mode;
+    stats.revisitMs = _mode == Mode::FIXED ? CHANNEL_COUNT * _fixedDwellMs : _revisitMs;
+    stats.elapsedMs = millis() - _startMs;
+    stats.devices = _deviceCount.load(std::memory_order_relaxed);
+    stats.devicesPerMinute =
+        stats.elapsedMs > 0 ? static_cast<uint64_t>(stats.devices) * 60000 / stats.elapsedMs : 0;
+
+    for (uint8_t i = 0; i < CHANNEL_COUNT; ++i) {
+        const Channel& channel = _channels[i];
+        ChannelStats& out = stats.channels[i];
+        out.channel = i + 1;
+        out.dwellMs = channel.dwellMs;
+        out.visits = channel.visits;
+        out.frames = channel.frames.load(std::memory_order_relaxed);
+        out.framesPerSecond = channel.rate;
+        out.bssids = channel.bssidCount.load(std::memory_order_relaxed);
+        out.lastVisitMs = channel.lastVisitMs;
+    }
+}
+
+const char* ChannelHopper::modeName(Mode mode) {
+    return mode == Mode::FIXED ? "fixed" : "adaptive";
+}
+
+} // namespace Modules
+} // namespace NightStrike
@@ -0,0 +1,28 @@
+#include "modules/channel_hopper.h"
+
+namespace NightStrike {
+namespace Modules {
+
+// Apart from channel_hopper.cpp, which needs the radio, so the native tests can simulate it
+void ChannelHopper::planDwell(const uint32_t rates[CHANNEL_COUNT],
+                              const uint32_t bssids[CHANNEL_COUNT], uint32_t revisitMs,
+                              uint32_t dwellMs[CHANNEL_COUNT]) {
+    // Half of the spare round goes by frame rate, half by BSSIDs seen
+    uint64_t totalRate = 0;
+    uint64_t totalBssids = 0;
+    for (uint8_t i = 0; i < CHANNEL_COUNT; ++i) {
+        totalRate += rates[i];
+        totalBssids += bssids[i];
+    }
+
+    uint32_t budget = revisitMs - CHANNEL_COUNT * MIN_DWELL_MS;
+    for (uint8_t i = 0; i < CHANNEL_COUNT; ++i) {
+        uint64_t share = totalRate ? rates[i] * 500ULL / totalRate : 500 / CHANNEL_COUNT;
+        share += totalBssids ? bssids[i] * 500ULL / totalBssids : 500 / CHANNEL_COUNT;
+        uint32_t dwell = MIN_DWELL_MS + static_cast<uint32_t>(budget * share / 1000);
+        dwellMs[i] = dwell > MAX_DWELL_MS ? MAX_DWELL_MS : dwell;
+    }
+}
+
+} // namespace Modules
+} // namespace NightStrike
@@ -0,0 +1,265 @@
+#include "modules/device_table.h"
+#include "utils/dot11.h"
+#include <Arduino.h>
+#include <esp_heap_caps.h>
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <utility>
+
+namespace NightStrike {
+namespace Modules {
+
+static const uint8_t FLAG_AP = 1 << 0;
+static const uint8_t FLAG_ASSOCIATED = 1 << 1;
+
+static uint64_t packMac(const uint8_t* mac) {
+    uint64_t key = 0;
+    for (int i = 0; i < 6; ++i) {
+        key = key << 8 | mac[i];
+    }
+    return key;
+}
+
+static void unpackMac(uint64_t key, uint8_t* mac) {
+    for (int i = 5; i >= 0; --i) {
+        mac[i] = key & 0xFF;
+        key >>= 8;
+    }
+}
+
+// Vendor prefixes cluster, so mix the whole address before masking
+static size_t hashKey(uint64_t key) {
+    key ^= key >> 29;
+    key *= 0xBF58476D1CE4E5B9ULL;
+    key ^= key >> 32;
+    return static_cast<size_t>(key);
+}
+
+static bool isUnicast(const uint8_t* mac) {
+    return !(mac[0] & 0x01);
+}
+
+DeviceTable& DeviceTable::getInstance() {
+    static DeviceTable instance;
+    return instance;
+}
+
+Core::Error DeviceTable::begin() {
+    std::lock_guard<std::mutex> guard(_lock);
+    if (_slots) {
+        return Core::Error(Core::ErrorCode::SUCCESS);
+    }
+
+    // Allocated once and kept, like the capture ring: the WiFi task may still be in update()
+    _slots = static_cast<Slot*>(heap_caps_calloc(CAPACITY, sizeof(Slot), MALLOC_CAP_SPIRAM));
+    _capacity = CAPACITY;
+    if (!_slots) {
+        _slots = static_cast<Slot*>(
+            heap_caps_calloc(CAPACITY_INTERNAL, sizeof(Slot), MALLOC_CAP_8BIT));
+        _capacity = CAPACITY_INTERNAL;
+    }
+    if (!_slots) {
+        _capacity = 0;
+        return Core::Error(Core::ErrorCode::OUT_OF_MEMORY, "Device table");
+    }
+
+    Serial.printf("[WiFi] Device table: %u slots\n", static_cast<unsigned>(_capacity));
+    return Core::Error(Core::ErrorCode::SUCCESS);
+}
+
+void DeviceTable::clear() {
+    std::lock_guard<std::mutex> guard(_lock);
+    if (_slots) {
+        memset(_slots, 0, _capacity * sizeof(Slot));
+    }
+    _count = 0;
+    _evictions = 0;
+    _skipped = 0;
+}
+
+DeviceTable::Slot* DeviceTable::slotFor(uint64_t key) {
+    size_t mask = _capacity - 1;
+    size_t home = hashKey(key) & mask;
+    Slot* oldest = nullptr;
+    for (uint8_t probe = 0; probe < MAX_PROBE; ++probe) {
+        Slot& slot = _slots[(home + probe) & mask];
+        if (slot.key == key) {
+            return &slot;
+        }
+        if (slot.key == 0) {
+            // Nothing is ever removed, so the first hole ends the chain
+            memset(&slot, 0, sizeof(slot));
+            slot.key = key;
+            _count.fetch_add(1, std::memory_order_relaxed);
+            return &slot;
+        }
+        if (!oldest || slot.lastSeenMs < oldest->lastSeenMs) {
+            oldest = &slot;
+        }
+    }
+
+    // Window full: the stalest device in it makes room
+    memset(oldest, 0, sizeof(*oldest));
+    oldest->key = key;
+    _evictions.fetch_add(1, std::memory_order_relaxed);
+    return oldest;
+}
+
+const DeviceTable::Slot* DeviceTable::lookup(uint64_t key) const {
+    size_t mask = _capacity - 1;
+    size_t home = hashKey(key) & mask;
+    for (uint8_t probe = 0; probe < MAX_PROBE; ++probe) {
+        const Slot& slot = _slots[(home + probe) & mask];
+        if (slot.key == key) {
+            return &slot;
+        }
+        if (slot.key == 0) {
+            break;
+        }
+    }
+    return nullptr;
+}
+
+void DeviceTable::update(const WiFiModule::SnifferPacket& packet) {
+    if (!_slots) {
+        return;
+    }
+
+    auto frame = Utils::Dot11::Frame::fromSniffer(packet.data, packet.length);
+    uint8_t type = frame.type();
+    const uint8_t* transmitter = frame.addr2();
+    if ((type != Utils::Dot11::TYPE_MGMT && type != Utils::Dot11::TYPE_DATA) || !transmitter ||
+        !isUnicast(transmitter)) {
+        return;
+    }
+
+    // Beacons, probe responses and data from the DS are sent by the AP itself
+    bool fromAP = type == Utils::Dot11::TYPE_MGMT
+                      ? frame.subtype() == Utils::Dot11::BEACON ||
+                            frame.subtype() == Utils::Dot11::PROBE_RESP
+                      : (frame.flags() & 0x3) == 0x2;
+    const uint8_t* bssid = frame.bssid();
+    bool hasBssid = bssid && isUnicast(bssid) && (fromAP || memcmp(bssid, transmitter, 6) != 0);
+
+    std::unique_lock<std::mutex> guard(_lock, std::try_to_lock);
+    if (!guard.owns_lock()) {
+        _skipped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    uint32_t now = millis();
+    Slot& slot = *slotFor(packMac(transmitter));
+    if (slot.frames == 0) {
+        slot.firstSeenMs = now;
+        slot.rssiMin = packet.rssi;
+        slot.rssiMax = packet.rssi;
+        slot.rssiAvg16 = packet.rssi * 16;
+    } else {
+        slot.rssiMin = packet.rssi < slot.rssiMin ? packet.rssi : slot.rssiMin;
+        slot.rssiMax = packet.rssi > slot.rssiMax ? packet.rssi : slot.rssiMax;
+        slot.rssiAvg16 += (packet.rssi * 16 - slot.rssiAvg16) / 8;
+    }
+    slot.lastSeenMs = now;
+    slot.channel = packet.channel;
+    slot.frames++;
+    if (type == Utils::Dot11::TYPE_MGMT) {
+        slot.mgmtFrames++;
+    } else {
+        slot.dataFrames++;
+    }
+
+    if (fromAP) {
+        slot.flags |= FLAG_AP;
+    }
+    if (hasBssid) {
+        memcpy(slot.bssid, bssid, 6);
+        slot.flags |= FLAG_ASSOCIATED;
+    }
+}
+
+void DeviceTable::toDevice(const Slot& slot, Device& device) {
+    unpackMac(slot.key, device.mac);
+    memcpy(device.bssid, slot.bssid, 6);
+    device.isAP = slot.flags & FLAG_AP;
+    device.associated = slot.flags & FLAG_ASSOCIATED;
+    device.channel = slot.channel;
+    device.rssiMin = slot.rssiMin;
+    device.rssiMax = slot.rssiMax;
+    device.rssiAvg = static_cast<int8_t>(slot.rssiAvg16 / 16);
+    device.firstSeenMs = slot.firstSeenMs;
+    device.lastSeenMs = slot.lastSeenMs;
+    device.frames = slot.frames;
+    device.mgmtFrames = slot.mgmtFrames;
+    device.dataFrames = slot.dataFrames;
+}
+
+bool DeviceTable::find(const uint8_t* mac, Device& device) const {
+    std::lock_guard<std::mutex> guard(_lock);
+    if (!_slots) {
+        return false;
+    }
+
+    const Slot* slot = lookup(packMac(mac));
+    if (!slot) {
+        return false;
+    }
+    toDevice(*slot, device);
+    return true;
+}
+
+// Newest `limit` matches through a small min-heap, so the table is walked once
+// and nothing proportional to its size is allocated
+template <typename Predicate>
+void DeviceTable::collect(std::vector<Device>& devices, size_t limit, Predicate predicate) const {
+    typedef std::pair<uint32_t, size_t> Candidate;  // lastSeenMs, slot index
+    std::vector<Candidate> newest;
+    newest.reserve(limit);
+    devices.clear();
+
+    std::lock_guard<std::mutex> guard(_lock);
+    if (!_slots || limit == 0) {
+        return;
+    }
+
+    for (size_t i = 0; i < _capacity; ++i) {
+        const Slot& slot = _slots[i];
+        if (slot.key == 0 || !predicate(slot)) {
+            continue;
+        }
+        if (newest.size() < limit) {
+            newest.emplace_back(slot.lastSeenMs, i);
+            std::push_heap(newest.begin(), newest.end(), std::greater<Candidate>());
+        } else if (slot.lastSeenMs > newest.front().first) {
+            std::pop_heap(newest.begin(), newest.end(), std::greater<Candidate>());
+            newest.back() = Candidate(slot.lastSeenMs, i);
+            std::push_heap(newest.begin(), newest.end(), std::greater<Candidate>());
+        }
+    }
+
+    std::sort(newest.begin(), newest.end(), std::greater<Candidate>());
+    devices.resize(newest.size());
+    for (size_t i = 0; i < newest.size(); ++i) {
+        toDevice(_slots[newest[i].second], devices[i]);
+    }
+}
+
+void DeviceTable::recent(std::vector<Device>& devices, size_t limit, Filter filter) const {
+    collect(devices, limit, [filter](const Slot& slot) {
+        if (filter == Filter::ALL) {
+            return true;
+        }
+        return (filter == Filter::APS) == ((slot.flags & FLAG_AP) != 0);
+    });
+}
+
+void DeviceTable::clientsOf(const uint8_t* bssid, std::vector<Device>& devices,
+                            size_t limit) const {
+    collect(devices, limit, [bssid](const Slot& slot) {
+        return !(slot.flags & FLAG_AP) && (slot.flags & FLAG_ASSOCIATED) &&
+               memcmp(slot.bssid, bssid, 6) == 0;
+    });
+}
+
+} // namespace Modules
+} // namespace NightStrike
@@ -0,0 +1,382 @@
+#include "modules/frame_filter.h"
+#include "utils/dot11.h"
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <strings.h>
+
+namespace NightStrike {
+namespace Modules {
+
+// Same bit layout as WiFiModule::SNIFF_* (frame type 0-2, plus misc)
+static const uint8_t MASK_MGMT = 1 << 0;
+static const uint8_t MASK_DATA = 1 << 2;
+static const uint8_t MASK_ANY = 0x0F;
+
+struct SubtypeName {
+    const char* name;
+    uint8_t type;
+    uint8_t subtype;
+};
+
+static const SubtypeName SUBTYPES[] = {
+    {"assoc-req", 0, 0},     {"assoc-resp", 0, 1},   {"reassoc-req", 0, 2},
+    {"reassoc-resp", 0, 3},  {"probe-req", 0, 4},    {"probe-resp", 0, 5},
+    {"beacon", 0, 8},        {"disassoc", 0, 10},    {"auth", 0, 11},
+    {"deauth", 0, 12},       {"action", 0, 13},      {"rts", 1, 11},
+    {"cts", 1, 12},          {"ack", 1, 13},         {"data", 2, 0},
+    {"null", 2, 4},          {"qos-data", 2, 8},
+};
+
+// Recursive descent over the expression, emitting postfix code
+class FrameFilterCompiler {
+public:
+    FrameFilterCompiler(const char* source, FrameFilter& filter)
+        : _source(source), _next(source), _filter(filter) {}
+
+    Core::Error run(size_t* errorAt) {
+        _filter._length = 0;
+        advance();
+
+        uint8_t mask = 0;
+        if (!parseOr(mask) || (!_error && _tokenLength != 0)) {
+            if (errorAt) {
+                *errorAt = _token - _source;
+            }
+            _filter._length = 0;
+            return Core::Error(Core::ErrorCode::INVALID_PARAMETER,
+                               _error ? _error : "Unexpected token");
+        }
+
+        // e.g. "type mgt and type data": subscribing would leave the driver filter empty
+        if (mask == 0) {
+            if (errorAt) {
+                *errorAt = 0;
+            }
+            _filter._length = 0;
+            return Core::Error(Core::ErrorCode::INVALID_PARAMETER, "Filter can never match");
+        }
+
+        _filter._typeMask = mask;
+        _filter._source = _source;
+        return Core::Error(Core::ErrorCode::SUCCESS);
+    }
+
+private:
+    const char* _source;
+    const char* _next;
+    const char* _token = nullptr;
+    size_t _tokenLength = 0;
+    const char* _error = nullptr;
+    FrameFilter& _filter;
+    uint8_t _depth = 0;    // Evaluation stack depth at this point of the program
+    uint8_t _nesting = 0;  // Open ( and not; bounds the recursion, i.e. the caller's stack
+
+    void advance() {
+        while (*_next == ' ' || *_next == '\t') {
+            _next++;
+        }
+        _token = _next;
+        if (*_next == '(' || *_next == ')' || *_next == '!') {
+            _next++;
+        } else if ((_next[0] == '&' && _next[1] == '&') || (_next[0] == '|' && _next[1] == '|')) {
+            _next += 2;
+        } else {
+            while (*_next && *_next != ' ' && *_next != '\t' && *_next != '(' && *_next != ')') {
+                _next++;
+            }
+        }
+        _tokenLength = _next - _token;
+    }
+
+    bool is(const char* word) const {
+        return strlen(word) == _tokenLength && strncasecmp(_token, word, _tokenLength) == 0;
+    }
+
+    bool fail(const char* message) {
+        if (!_error) {
+            _error = message;
+        }
+        return false;
+    }
+
+    bool emit(uint8_t byte) {
+        if (_filter._length >= FrameFilter::MAX_CODE) {
+            return fail("Filter too long");
+        }
+        _filter._code[_filter._length++] = byte;
+        return true;
+    }
+
+    bool enter() {
+        if (++_nesting > FrameFilter::MAX_DEPTH) {
+            return fail("Filter nested too deeply");
+        }
+        return true;
+    }
+
+    bool push() {
+        if (++_depth > FrameFilter::MAX_DEPTH) {
+            return fail("Filter nested too deeply");
+        }
+        return true;
+    }
+
+    bool parseOr(uint8_t& mask) {
+        if (!parseAnd(mask)) {
+            return false;
+        }
+        while (is("or") || is("||")) {
+            advance();
+            uint8_t right = 0;
+            if (!parseAnd(right) || !emit(FrameFilter::OP_OR)) {
+                return false;
+            }
+            _depth--;
+            mask |= right;
+        }
+        return true;
+    }
+
+    bool parseAnd(uint8_t& mask) {
+        if (!parseNot(mask)) {
+            return false;
+        }
+        while (is("and") || is("&&")) {
+            advance();
+            uint8_t right = 0;
+            if (!parseNot(right) || !emit(FrameFilter::OP_AND)) {
+                return false;
+            }
+            _depth--;
+            mask &= right;
+        }
+        return true;
+    }
+
+    bool parseNot(uint8_t& mask) {
+        if (is("not") || is("!")) {
+            advance();
+            if (!enter() || !parseNot(mask) || !emit(FrameFilter::OP_NOT)) {
+                return false;
+            }
+            _nesting--;
+            mask = MASK_ANY;  // Can't narrow the driver filter through a negation
+            return true;
+        }
+
+        if (is("(")) {
+            advance();
+            if (!enter() || !parseOr(mask)) {
+                return false;
+            }
+            if (!is(")")) {
+                return fail("Missing )");
+            }
+            _nesting--;
+            advance();
+            return true;
+        }
+
+        return parsePrimitive(mask);
+    }
+
+    bool parsePrimitive(uint8_t& mask) {
+        if (_tokenLength == 0) {
+            return fail("Expression expected");
+        }
+
+        if (is("type")) {
+            advance();
+            uint8_t type;
+            if (is("mgt") || is("mgmt") || is("management")) {
+                type = 0;
+            } else if (is("ctl") || is("ctrl") || is("control")) {
+                type = 1;
+            } else if (is("data")) {
+                type = 2;
+            } else {
+                return fail("Unknown frame type");
+            }
+            advance();
+            mask = 1 << type;
+            return emit(FrameFilter::OP_TYPE) && emit(type) && push();
+        }
+
+        if (is("subtype")) {
+            advance();
+            for (const auto& entry : SUBTYPES) {
+                if (is(entry.name)) {
+                    advance();
+                    mask = 1 << entry.type;
+                    return emit(FrameFilter::OP_SUBTYPE) &&
+                           emit(entry.type << 4 | entry.subtype) && push();
+                }
+            }
+            return fail("Unknown subtype");
+        }
+
+        int which = -1;
+        if (is("bssid")) {
+            which = 0;
+        } else if (is("addr1") || is("dst")) {
+            which = 1;
+        } else if (is("addr2") || is("src")) {
+            which = 2;
+        } else if (is("addr3")) {
+            which = 3;
+        }
+        if (which >= 0) {
+            advance();
+            uint8_t mac[6];
+            uint8_t length = 0;
+            if (!parseMac(mac, length)) {
+                return fail("Bad MAC address");
+            }
+            advance();
+            // Only management and data frames carry a BSSID
+            mask = which == 0 ? MASK_MGMT | MASK_DATA : MASK_ANY;
+            if (!emit(FrameFilter::OP_ADDR) || !emit(which) || !emit(length)) {
+                return false;
+            }
+            for (uint8_t i = 0; i < length; ++i) {
+                if (!emit(mac[i])) {
+                    return false;
+                }
+            }
+            return push();
+        }
+
+        if (is("rssi")) {
+            advance();
+            FrameFilter::Op op;
+            if (is(">")) {
+                op = FrameFilter::OP_RSSI_GT;
+            } else if (is("<")) {
+                op = FrameFilter::OP_RSSI_LT;
+            } else {
+                return fail("rssi needs > or <");
+            }
+            advance();
+            char* end;
+            long value = strtol(_token, &end, 10);
+            if (_tokenLength == 0 || end != _token + _tokenLength || value < -128 || value > 127) {
+                return fail("Bad RSSI value");
+            }
+            advance();
+            mask = MASK_ANY;
+            return emit(op) && emit(static_cast<uint8_t>(static_cast<int8_t>(value))) && push();
+        }
+
+        return fail("Unknown keyword");
+    }
+
+    // "aa:bb:cc:dd:ee:ff" or a prefix ending in '*'
+    bool parseMac(uint8_t* mac, uint8_t& length) const {
+        const char* p = _token;
+        const char* end = _token + _tokenLength;
+        length = 0;
+        while (p < end) {
+            if (*p == '*') {
+                return p + 1 == end;
+            }
+            if (length == 6 || end - p < 2 || !isxdigit(static_cast<unsigned char>(p[0])) ||
+                !isxdigit(static_cast<unsigned char>(p[1]))) {
+                return false;
+            }
+            char hex[3] = {p[0], p[1], '\0'};
+            mac[length++] = static_cast<uint8_t>(strtoul(hex, nullptr, 16));
+            p += 2;
+            if (p < end && (*p == ':' || *p == '-')) {
+                p++;
+            }
+        }
+        return length == 6;
+    }
+};
+
+Core::Error FrameFilter::compile(const char* source, FrameFilter& filter, size_t* errorAt) {
+    if (!source) {
+        return Core::Error(Core::ErrorCode::INVALID_PARAMETER);
+    }
+    if (strlen(source) > MAX_SOURCE) {
+        if (errorAt) {
+            *errorAt = MAX_SOURCE;
+        }
+        return Core::Error(Core::ErrorCode::INVALID_PARAMETER, "Filter too long");
+    }
+    return FrameFilterCompiler(source, filter).run(errorAt);
+}
+
+// Address the primitive refers to, or nullptr when the frame doesn't carry it
+static const uint8_t* address(const Utils::Dot11::Frame& frame, uint8_t which) {
+    switch (which) {
+        case 0: return frame.bssid();
+        case 1: return frame.addr1();
+        case 2: return frame.addr2();
+        default: return frame.addr3();
+    }
+}
+
+bool FrameFilter::matches(const uint8_t* frame, size_t length, int8_t rssi) const {
+    if (_length == 0) {
+        return true;
+    }
+    if (length < 2) {
+        return false;
+    }
+
+    // Results live in a bit stack: the newest on bit 0
+    uint8_t fc = frame[0];
+    uint8_t type = (fc >> 2) & 0x3;
+    uint8_t typeSubtype = type << 4 | fc >> 4;
+    uint32_t stack = 0;
+    for (uint8_t pc = 0; pc < _length;) {
+        bool value;
+        switch (_code[pc]) {
+            case OP_TYPE:
+                value = type == _code[pc + 1];
+                pc += 2;
+                break;
+            case OP_SUBTYPE:
+                value = typeSubtype == _code[pc + 1];
+                pc += 2;
+                break;
+            case OP_ADDR: {
+                const uint8_t* addr = address(Utils::Dot11::Frame(frame, length), _code[pc + 1]);
+                uint8_t n = _code[pc + 2];
+                value = addr && memcmp(addr, &_code[pc + 3], n) == 0;
+                pc += 3 + n;
+                break;
+            }
+            case OP_RSSI_GT:
+                value = rssi > static_cast<int8_t>(_code[pc + 1]);
+                pc += 2;
+                break;
+            case OP_RSSI_LT:
+                value = rssi < static_cast<int8_t>(_code[pc + 1]);
+                pc += 2;
+                break;
+            case OP_AND:
+                value = (stack & 3) == 3;
+                stack >>= 2;
+                pc++;
+                break;
+            case OP_OR:
+                value = (stack & 3) != 0;
+                stack >>= 2;
+                pc++;
+                break;
+            default:  // OP_NOT
+                value = !(stack & 1);
+                stack >>= 1;
+                pc++;
+                break;
+        }
+        stack = stack << 1 | value;
+    }
+    return stack & 1;
+}
+
+} // namespace Modules
+} // namespace NightStrike
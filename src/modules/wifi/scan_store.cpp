@@ -0,0 +1,454 @@
+#include "modules/scan_store.h"
+#ifndef UNIT_TEST
+#include "core/web_ui.h"
+#endif
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace NightStrike {
+namespace Modules {
+
+ScanStore& ScanStore::getInstance() {
+    static ScanStore instance;
+    return instance;
+}
+
+void ScanStore::replace(const std::vector<WiFiModule::ScanRecord>& records) {
+    uint32_t generation;
+    size_t count;
+    {
+        std::lock_guard<std::mutex> guard(_lock);
+        _rssi.clear();
+        _channel.clear();
+        _authMode.clear();
+        _bssid.clear();
+        _ssid.clear();
+        _seen.clear();
+        _surveyed = 0;
+        resetPool();
+        for (const auto& record : records) {
+            append(record);
+        }
+        _seen.assign(_rssi.size(), 0);
+        generation = bump();
+        count = _rssi.size();
+    }
+    announce(generation, count, 0, false);
+}
+
+void ScanStore::merge(uint8_t channel, const std::vector<WiFiModule::ScanRecord>& records,
+                      bool scanning) {
+    uint32_t generation;
+    size_t count;
+    {
+        std::lock_guard<std::mutex> guard(_lock);
+        if (_pool.empty()) {
+            resetPool();
+        }
+
+        // Rows keep their index for the whole survey, so cursors stay valid:
+        // known APs are updated in place, new ones go at the end
+        for (const auto& record : records) {
+            // Neighbouring APs are overheard on this channel too; they belong to their own
+            if (record.channel != channel) {
+                continue;
+            }
+            size_t row = rowOf(record.bssid);
+            if (row == _rssi.size()) {
+                append(record);
+                continue;
+            }
+            _rssi[row] = record.rssi;
+            _channel[row] = record.channel;
+            _authMode[row] = record.authMode;
+            _ssid[row] = intern(record.ssid);
+            _seen[row] = 1;
+        }
+        _surveyed |= 1u << channel;
+
+        if (_generation == 0) {
+            bump();  // First results: there is something to page through now
+        }
+        if (!scanning) {
+            endSurvey();
+        }
+        generation = _generation;
+        count = _rssi.size();
+    }
+    announce(generation, count, channel, scanning);
+}
+
+size_t ScanStore::rowOf(const uint8_t* bssid) const {
+    for (size_t row = 0; row < _rssi.size(); ++row) {
+        if (memcmp(&_bssid[row * 6], bssid, 6) == 0) {
+            return row;
+        }
+    }
+    return _rssi.size();
+}
+
+void ScanStore::endSurvey() {
+    // APs not heard on a channel the survey covered are gone; removing them
+    // moves rows, so only then is there a new generation
+    size_t kept = 0;
+    for (size_t i = 0; i < _rssi.size(); ++i) {
+        if (!_seen[i] && (_surveyed & (1u << _channel[i]))) {
+            continue;
+        }
+        _rssi[kept] = _rssi[i];
+        _channel[kept] = _channel[i];
+        _authMode[kept] = _authMode[i];
+        memmove(&_bssid[kept * 6], &_bssid[i * 6], 6);
+        _ssid[kept] = _ssid[i];
+        kept++;
+    }
+    bool removed = kept != _rssi.size();
+    _rssi.resize(kept);
+    _channel.resize(kept);
+    _authMode.resize(kept);
+    _bssid.resize(kept * 6);
+    _ssid.resize(kept);
+    _seen.assign(kept, 0);
+    _surveyed = 0;
+
+    // Names of APs gone from the survey stay in the pool until it gets lopsided
+    if (_poolOffsets.size() > 2 * _ssid.size() + 32) {
+        compactPool();
+    }
+    if (removed) {
+        bump();
+    }
+}
+
+void ScanStore::append(const WiFiModule::ScanRecord& record) {
+    _rssi.push_back(record.rssi);
+    _channel.push_back(record.channel);
+    _authMode.push_back(record.authMode);
+    _bssid.insert(_bssid.end(), record.bssid, record.bssid + 6);
+    _ssid.push_back(intern(record.ssid));
+    _seen.push_back(1);
+}
+
+static uint32_t hashName(const char* name) {
+    uint32_t hash = 2166136261u;
+    while (*name) {
+        hash = (hash ^ static_cast<uint8_t>(*name++)) * 16777619u;
+    }
+    return hash;
+}
+
+uint16_t ScanStore::intern(const char* ssid) {
+    if (!*ssid) {
+        return 0;  // Hidden
+    }
+
+    size_t mask = _poolIndex.size() - 1;
+    size_t slot = hashName(ssid) & mask;
+    while (_poolIndex[slot] != 0) {
+        uint16_t id = _poolIndex[slot] - 1;
+        if (strcmp(&_pool[_poolOffsets[id]], ssid) == 0) {
+            return id;
+        }
+        slot = (slot + 1) & mask;
+    }
+
+    if (_poolOffsets.size() >= UINT16_MAX) {
+        return 0;  // Pool full: shown as hidden rather than dropped
+    }
+    uint16_t id = static_cast<uint16_t>(_poolOffsets.size());
+    _poolOffsets.push_back(_pool.size());
+    _pool.insert(_pool.end(), ssid, ssid + strlen(ssid) + 1);
+    _poolIndex[slot] = id + 1;
+
+    // Keep the index at most half full
+    if (_poolOffsets.size() * 2 > _poolIndex.size()) {
+        _poolIndex.assign(_poolIndex.size() * 2, 0);
+        rebuildPoolIndex();
+    }
+    return id;
+}
+
+void ScanStore::resetPool() {
+    _pool.assign(1, '\0');
+    _poolOffsets.assign(1, 0);
+    _poolIndex.assign(64, 0);
+}
+
+void ScanStore::rebuildPoolIndex() {
+    size_t mask = _poolIndex.size() - 1;
+    for (uint16_t id = 1; id < _poolOffsets.size(); ++id) {
+        size_t slot = hashName(&_pool[_poolOffsets[id]]) & mask;
+        while (_poolIndex[slot] != 0) {
+            slot = (slot + 1) & mask;
+        }
+        _poolIndex[slot] = id + 1;
+    }
+}
+
+void ScanStore::compactPool() {
+    std::vector<char> pool;
+    std::vector<uint32_t> offsets;
+    pool.swap(_pool);
+    offsets.swap(_poolOffsets);
+    resetPool();
+    for (auto& id : _ssid) {
+        id = intern(&pool[offsets[id]]);
+    }
+    _pool.shrink_to_fit();
+}
+
+uint32_t ScanStore::bump() {
+    // Never 0: that means "current" in queries
+    _generation = _generation == UINT32_MAX ? 1 : _generation + 1;
+    return _generation;
+}
+
+void ScanStore::keep(uint8_t channel, bool scanning) {
+    uint32_t generation;
+    size_t count;
+    {
+        std::lock_guard<std::mutex> guard(_lock);
+        if (!scanning) {
+            endSurvey();
+        }
+        generation = _generation;
+        count = _rssi.size();
+    }
+    announce(generation, count, channel, scanning);
+}
+
+void ScanStore::announce(uint32_t generation, size_t count, uint8_t channel, bool scanning) {
+#ifndef UNIT_TEST
+    // Clients fetch the pages they show; the event only says there is something new
+    auto& webUI = Core::WebUI::getInstance();
+    if (webUI.hasSubscribers()) {
+        char event[96];
+        snprintf(event, sizeof(event),
+                 "{\"scanning\":%s,\"channel\":%u,\"generation\":%u,\"count\":%u}",
+                 scanning ? "true" : "false", channel, generation,
+                 static_cast<unsigned>(count));
+        webUI.publish("scan", event);
+    }
+#endif
+}
+
+uint32_t ScanStore::generation() const {
+    std::lock_guard<std::mutex> guard(_lock);
+    return _generation;
+}
+
+size_t ScanStore::size() const {
+    std::lock_guard<std::mutex> guard(_lock);
+    return _rssi.size();
+}
+
+bool ScanStore::find(const uint8_t* bssid, WiFiModule::ScanRecord& record) const {
+    std::lock_guard<std::mutex> guard(_lock);
+    size_t index = rowOf(bssid);
+    if (index == _rssi.size()) {
+        return false;
+    }
+
+    memcpy(record.bssid, &_bssid[index * 6], 6);
+    strncpy(record.ssid, ssidAt(index), sizeof(record.ssid) - 1);
+    record.ssid[sizeof(record.ssid) - 1] = '\0';
+    record.rssi = _rssi[index];
+    record.channel = _channel[index];
+    record.authMode = _authMode[index];
+    return true;
+}
+
+size_t ScanStore::Reader::memoryUsage() const {
+    const ScanStore& store = _store;
+    return store._rssi.capacity() + store._channel.capacity() + store._authMode.capacity() +
+           store._bssid.capacity() + store._ssid.capacity() * sizeof(uint16_t) +
+           store._seen.capacity() +
+           store._pool.capacity() + store._poolOffsets.capacity() * sizeof(uint32_t) +
+           store._poolIndex.capacity() * sizeof(uint16_t);
+}
+
+ScanStore::Entry ScanStore::Reader::entry(size_t index) const {
+    Entry entry;
+    entry.ssid = _store.ssidAt(index);
+    entry.bssid = &_store._bssid[index * 6];
+    entry.rssi = _store._rssi[index];
+    entry.channel = _store._channel[index];
+    entry.authMode = _store._authMode[index];
+    return entry;
+}
+
+static bool containsNoCase(const char* haystack, const std::string& needle) {
+    const char* end = haystack + strlen(haystack);
+    auto it = std::search(haystack, end, needle.begin(), needle.end(), [](char a, char b) {
+        return tolower(static_cast<unsigned char>(a)) == tolower(static_cast<unsigned char>(b));
+    });
+    return it != end;
+}
+
+bool ScanStore::matches(size_t row, const Query& query) const {
+    if (query.channel != 0 && _channel[row] != query.channel) {
+        return false;
+    }
+
+    uint8_t authMode = _authMode[row];
+    switch (query.security) {
+        case Security::ANY:
+            break;
+        case Security::OPEN:
+            if (authMode != WIFI_AUTH_OPEN) {
+                return false;
+            }
+            break;
+        case Security::ENCRYPTED:
+            if (authMode == WIFI_AUTH_OPEN) {
+                return false;
+            }
+            break;
+        case Security::WEP:
+            if (authMode != WIFI_AUTH_WEP) {
+                return false;
+            }
+            break;
+        case Security::WPA:
+            if (authMode != WIFI_AUTH_WPA_PSK && authMode != WIFI_AUTH_WPA_WPA2_PSK) {
+                return false;
+            }
+            break;
+        case Security::WPA2:
+            if (authMode != WIFI_AUTH_WPA2_PSK && authMode != WIFI_AUTH_WPA_WPA2_PSK &&
+                authMode != WIFI_AUTH_WPA2_ENTERPRISE && authMode != WIFI_AUTH_WPA2_WPA3_PSK) {
+                return false;
+            }
+            break;
+        case Security::WPA3:
+            if (authMode != WIFI_AUTH_WPA3_PSK && authMode != WIFI_AUTH_WPA2_WPA3_PSK) {
+                return false;
+            }
+            break;
+    }
+
+    return query.ssid.empty() || containsNoCase(ssidAt(row), query.ssid);
+}
+
+Core::Error ScanStore::Reader::query(const Query& query, uint32_t generation, size_t offset,
+                                     size_t limit, Page& page) const {
+    const ScanStore& store = _store;
+    if (generation != 0 && generation != store._generation) {
+        return Core::Error(Core::ErrorCode::INVALID_PARAMETER, "Stale cursor");
+    }
+
+    // Sort indices, reading only the column the sort needs; ties fall back
+    // to scan order, so every page of one generation sees the same ordering
+    std::vector<uint16_t> order;
+    order.reserve(store._rssi.size());
+    for (size_t i = 0; i < store._rssi.size(); ++i) {
+        if (store.matches(i, query)) {
+            order.push_back(static_cast<uint16_t>(i));
+        }
+    }
+
+    auto key = [&](uint16_t a, uint16_t b) -> int {
+        switch (query.sort) {
+            case SortKey::CHANNEL: return store._channel[a] - store._channel[b];
+            case SortKey::SSID: return strcasecmp(store.ssidAt(a), store.ssidAt(b));
+            default: return store._rssi[a] - store._rssi[b];
+        }
+    };
+    std::sort(order.begin(), order.end(), [&](uint16_t a, uint16_t b) {
+        int cmp = key(a, b);
+        if (cmp == 0) {
+            return a < b;
+        }
+        return query.descending ? cmp > 0 : cmp < 0;
+    });
+
+    page.generation = store._generation;
+    page.offset = offset;
+    page.total = order.size();
+    page.items.clear();
+
+    if (limit > MAX_PAGE_SIZE) {
+        limit = MAX_PAGE_SIZE;
+    }
+    if (offset < order.size()) {
+        size_t end = order.size() - offset < limit ? order.size() : offset + limit;
+        page.items.assign(order.begin() + offset, order.begin() + end);
+    }
+    return Core::Error(Core::ErrorCode::SUCCESS);
+}
+
+bool ScanStore::parseCursor(const char* cursor, uint32_t& generation, size_t& offset) {
+    char* rest;
+    unsigned long gen = strtoul(cursor, &rest, 10);
+    if (rest == cursor || *rest != '.' || gen == 0) {
+        return false;
+    }
+
+    const char* start = rest + 1;
+    unsigned long off = strtoul(start, &rest, 10);
+    if (rest == start || *rest) {
+        return false;
+    }
+
+    generation = gen;
+    offset = off;
+    return true;
+}
+
+std::string ScanStore::makeCursor(uint32_t generation, size_t offset) {
+    char cursor[24];
+    snprintf(cursor, sizeof(cursor), "%u.%u", generation, static_cast<unsigned>(offset));
+    return cursor;
+}
+
+bool ScanStore::parseSortKey(const std::string& name, SortKey& key) {
+    if (name == "rssi") {
+        key = SortKey::RSSI;
+    } else if (name == "channel") {
+        key = SortKey::CHANNEL;
+    } else if (name == "ssid") {
+        key = SortKey::SSID;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+bool ScanStore::parseSecurity(const std::string& name, Security& security) {
+    static const struct {
+        const char* name;
+        Security security;
+    } NAMES[] = {
+        {"any", Security::ANY},   {"open", Security::OPEN}, {"encrypted", Security::ENCRYPTED},
+        {"wep", Security::WEP},   {"wpa", Security::WPA},   {"wpa2", Security::WPA2},
+        {"wpa3", Security::WPA3},
+    };
+
+    for (const auto& entry : NAMES) {
+        if (name == entry.name) {
+            security = entry.security;
+            return true;
+        }
+    }
+    return false;
+}
+
+const char* ScanStore::securityName(uint8_t authMode) {
+    switch (authMode) {
+        case WIFI_AUTH_OPEN: return "open";
+        case WIFI_AUTH_WEP: return "wep";
+        case WIFI_AUTH_WPA_PSK: return "wpa";
+        case WIFI_AUTH_WPA2_PSK: return "wpa2";
+        case WIFI_AUTH_WPA_WPA2_PSK: return "wpa/wpa2";
+        case WIFI_AUTH_WPA2_ENTERPRISE: return "wpa2-enterprise";
+        case WIFI_AUTH_WPA3_PSK: return "wpa3";
+        case WIFI_AUTH_WPA2_WPA3_PSK: return "wpa2/wpa3";
+        default: return "other";
+    }
+}
+
+} // namespace Modules
+} // namespace NightStrike
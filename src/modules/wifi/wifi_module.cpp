@@ -1,15 +1,358 @@
 #include "modules/wifi_module.h"
+#include "modules/scan_store.h"
+#include "modules/pcap_writer.h"
+#include "modules/channel_hopper.h"
+#include "modules/device_table.h"
+#include "core/web_ui.h"
+#include "core/metrics.h"
+#include "utils/string_utils.h"
+#include "utils/dot11.h"
 #include <esp_wifi.h>
 #include <esp_err.h>
 #include <WiFiClient.h>
 #include <WiFiServer.h>
 #include <Arduino.h>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
 
 namespace NightStrike {
 namespace Modules {
 
 WiFiModule* g_wifiModuleInstance = nullptr;
 
+// Who owns the radio's scanner; both scan paths claim it, so they never overlap
+enum ScanOwner : uint8_t {
+    SCAN_IDLE,
+    SCAN_BLOCKING,  // scanNetworks()
+    SCAN_ASYNC      // startAsyncScan() until its last channel is in
+};
+static std::atomic<uint8_t> s_scanOwner(SCAN_IDLE);
+static std::atomic<uint16_t> s_scanRemaining(0);  // Channels still to scan
+static std::atomic<uint8_t> s_scanChannel(0);     // Being scanned now
+
+// Sniffer counters, registered in initialize() before the callback can be installed
+static Core::Metrics::Counter* s_sniffedFrames = nullptr;
+static Core::Metrics::Counter* s_unconsumedFrames = nullptr;
+
+// SCAN_IDLE claimed for owner; otherwise current holds whoever has it
+static bool claimScanner(uint8_t owner, uint8_t& current) {
+    current = SCAN_IDLE;
+    return s_scanOwner.compare_exchange_strong(current, owner);
+}
+
+// Start the lowest channel left in the mask; false when none is left or it failed
+bool WiFiModule::scanNextChannel() {
+    uint16_t remaining = s_scanRemaining;
+    while (remaining) {
+        uint8_t channel = __builtin_ctz(remaining);
+        remaining &= remaining - 1;
+        s_scanRemaining = remaining;
+        s_scanChannel = channel;
+
+        // An async start answers WIFI_SCAN_RUNNING, but so does a scan that was
+        // already running; only take it as ours when the scanner was idle before
+        if (WiFi.scanComplete() == WIFI_SCAN_RUNNING) {
+            return false;
+        }
+        int16_t result = WiFi.scanNetworks(true, true, false, SCAN_DWELL_MS, channel);
+        if (result == WIFI_SCAN_RUNNING || result >= 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Arduino event task, after the core has fetched the records
+void WiFiModule::onScanDone(arduino_event_id_t, arduino_event_info_t) {
+    if (s_scanOwner != SCAN_ASYNC) {
+        return;  // A blocking scanNetworks() collects and deletes its own results
+    }
+
+    int16_t count = WiFi.scanComplete();
+    std::vector<ScanRecord> records;
+    if (count > 0) {
+        collectScanResults(count, records);
+    }
+    WiFi.scanDelete();
+
+    // Next channel first, so the radio is busy while the store is updated
+    uint8_t channel = s_scanChannel;
+    bool more = scanNextChannel();
+    if (!more) {
+        s_scanOwner = SCAN_IDLE;
+    }
+    if (count < 0) {
+        // Not "no APs": keep what the channel had and carry on with the rest
+        Serial.printf("[WiFi] Scan of channel %u failed\n", channel);
+        ScanStore::getInstance().keep(channel, more);
+        return;
+    }
+    ScanStore::getInstance().merge(channel, records, more);
+}
+
+// "1,6,11" to a channel mask; 0 when any entry is not a channel
+static uint16_t parseChannelList(const std::string& list) {
+    uint16_t channels = 0;
+    const char* p = list.c_str();
+    while (*p) {
+        char* end;
+        unsigned long channel = strtoul(p, &end, 10);
+        if (end == p || channel < 1 || channel > 13 || (*end && *end != ',')) {
+            return 0;
+        }
+        channels |= 1 << channel;
+        p = *end ? end + 1 : end;
+    }
+    return channels;
+}
+
+static bool parseScanQuery(const Core::WebUI::Request& request, ScanStore::Query& query) {
+    if (request.hasParam("sort") &&
+        !ScanStore::parseSortKey(request.param("sort").str(), query.sort)) {
+        return false;
+    }
+    // Strongest signal first by default, otherwise ascending
+    query.descending = query.sort == ScanStore::SortKey::RSSI;
+    if (request.hasParam("order")) {
+        Core::WebUI::StringRef order = request.param("order");
+        if (order != "asc" && order != "desc") {
+            return false;
+        }
+        query.descending = order == "desc";
+    }
+
+    if (request.hasParam("channel")) {
+        int channel = atoi(request.param("channel").str().c_str());
+        if (channel < 1 || channel > 14) {
+            return false;
+        }
+        query.channel = channel;
+    }
+    if (request.hasParam("security") &&
+        !ScanStore::parseSecurity(request.param("security").str(), query.security)) {
+        return false;
+    }
+    query.ssid = request.param("ssid").str();
+    return true;
+}
+
+static void sendHopperStats(Core::WebUI::Response& response) {
+    ChannelHopper::Stats stats;
+    ChannelHopper::getInstance().getStats(stats);
+
+    Utils::JsonWriter& json = response.json();
+    json.beginObject()
+        .field("running", stats.running)
+        .field("mode", ChannelHopper::modeName(stats.mode))
+        .field("revisitMs", stats.revisitMs)
+        .field("elapsedMs", stats.elapsedMs)
+        .field("devices", stats.devices)
+        .field("devicesPerMinute", stats.devicesPerMinute)
+        .key("channels")
+        .beginArray();
+    for (const auto& channel : stats.channels) {
+        json.beginObject()
+            .field("channel", channel.channel)
+            .field("dwellMs", channel.dwellMs)
+            .field("visits", channel.visits)
+            .field("frames", channel.frames)
+            .field("framesPerSecond", channel.framesPerSecond)
+            .field("bssids", channel.bssids)
+            .field("lastVisitMs", channel.lastVisitMs)
+            .endObject();
+    }
+    json.endArray().endObject();
+}
+
+// GET /api/wifi/devices?type=ap|client&bssid=aa:bb:cc:dd:ee:ff&limit=N
+// Most recently seen first; bssid lists the stations associated with that AP.
+static void sendDevices(const WiFiModule& wifi, const Core::WebUI::Request& request,
+                        Core::WebUI::Response& response) {
+    static const size_t DEFAULT_LIMIT = 50;
+    static const size_t MAX_LIMIT = 200;
+
+    size_t limit = DEFAULT_LIMIT;
+    if (request.hasParam("limit")) {
+        limit = strtoul(request.param("limit").str().c_str(), nullptr, 10);
+        if (limit == 0 || limit > MAX_LIMIT) {
+            limit = MAX_LIMIT;
+        }
+    }
+
+    auto& table = DeviceTable::getInstance();
+    std::vector<DeviceTable::Device> devices;
+    if (request.hasParam("bssid")) {
+        uint8_t bssid[6];
+        if (!Utils::stringToMAC(request.param("bssid").str(), bssid)) {
+            response.setStatus(400);
+            response.send("{\"error\":\"Invalid bssid\"}");
+            return;
+        }
+        table.clientsOf(bssid, devices, limit);
+    } else {
+        DeviceTable::Filter filter = DeviceTable::Filter::ALL;
+        if (request.param("type") == "ap") {
+            filter = DeviceTable::Filter::APS;
+        } else if (request.param("type") == "client") {
+            filter = DeviceTable::Filter::CLIENTS;
+        }
+        table.recent(devices, limit, filter);
+    }
+
+    uint32_t now = millis();
+    Utils::JsonWriter& json = response.json();
+    json.beginObject()
+        .field("running", wifi.isInventoryRunning())
+        .field("count", table.size())
+        .field("capacity", table.capacity())
+        .field("evictions", table.evictions())
+        .field("skipped", table.skipped())
+        .key("devices")
+        .beginArray();
+    for (const auto& device : devices) {
+        json.beginObject()
+            .field("mac", Utils::macToString(device.mac))
+            .field("type", device.isAP ? "ap" : "client")
+            .field("bssid", device.associated ? Utils::macToString(device.bssid) : "")
+            .field("channel", device.channel)
+            .field("rssiMin", device.rssiMin)
+            .field("rssiAvg", device.rssiAvg)
+            .field("rssiMax", device.rssiMax)
+            .field("firstSeenAgoMs", now - device.firstSeenMs)
+            .field("lastSeenAgoMs", now - device.lastSeenMs)
+            .field("frames", device.frames)
+            .field("mgmtFrames", device.mgmtFrames)
+            .field("dataFrames", device.dataFrames)
+            .endObject();
+    }
+    json.endArray().endObject();
+}
+
+// Per-subscriber filter savings. The saving is an estimate: rejected frames times the
+// average callback cost, less the cycles the filter itself took.
+static void sendSnifferStats(const WiFiModule& wifi, Core::WebUI::Response& response) {
+    std::vector<WiFiModule::SnifferStats> stats;
+    wifi.getSnifferStats(stats);
+
+    Utils::JsonWriter& json = response.json();
+    json.beginObject().key("subscribers").beginArray();
+    for (const auto& entry : stats) {
+        uint32_t seen = entry.delivered + entry.filtered;
+        uint64_t callbackAverage = entry.delivered ? entry.callbackCycles / entry.delivered : 0;
+        int64_t cyclesSaved = static_cast<int64_t>(entry.filtered * callbackAverage) -
+                              static_cast<int64_t>(entry.filterCycles);
+        json.beginObject()
+            .field("id", entry.id)
+            .field("filter", entry.filter)
+            .field("types", entry.types)
+            .field("delivered", entry.delivered)
+            .field("filtered", entry.filtered)
+            .field("dropEarlyPercent", seen ? entry.filtered * 100.0 / seen : 0.0)
+            .field("filterCycles", entry.filterCycles)
+            .field("callbackCycles", entry.callbackCycles)
+            .field("cyclesSaved", cyclesSaved)
+            .endObject();
+    }
+    json.endArray().endObject();
+}
+
+// A blocking scan holding the radio is a conflict, anything else a failure
+static void sendScanError(const Core::Error& err, Core::WebUI::Response& response) {
+    bool busy = err.code == Core::ErrorCode::ALREADY_INITIALIZED;
+    response.setStatus(busy ? 409 : 500);
+    response.send(busy ? "{\"error\":\"Scan in progress\"}" : "{\"error\":\"Scan failed\"}");
+}
+
+// GET /api/wifi/scan?sort=rssi|channel|ssid&order=asc|desc&channel=N
+//     &security=open|encrypted|wep|wpa|wpa2|wpa3&ssid=text&limit=N&cursor=G.O
+// The cursor only carries the position: send the same filter and sort with it.
+static void sendScanPage(WiFiModule& wifi, const Core::WebUI::Request& request,
+                         Core::WebUI::Response& response) {
+    auto& store = ScanStore::getInstance();
+    if (store.generation() == 0) {
+        // Nothing scanned yet: start the first survey and let the client come back
+        Core::Error err = wifi.startAsyncScan();
+        if (err.isError()) {
+            sendScanError(err, response);
+            return;
+        }
+        response.setStatus(202);
+        response.send("{\"scanning\":true,\"count\":0}");
+        return;
+    }
+
+    ScanStore::Query query;
+    if (!parseScanQuery(request, query)) {
+        response.setStatus(400);
+        response.send("{\"error\":\"Invalid query\"}");
+        return;
+    }
+
+    uint32_t generation = 0;
+    size_t offset = 0;
+    if (request.hasParam("cursor") &&
+        !ScanStore::parseCursor(request.param("cursor").str().c_str(), generation, offset)) {
+        response.setStatus(400);
+        response.send("{\"error\":\"Invalid cursor\"}");
+        return;
+    }
+
+    size_t limit = ScanStore::DEFAULT_PAGE_SIZE;
+    if (request.hasParam("limit")) {
+        limit = strtoul(request.param("limit").str().c_str(), nullptr, 10);
+        if (limit == 0) {
+            limit = ScanStore::DEFAULT_PAGE_SIZE;
+        }
+    }
+
+    // Rows are read in place, under the store's lock, while the page is written out
+    ScanStore::Reader reader = store.read();
+    ScanStore::Page page;
+    if (reader.query(query, generation, offset, limit, page).isError()) {
+        // A newer scan replaced the one being paged; the client starts over
+        response.setStatus(410);
+        response.json()
+            .beginObject()
+            .field("error", "Stale cursor")
+            .field("generation", reader.generation())
+            .endObject();
+        return;
+    }
+
+    Utils::JsonWriter& json = response.json();
+    json.beginObject()
+        .field("scanning", wifi.isScanning())
+        .field("generation", page.generation)
+        .field("count", page.total)
+        .field("offset", page.offset)
+        .field("memory", reader.memoryUsage())
+        .key("networks")
+        .beginArray();
+    for (uint16_t index : page.items) {
+        ScanStore::Entry ap = reader.entry(index);
+        char bssid[18];
+        snprintf(bssid, sizeof(bssid), "%02X:%02X:%02X:%02X:%02X:%02X", ap.bssid[0],
+                 ap.bssid[1], ap.bssid[2], ap.bssid[3], ap.bssid[4], ap.bssid[5]);
+        json.beginObject()
+            .field("ssid", ap.ssid)
+            .field("bssid", bssid)
+            .field("rssi", ap.rssi)
+            .field("channel", ap.channel)
+            .field("encrypted", ap.authMode != WIFI_AUTH_OPEN)
+            .field("security", ScanStore::securityName(ap.authMode))
+            .endObject();
+    }
+    json.endArray().key("next");
+    if (page.hasMore()) {
+        json.value(ScanStore::makeCursor(page.generation, page.offset + page.items.size()));
+    } else {
+        json.null();
+    }
+    json.endObject();
+}
+
 WiFiModule::WiFiModule() {
     g_wifiModuleInstance = this;
 }
@@ -35,6 +378,20 @@ Core::Error WiFiModule::initialize() {
     };
     esp_wifi_set_country(&country);
 
+    // Here rather than on first use, so the WiFi task never takes the registry lock
+    auto& metrics = Core::Metrics::getInstance();
+    s_sniffedFrames = &metrics.counter("nightstrike_wifi_frames_sniffed_total",
+                                       "Frames received in promiscuous mode");
+    // Not a loss: frames nobody subscribed to or every filter rejected
+    s_unconsumedFrames = &metrics.counter("nightstrike_wifi_frames_unconsumed_total",
+                                          "Sniffed frames no subscriber took");
+
+    if (!_webRoutesAdded) {
+        WiFi.onEvent(onScanDone, ARDUINO_EVENT_WIFI_SCAN_DONE);
+        registerWebRoutes();
+        _webRoutesAdded = true;
+    }
+
     Serial.println("[WiFi] Module initialized");
     _initialized = true;
     return Core::Error(Core::ErrorCode::SUCCESS);
@@ -47,6 +404,9 @@ Core::Error WiFiModule::shutdown() {
 
     stopResponder();
     stopKarmaAttack();
+    stopChannelHopper();
+    stopInventory();
+    stopCapture();
     stopSniffer();
     stopEvilPortal();
     stopAP();
@@ -62,38 +422,273 @@ Core::Error WiFiModule::shutdown() {
     return Core::Error(Core::ErrorCode::SUCCESS);
 }
 
+void WiFiModule::registerWebRoutes() {
+    using Core::WebUI;
+    auto& webUI = WebUI::getInstance();
+
+    webUI.addRoute(WebUI::Method::GET, "/api/wifi/scan",
+                   [this](const WebUI::Request& request, WebUI::Response& response) {
+                       sendScanPage(*this, request, response);
+                   });
+
+    // Start a new survey, optionally of some channels only (channels=1,6,11); clients
+    // hear about each channel through the "scan" event or by polling
+    webUI.addRoute(WebUI::Method::POST, "/api/wifi/scan",
+                   [this](const WebUI::Request& request, WebUI::Response& response) {
+                       uint16_t channels = ALL_CHANNELS;
+                       if (request.hasParam("channels")) {
+                           channels = parseChannelList(request.param("channels").str());
+                       }
+                       if (channels == 0) {
+                           response.setStatus(400);
+                           response.send("{\"error\":\"Invalid channels\"}");
+                           return;
+                       }
+
+                       Core::Error err = startAsyncScan(channels);
+                       if (err.isError()) {
+                           sendScanError(err, response);
+                           return;
+                       }
+                       response.setStatus(202);
+                       response.send("{\"scanning\":true}");
+                   });
+
+    webUI.addRoute(WebUI::Method::GET, "/api/wifi/capture",
+                   [](const WebUI::Request&, WebUI::Response& response) {
+                       PcapWriter::Stats stats;
+                       PcapWriter::getInstance().getStats(stats);
+                       response.json()
+                           .beginObject()
+                           .field("running", stats.running)
+                           .field("stopping", stats.stopping)
+                           .field("file", stats.file)
+                           .field("files", stats.files)
+                           .field("framesWritten", stats.framesWritten)
+                           .field("framesDropped", stats.framesDropped)
+                           .field("framesPerSecond", stats.framesPerSecond)
+                           .field("bytesWritten", stats.bytesWritten)
+                           .field("ringPeak", stats.ringPeak)
+                           .endObject();
+                   });
+
+    // maxSize: rotation threshold in MiB; filter: optional FrameFilter expression.
+    // Start and stop only signal the writer task (async_tcp must not wait on the card):
+    // both answer 202, poll GET /api/wifi/capture for running/stopping and the file.
+    webUI.addRoute(WebUI::Method::POST, "/api/wifi/capture/start",
+                   [this](const WebUI::Request& request, WebUI::Response& response) {
+                       uint32_t maxSize = 32;
+                       if (request.hasParam("maxSize")) {
+                           maxSize = strtoul(request.param("maxSize").str().c_str(), nullptr, 10);
+                       }
+                       if (maxSize == 0 || maxSize > 1024) {
+                           response.setStatus(400);
+                           response.send("{\"error\":\"Invalid maxSize\"}");
+                           return;
+                       }
+
+                       FrameFilter filter;
+                       if (request.hasParam("filter")) {
+                           size_t errorAt = 0;
+                           std::string source = request.param("filter").str();
+                           Core::Error err = FrameFilter::compile(source.c_str(), filter, &errorAt);
+                           if (err.isError()) {
+                               response.setStatus(400);
+                               response.json()
+                                   .beginObject()
+                                   .field("error", err.message ? err.message
+                                                              : Core::getErrorMessage(err.code))
+                                   .field("position", errorAt)
+                                   .endObject();
+                               return;
+                           }
+                       }
+
+                       Core::Error err = startCapture(maxSize * 1024 * 1024, filter);
+                       if (err.isError()) {
+                           response.setStatus(
+                               err.code == Core::ErrorCode::ALREADY_INITIALIZED ? 409 : 500);
+                           response.json()
+                               .beginObject()
+                               .field("error", err.message ? err.message
+                                                          : Core::getErrorMessage(err.code))
+                               .endObject();
+                           return;
+                       }
+                       response.setStatus(202);
+                       response.send("{\"status\":\"starting\"}");
+                   });
+
+    webUI.addRoute(WebUI::Method::POST, "/api/wifi/capture/stop",
+                   [this](const WebUI::Request&, WebUI::Response& response) {
+                       stopCapture(false);
+                       response.setStatus(202);
+                       response.send("{\"status\":\"stopping\"}");
+                   });
+
+    webUI.addRoute(WebUI::Method::GET, "/api/wifi/sniffer",
+                   [this](const WebUI::Request&, WebUI::Response& response) {
+                       sendSnifferStats(*this, response);
+                   });
+
+    webUI.addRoute(WebUI::Method::GET, "/api/wifi/devices",
+                   [this](const WebUI::Request& request, WebUI::Response& response) {
+                       sendDevices(*this, request, response);
+                   });
+
+    webUI.addRoute(WebUI::Method::POST, "/api/wifi/devices/start",
+                   [this](const WebUI::Request&, WebUI::Response& response) {
+                       Core::Error err = startInventory();
+                       if (err.isError()) {
+                           response.setStatus(
+                               err.code == Core::ErrorCode::ALREADY_INITIALIZED ? 409 : 500);
+                           response.json()
+                               .beginObject()
+                               .field("error", err.message ? err.message
+                                                          : Core::getErrorMessage(err.code))
+                               .endObject();
+                           return;
+                       }
+                       response.send("{\"status\":\"ok\"}");
+                   });
+
+    webUI.addRoute(WebUI::Method::POST, "/api/wifi/devices/stop",
+                   [this](const WebUI::Request&, WebUI::Response& response) {
+                       stopInventory();
+                       response.send("{\"status\":\"ok\"}");
+                   });
+
+    webUI.addRoute(WebUI::Method::POST, "/api/wifi/devices/clear",
+                   [](const WebUI::Request&, WebUI::Response& response) {
+                       DeviceTable::getInstance().clear();
+                       response.send("{\"status\":\"ok\"}");
+                   });
+
+    webUI.addRoute(WebUI::Method::GET, "/api/wifi/hopper",
+                   [](const WebUI::Request&, WebUI::Response& response) {
+                       sendHopperStats(response);
+                   });
+
+    // No start route: hopping takes the radio off the channel the web UI is
+    // reached on, so it is started from the device menu. Stop still gets
+    // through whenever the hopper passes the AP's channel.
+    webUI.addRoute(WebUI::Method::POST, "/api/wifi/hopper/stop",
+                   [this](const WebUI::Request&, WebUI::Response& response) {
+                       stopChannelHopper();
+                       response.send("{\"status\":\"ok\"}");
+                   });
+
+    webUI.addRoute(WebUI::Method::POST, "/api/wifi/ap/start",
+                   [this](const WebUI::Request& request, WebUI::Response& response) {
+                       std::string ssid = request.hasParam("ssid") ? request.param("ssid").str()
+                                                                   : "NightStrike-AP";
+                       std::string password = request.param("password").str();
+                       Core::Error err = startAP(ssid, password);
+                       if (err.isError()) {
+                           response.setStatus(500);
+                       }
+                       response.json()
+                           .beginObject()
+                           .field("status", err.isError() ? "error" : "ok")
+                           .field("ssid", ssid)
+                           .endObject();
+                   });
+
+    webUI.addRoute(WebUI::Method::POST, "/api/wifi/ap/stop",
+                   [this](const WebUI::Request&, WebUI::Response& response) {
+                       stopAP();
+                       response.send("{\"status\":\"ok\"}");
+                   });
+}
+
 Core::Error WiFiModule::scanNetworks(std::vector<AccessPoint>& aps) {
     if (!_initialized) {
         return Core::Error(Core::ErrorCode::NOT_INITIALIZED);
     }
+    uint8_t owner;
+    if (!claimScanner(SCAN_BLOCKING, owner)) {
+        return Core::Error(Core::ErrorCode::ALREADY_INITIALIZED, "Scan in progress");
+    }
 
     aps.clear();
 
-    int n = WiFi.scanNetworks(false, true);
+    int n = WiFi.scanNetworks(false, true, false, SCAN_DWELL_MS);
     if (n < 0) {
+        s_scanOwner = SCAN_IDLE;
         return Core::Error(Core::ErrorCode::OPERATION_FAILED, "Scan failed");
     }
 
-    for (int i = 0; i < n; ++i) {
-        AccessPoint ap;
-        ap.ssid = WiFi.SSID(i).c_str();
-        ap.bssid = WiFi.BSSIDstr(i).c_str();
-        ap.rssi = WiFi.RSSI(i);
-        ap.channel = WiFi.channel(i);
-        ap.encrypted = WiFi.encryptionType(i) != WIFI_AUTH_OPEN;
+    std::vector<ScanRecord> records;
+    collectScanResults(n, records);
+    WiFi.scanDelete();
+    s_scanOwner = SCAN_IDLE;
+    ScanStore::getInstance().replace(records);
 
-        // Parse BSSID
-        String bssidStr = WiFi.BSSIDstr(i);
-        sscanf(bssidStr.c_str(), "%2hhx:%2hhx:%2hhx:%2hhx:%2hhx:%2hhx",
-            &ap.bssidBytes[0], &ap.bssidBytes[1], &ap.bssidBytes[2],
-            &ap.bssidBytes[3], &ap.bssidBytes[4], &ap.bssidBytes[5]);
+    aps.resize(records.size());
+    for (size_t i = 0; i < records.size(); ++i) {
+        toAccessPoint(records[i], aps[i]);
+    }
+    return Core::Error(Core::ErrorCode::SUCCESS);
+}
 
-        aps.push_back(ap);
+Core::Error WiFiModule::startAsyncScan(uint16_t channels) {
+    if (!_initialized) {
+        return Core::Error(Core::ErrorCode::NOT_INITIALIZED);
+    }
+    channels &= ALL_CHANNELS;
+    if (channels == 0) {
+        return Core::Error(Core::ErrorCode::INVALID_PARAMETER, "No channels to scan");
+    }
+    uint8_t owner;
+    if (!claimScanner(SCAN_ASYNC, owner)) {
+        if (owner == SCAN_ASYNC) {
+            return Core::Error(Core::ErrorCode::SUCCESS);  // Already running
+        }
+        return Core::Error(Core::ErrorCode::ALREADY_INITIALIZED, "Scan in progress");
     }
 
+    s_scanRemaining = channels;
+    if (!scanNextChannel()) {
+        s_scanOwner = SCAN_IDLE;
+        return Core::Error(Core::ErrorCode::OPERATION_FAILED, "Scan failed");
+    }
     return Core::Error(Core::ErrorCode::SUCCESS);
 }
 
+bool WiFiModule::isScanning() const {
+    return s_scanOwner != SCAN_IDLE;
+}
+
+// Reads the records the Arduino core fetched; no String round-trips
+void WiFiModule::collectScanResults(int16_t count, std::vector<ScanRecord>& records) {
+    records.reserve(count);
+    for (int16_t i = 0; i < count; ++i) {
+        auto* info = static_cast<const wifi_ap_record_t*>(WiFi.getScanInfoByIndex(i));
+        if (!info) {
+            continue;
+        }
+
+        ScanRecord record;
+        memcpy(record.bssid, info->bssid, sizeof(record.bssid));
+        memcpy(record.ssid, info->ssid, sizeof(record.ssid) - 1);
+        record.ssid[sizeof(record.ssid) - 1] = '\0';
+        record.rssi = info->rssi;
+        record.channel = info->primary;
+        record.authMode = info->authmode;
+        records.push_back(record);
+    }
+}
+
+void WiFiModule::toAccessPoint(const ScanRecord& record, AccessPoint& ap) {
+    ap.ssid = record.ssid;
+    ap.bssid = Utils::macToString(record.bssid);
+    ap.rssi = record.rssi;
+    ap.channel = record.channel;
+    ap.authMode = record.authMode;
+    ap.encrypted = record.authMode != WIFI_AUTH_OPEN;
+    memcpy(ap.bssidBytes, record.bssid, sizeof(ap.bssidBytes));
+}
+
 Core::Error WiFiModule::connectToAP(const std::string& ssid, const std::string& password) {
     if (!_initialized) {
         return Core::Error(Core::ErrorCode::NOT_INITIALIZED);
@@ -177,44 +772,348 @@ Core::Error WiFiModule::deauthAttack(const AccessPoint& ap, uint32_t count) {
 
 // Beacon spam implementation moved to beacon_spam.cpp
 
-Core::Error WiFiModule::startSniffer(std::function<void(const uint8_t*, size_t)> callback) {
+// Sniffer subscribers. The WiFi task walks the slots without locking: a slot is
+// published by setting active last, and a callback is only replaced once no
+// dispatch is in flight. Retiring a slot is a store-then-load on each side
+// (active then s_dispatching here, s_dispatching then active in the callback),
+// so those four accesses are seq_cst: with acquire/release both sides could
+// miss the other's store and the callback run while it is being replaced.
+struct SnifferSlot {
+    std::atomic<bool> active{false};
+    uint8_t types = 0;
+    WiFiModule::SnifferCallback callback;
+    FrameFilter filter;  // Empty: every frame of the subscribed types
+    std::atomic<uint32_t> delivered{0};
+    std::atomic<uint32_t> filtered{0};
+    uint64_t filterCycles = 0;    // WiFi task only; readers may see a torn value
+    uint64_t callbackCycles = 0;
+};
+
+static SnifferSlot s_snifferSlots[WiFiModule::MAX_SNIFFER_SUBSCRIBERS];
+static std::mutex s_snifferLock;  // Subscribe and unsubscribe
+static std::atomic<uint32_t> s_dispatching(0);
+static uint8_t s_subscribers = 0;
+
+static void waitForDispatch() {
+    while (s_dispatching.load(std::memory_order_seq_cst) != 0) {
+        vTaskDelay(1);
+    }
+}
+
+// Promiscuous mode follows the subscribers; the filter keeps unwanted types in the driver
+static void updatePromiscuous() {
+    uint8_t types = 0;
+    for (const auto& slot : s_snifferSlots) {
+        if (slot.active) {
+            types |= slot.types;
+        }
+    }
+
+    if (s_subscribers == 0) {
+        esp_wifi_set_promiscuous(false);
+        return;
+    }
+
+    wifi_promiscuous_filter_t filter = {types};
+    esp_wifi_set_promiscuous_filter(&filter);
+}
+
+int WiFiModule::subscribeSniffer(SnifferCallback callback, uint8_t types) {
+    return addSniffer(callback, types, nullptr);
+}
+
+int WiFiModule::subscribeSniffer(SnifferCallback callback, const FrameFilter& filter) {
+    return addSniffer(callback, filter.typeMask(), &filter);
+}
+
+int WiFiModule::addSniffer(SnifferCallback callback, uint8_t types, const FrameFilter* filter) {
+    if (!s_sniffedFrames || !callback || !(types & SNIFF_ALL)) {  // Before initialize()
+        return -1;
+    }
+
+    std::lock_guard<std::mutex> guard(s_snifferLock);
+    int id = -1;
+    for (int i = 0; i < MAX_SNIFFER_SUBSCRIBERS; ++i) {
+        if (!s_snifferSlots[i].active) {
+            id = i;
+            break;
+        }
+    }
+    if (id < 0) {
+        return -1;
+    }
+
+    SnifferSlot& slot = s_snifferSlots[id];
+    waitForDispatch();  // The old callback may still be running
+    slot.callback = callback;
+    slot.types = types & SNIFF_ALL;
+    slot.filter = filter ? *filter : FrameFilter();
+    slot.delivered = 0;
+    slot.filtered = 0;
+    slot.filterCycles = 0;
+    slot.callbackCycles = 0;
+    slot.active.store(true, std::memory_order_release);
+
+    if (s_subscribers++ == 0) {
+        // Keep a running softAP (it serves the web UI); promiscuous mode works alongside it
+        if (!(WiFi.getMode() & WIFI_AP)) {
+            WiFi.mode(WIFI_STA);
+        }
+        esp_wifi_set_promiscuous_rx_cb(snifferCallback);
+        esp_wifi_set_promiscuous(true);
+    }
+    updatePromiscuous();
+    return id;
+}
+
+void WiFiModule::unsubscribeSniffer(int id) {
+    if (id < 0 || id >= MAX_SNIFFER_SUBSCRIBERS) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> guard(s_snifferLock);
+    SnifferSlot& slot = s_snifferSlots[id];
+    if (!slot.active) {
+        return;
+    }
+
+    slot.active.store(false, std::memory_order_seq_cst);
+    waitForDispatch();
+    slot.callback = nullptr;
+    s_subscribers--;
+    updatePromiscuous();
+}
+
+void WiFiModule::getSnifferStats(std::vector<SnifferStats>& stats) const {
+    std::lock_guard<std::mutex> guard(s_snifferLock);
+    stats.clear();
+    for (int i = 0; i < MAX_SNIFFER_SUBSCRIBERS; ++i) {
+        const SnifferSlot& slot = s_snifferSlots[i];
+        if (!slot.active) {
+            continue;
+        }
+        SnifferStats entry;
+        entry.id = i;
+        entry.types = slot.types;
+        entry.filter = slot.filter.source();
+        entry.delivered = slot.delivered.load(std::memory_order_relaxed);
+        entry.filtered = slot.filtered.load(std::memory_order_relaxed);
+        entry.filterCycles = slot.filterCycles;
+        entry.callbackCycles = slot.callbackCycles;
+        stats.push_back(entry);
+    }
+}
+
+Core::Error WiFiModule::startSniffer(SnifferCallback callback) {
     if (!_initialized) {
         return Core::Error(Core::ErrorCode::NOT_INITIALIZED);
     }
 
-    if (_sniffing) {
+    if (_snifferSubscription >= 0) {
         return Core::Error(Core::ErrorCode::ALREADY_INITIALIZED);
     }
 
-    _snifferCallback = callback;
-
-    // Enable promiscuous mode
-    WiFi.mode(WIFI_STA);
-    esp_wifi_set_promiscuous(true);
-    esp_wifi_set_promiscuous_rx_cb(snifferCallback);
+    _snifferSubscription = subscribeSniffer(callback);
+    if (_snifferSubscription < 0) {
+        return Core::Error(Core::ErrorCode::OPERATION_FAILED, "No free sniffer slot");
+    }
 
-    _sniffing = true;
     Serial.println("[WiFi] Sniffer started");
     return Core::Error(Core::ErrorCode::SUCCESS);
 }
 
 Core::Error WiFiModule::stopSniffer() {
-    if (!_sniffing) {
+    if (_snifferSubscription < 0) {
         return Core::Error(Core::ErrorCode::SUCCESS);
     }
 
-    esp_wifi_set_promiscuous(false);
-    _sniffing = false;
-    _snifferCallback = nullptr;
+    unsubscribeSniffer(_snifferSubscription);
+    _snifferSubscription = -1;
 
     Serial.println("[WiFi] Sniffer stopped");
     return Core::Error(Core::ErrorCode::SUCCESS);
 }
 
+Core::Error WiFiModule::startCapture(uint32_t maxFileSize, const FrameFilter& filter) {
+    if (!_initialized) {
+        return Core::Error(Core::ErrorCode::NOT_INITIALIZED);
+    }
+
+    if (_captureSubscription >= 0) {
+        return Core::Error(Core::ErrorCode::ALREADY_INITIALIZED);
+    }
+
+    auto& pcap = PcapWriter::getInstance();
+    Core::Error err = pcap.start(maxFileSize);
+    if (err.isError()) {
+        return err;
+    }
+
+    _captureSubscription = subscribeSniffer(
+        [&pcap](const SnifferPacket& packet) { pcap.capture(packet); }, filter);
+    if (_captureSubscription < 0) {
+        pcap.stop();
+        return Core::Error(Core::ErrorCode::OPERATION_FAILED, "No free sniffer slot");
+    }
+    return Core::Error(Core::ErrorCode::SUCCESS);
+}
+
+Core::Error WiFiModule::stopCapture(bool wait) {
+    if (_captureSubscription < 0) {
+        return Core::Error(Core::ErrorCode::SUCCESS);
+    }
+
+    unsubscribeSniffer(_captureSubscription);
+    _captureSubscription = -1;
+    return PcapWriter::getInstance().stop(wait);
+}
+
+Core::Error WiFiModule::startChannelHopper(bool fixed, uint32_t dwellMs, uint32_t revisitMs) {
+    if (!_initialized) {
+        return Core::Error(Core::ErrorCode::NOT_INITIALIZED);
+    }
+
+    if (_hopperSubscription >= 0) {
+        return Core::Error(Core::ErrorCode::ALREADY_INITIALIZED);
+    }
+
+    // Reset before subscribing, so onPacket() never sees the statistics being cleared
+    auto& hopper = ChannelHopper::getInstance();
+    Core::Error err = hopper.configure(fixed ? ChannelHopper::Mode::FIXED
+                                             : ChannelHopper::Mode::ADAPTIVE,
+                                       dwellMs, revisitMs);
+    if (err.isError()) {
+        return err;
+    }
+
+    // Then subscribe: the hopper steers the channel of an existing promiscuous session
+    _hopperSubscription = subscribeSniffer(
+        [&hopper](const SnifferPacket& packet) { hopper.onPacket(packet); },
+        SNIFF_MGMT | SNIFF_DATA | SNIFF_CTRL);
+    if (_hopperSubscription < 0) {
+        return Core::Error(Core::ErrorCode::OPERATION_FAILED, "No free sniffer slot");
+    }
+
+    err = hopper.start();
+    if (err.isError()) {
+        unsubscribeSniffer(_hopperSubscription);
+        _hopperSubscription = -1;
+    }
+    return err;
+}
+
+Core::Error WiFiModule::stopChannelHopper() {
+    if (_hopperSubscription < 0) {
+        return Core::Error(Core::ErrorCode::SUCCESS);
+    }
+
+    ChannelHopper::getInstance().stop();
+    unsubscribeSniffer(_hopperSubscription);
+    _hopperSubscription = -1;
+    return Core::Error(Core::ErrorCode::SUCCESS);
+}
+
+Core::Error WiFiModule::startInventory() {
+    if (!_initialized) {
+        return Core::Error(Core::ErrorCode::NOT_INITIALIZED);
+    }
+
+    if (_inventorySubscription >= 0) {
+        return Core::Error(Core::ErrorCode::ALREADY_INITIALIZED);
+    }
+
+    auto& table = DeviceTable::getInstance();
+    Core::Error err = table.begin();
+    if (err.isError()) {
+        return err;
+    }
+
+    _inventorySubscription = subscribeSniffer(
+        [&table](const SnifferPacket& packet) { table.update(packet); }, SNIFF_MGMT | SNIFF_DATA);
+    if (_inventorySubscription < 0) {
+        return Core::Error(Core::ErrorCode::OPERATION_FAILED, "No free sniffer slot");
+    }
+
+    Serial.println("[WiFi] Device inventory started");
+    return Core::Error(Core::ErrorCode::SUCCESS);
+}
+
+Core::Error WiFiModule::stopInventory() {
+    if (_inventorySubscription < 0) {
+        return Core::Error(Core::ErrorCode::SUCCESS);
+    }
+
+    unsubscribeSniffer(_inventorySubscription);
+    _inventorySubscription = -1;
+
+    Serial.printf("[WiFi] Device inventory stopped: %u devices\n",
+                  static_cast<unsigned>(DeviceTable::getInstance().size()));
+    return Core::Error(Core::ErrorCode::SUCCESS);
+}
+
+Core::Error WiFiModule::getClients(const AccessPoint& ap, std::vector<Client>& clients) {
+    clients.clear();
+
+    std::vector<DeviceTable::Device> devices;
+    DeviceTable::getInstance().clientsOf(ap.bssidBytes, devices, MAX_CLIENTS);
+    clients.reserve(devices.size());
+    for (const auto& device : devices) {
+        Client client;
+        client.mac = Utils::macToString(device.mac);
+        client.rssi = device.rssiAvg;
+        memcpy(client.macBytes, device.mac, sizeof(client.macBytes));
+        clients.push_back(client);
+    }
+    return Core::Error(Core::ErrorCode::SUCCESS);
+}
+
 void WiFiModule::snifferCallback(void* buf, wifi_promiscuous_pkt_type_t type) {
-    if (g_wifiModuleInstance && g_wifiModuleInstance->_snifferCallback) {
-        wifi_promiscuous_pkt_t* pkt = (wifi_promiscuous_pkt_t*)buf;
-        g_wifiModuleInstance->_snifferCallback(pkt->payload, pkt->rx_ctrl.sig_len);
+    // Runs in the WiFi task: just an atomic add per frame, no registry lookup
+    s_sniffedFrames->inc();
+    const wifi_promiscuous_pkt_t* pkt = static_cast<const wifi_promiscuous_pkt_t*>(buf);
+    const wifi_pkt_rx_ctrl_t& rx = pkt->rx_ctrl;
+    SnifferPacket packet;
+    packet.data = pkt->payload;
+    packet.length = rx.sig_len;
+    packet.rssi = rx.rssi;
+    packet.noiseFloor = rx.noise_floor;
+    packet.channel = rx.channel;
+    packet.rate = rx.rate;
+    packet.timestamp = rx.timestamp;
+    packet.type = type;
+
+    uint8_t bit = 1 << type;
+    bool consumed = false;
+    // sig_len counts the FCS; addresses near the end of a short frame must not reach into it
+    size_t frameLength = packet.length > Utils::Dot11::FCS_LENGTH
+                             ? packet.length - Utils::Dot11::FCS_LENGTH : 0;
+    s_dispatching.fetch_add(1, std::memory_order_seq_cst);
+    for (auto& slot : s_snifferSlots) {
+        if (!slot.active.load(std::memory_order_seq_cst) || !(slot.types & bit)) {
+            continue;
+        }
+
+        // The filter only reads the header in place, so rejected frames cost no copy
+        if (!slot.filter.empty()) {
+            uint32_t start = ESP.getCycleCount();
+            bool match = slot.filter.matches(packet.data, frameLength, packet.rssi);
+            slot.filterCycles += ESP.getCycleCount() - start;
+            if (!match) {
+                slot.filtered.fetch_add(1, std::memory_order_relaxed);
+                continue;
+            }
+        }
+
+        uint32_t start = ESP.getCycleCount();
+        slot.callback(packet);
+        slot.callbackCycles += ESP.getCycleCount() - start;
+        slot.delivered.fetch_add(1, std::memory_order_relaxed);
+        consumed = true;
+    }
+    s_dispatching.fetch_sub(1, std::memory_order_release);
+
+    if (!consumed) {
+        s_unconsumedFrames->inc();
     }
 }
 
@@ -0,0 +1,187 @@
+#include "utils/json_writer.h"
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+namespace NightStrike {
+namespace Utils {
+
+JsonWriter& JsonWriter::beginObject() {
+    open('{');
+    return *this;
+}
+
+JsonWriter& JsonWriter::endObject() {
+    close('}');
+    return *this;
+}
+
+JsonWriter& JsonWriter::beginArray() {
+    open('[');
+    return *this;
+}
+
+JsonWriter& JsonWriter::endArray() {
+    close(']');
+    return *this;
+}
+
+JsonWriter& JsonWriter::key(const char* name) {
+    separator();
+    putEscaped(name, strlen(name));
+    put(':');
+    _afterKey = true;
+    return *this;
+}
+
+JsonWriter& JsonWriter::value(const char* str) {
+    if (!str) {
+        return null();
+    }
+    return value(str, strlen(str));
+}
+
+JsonWriter& JsonWriter::value(const char* str, size_t length) {
+    separator();
+    putEscaped(str, length);
+    return *this;
+}
+
+JsonWriter& JsonWriter::value(bool b) {
+    separator();
+    if (b) {
+        put("true", 4);
+    } else {
+        put("false", 5);
+    }
+    return *this;
+}
+
+JsonWriter& JsonWriter::value(long long n) {
+    char digits[24];
+    int len = snprintf(digits, sizeof(digits), "%lld", n);
+    separator();
+    put(digits, len);
+    return *this;
+}
+
+JsonWriter& JsonWriter::value(unsigned long long n) {
+    char digits[24];
+    int len = snprintf(digits, sizeof(digits), "%llu", n);
+    separator();
+    put(digits, len);
+    return *this;
+}
+
+JsonWriter& JsonWriter::value(double n) {
+    // JSON has no NaN/Infinity
+    if (std::isnan(n) || std::isinf(n)) {
+        return null();
+    }
+
+    char digits[32];
+    int len = snprintf(digits, sizeof(digits), "%.6g", n);
+    separator();
+    put(digits, len);
+    return *this;
+}
+
+JsonWriter& JsonWriter::null() {
+    separator();
+    put("null", 4);
+    return *this;
+}
+
+void JsonWriter::flush() {
+    if (_used > 0) {
+        _out.write(reinterpret_cast<const uint8_t*>(_buffer), _used);
+        _written += _used;
+        _used = 0;
+    }
+}
+
+void JsonWriter::separator() {
+    if (_afterKey) {
+        _afterKey = false;
+        return;
+    }
+
+    if (_depth > 0 && _depth <= MAX_DEPTH) {
+        uint32_t bit = 1u << (_depth - 1);
+        if (_hasItems & bit) {
+            put(',');
+        }
+        _hasItems |= bit;
+    }
+}
+
+void JsonWriter::open(char c) {
+    separator();
+    put(c);
+    _depth++;
+    if (_depth <= MAX_DEPTH) {
+        _hasItems &= ~(1u << (_depth - 1));
+    }
+}
+
+void JsonWriter::close(char c) {
+    if (_depth > 0) {
+        _depth--;
+    }
+    put(c);
+}
+
+void JsonWriter::put(char c) {
+    if (_used == BUFFER_SIZE) {
+        flush();
+    }
+    _buffer[_used++] = c;
+}
+
+void JsonWriter::put(const char* str, size_t length) {
+    while (length > 0) {
+        if (_used == BUFFER_SIZE) {
+            flush();
+        }
+        size_t chunk = length < BUFFER_SIZE - _used ? length : BUFFER_SIZE - _used;
+        memcpy(_buffer + _used, str, chunk);
+        _used += chunk;
+        str += chunk;
+        length -= chunk;
+    }
+}
+
+void JsonWriter::putEscaped(const char* str, size_t length) {
+    static const char HEX_DIGITS[] = "0123456789abcdef";
+
+    put('"');
+    size_t run = 0;  // Bytes that need no escaping are copied in one go
+    for (size_t i = 0; i < length; ++i) {
+        unsigned char c = static_cast<unsigned char>(str[i]);
+        if (c >= 0x20 && c != '"' && c != '\\') {
+            run++;
+            continue;
+        }
+
+        put(str + i - run, run);
+        run = 0;
+
+        switch (c) {
+            case '"': put("\\\"", 2); break;
+            case '\\': put("\\\\", 2); break;
+            case '\n': put("\\n", 2); break;
+            case '\r': put("\\r", 2); break;
+            case '\t': put("\\t", 2); break;
+            default: {
+                char escape[6] = {'\\', 'u', '0', '0', HEX_DIGITS[c >> 4], HEX_DIGITS[c & 0xF]};
+                put(escape, sizeof(escape));
+                break;
+            }
+        }
+    }
+    put(str + length - run, run);
+    put('"');
+}
+
+} // namespace Utils
+} // namespace NightStrike
@@ -0,0 +1,71 @@
+#pragma once
+
+// Host stand-in for the few Arduino-ESP32 APIs the portable sources touch
+// (native test env only; see build_src_filter in platformio.ini)
+
+#include <chrono>
+#include <cstdarg>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+class Print {
+public:
+    virtual ~Print() = default;
+    virtual size_t write(uint8_t c) = 0;
+    virtual size_t write(const uint8_t* buffer, size_t size) {
+        size_t written = 0;
+        while (size--) {
+            written += write(*buffer++);
+        }
+        return written;
+    }
+
+    size_t print(const char* text) {
+        return write(reinterpret_cast<const uint8_t*>(text), strlen(text));
+    }
+    size_t println(const char* text = "") { return print(text) + print("\n"); }
+    size_t printf(const char* format, ...) {
+        char buffer[256];
+        va_list args;
+        va_start(args, format);
+        int length = vsnprintf(buffer, sizeof(buffer), format, args);
+        va_end(args);
+        if (length <= 0) {
+            return 0;
+        }
+        return write(reinterpret_cast<const uint8_t*>(buffer),
+                     static_cast<size_t>(length) < sizeof(buffer) ? length : sizeof(buffer) - 1);
+    }
+};
+
+// Serial goes to stdout so log lines show up in the test output
+class HostSerial : public Print {
+public:
+    size_t write(uint8_t c) override { return fputc(c, stdout) == EOF ? 0 : 1; }
+    using Print::write;
+};
+
+class HostEsp {
+public:
+    uint32_t getFreeHeap() { return 0; }
+    uint32_t getMinFreeHeap() { return 0; }
+    uint32_t getMaxAllocHeap() { return 0; }
+    uint32_t getFreePsram() { return 0; }
+    uint32_t getCycleCount() { return 0; }
+};
+
+static HostSerial Serial __attribute__((unused));
+static HostEsp ESP __attribute__((unused));
+
+inline unsigned long micros() {
+    static const auto start = std::chrono::steady_clock::now();
+    return static_cast<unsigned long>(std::chrono::duration_cast<std::chrono::microseconds>(
+                                          std::chrono::steady_clock::now() - start)
+                                          .count());
+}
+
+inline unsigned long millis() {
+    return micros() / 1000;
+}
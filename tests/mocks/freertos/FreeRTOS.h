@@ -0,0 +1,15 @@
+#pragma once
+
+// Host stand-in for FreeRTOS (native test env only)
+
+#include <cstdint>
+
+typedef uint32_t TickType_t;
+typedef int32_t BaseType_t;
+typedef uint32_t UBaseType_t;
+typedef void* TaskHandle_t;
+
+#define pdTRUE 1
+#define pdFALSE 0
+#define pdPASS 1
+#define pdMS_TO_TICKS(ms) (static_cast<TickType_t>(ms))
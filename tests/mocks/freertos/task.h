@@ -0,0 +1,7 @@
+#pragma once
+
+#include "freertos/FreeRTOS.h"
+
+inline UBaseType_t uxTaskGetNumberOfTasks() {
+    return 1;
+}
@@ -0,0 +1,212 @@
+#include <unity.h>
+#include "modules/channel_hopper.h"
+#include <cstdio>
+#include <vector>
+
+using NightStrike::Modules::ChannelHopper;
+
+static const uint8_t CHANNELS = ChannelHopper::CHANNEL_COUNT;
+
+// A transmitter in the simulated band: sends every periodMs, first at phaseMs
+struct Device {
+    uint8_t channel;
+    uint32_t periodMs;
+    uint32_t phaseMs;
+    bool accessPoint;   // Counts towards the channel's BSSIDs once heard
+    bool found;
+};
+
+// Busy 1/6/11 with chatty APs and stations that rarely talk, a few quiet channels
+static std::vector<Device> makeBand() {
+    std::vector<Device> band;
+    uint32_t seed = 12345;
+    auto next = [&seed](uint32_t range) {
+        seed = seed * 1103515245u + 12345u;
+        return (seed >> 8) % range;
+    };
+    static const struct {
+        uint8_t channel;
+        int aps;
+        int stations;
+    } LAYOUT[] = {{1, 12, 40}, {6, 10, 30}, {11, 8, 25}, {3, 1, 2}, {9, 1, 1}, {13, 1, 0}};
+
+    for (const auto& entry : LAYOUT) {
+        for (int i = 0; i < entry.aps; ++i) {
+            band.push_back({entry.channel, 102, next(102), true, false});  // Beacons
+        }
+        for (int i = 0; i < entry.stations; ++i) {
+            uint32_t period = 5000 + next(25000);
+            band.push_back({entry.channel, period, next(period), false, false});
+        }
+    }
+    return band;
+}
+
+// First transmission at or after t
+static uint32_t nextSend(const Device& device, uint32_t t) {
+    if (t <= device.phaseMs) {
+        return device.phaseMs;
+    }
+    uint32_t periods = (t - device.phaseMs + device.periodMs - 1) / device.periodMs;
+    return device.phaseMs + periods * device.periodMs;
+}
+
+static size_t countFound(const std::vector<Device>& band) {
+    size_t found = 0;
+    for (const auto& device : band) {
+        found += device.found;
+    }
+    return found;
+}
+
+/**
+ * Runs the hop loop of ChannelHopper::hopTask over band for durationMs and
+ * returns the devices heard; adaptive plans each round with planDwell(),
+ * fixed keeps fixedDwellMs. maxRoundMs gets the longest round, maxGapMs the
+ * longest time any channel went unvisited.
+ */
+static size_t simulate(std::vector<Device>& band, bool adaptive, uint32_t durationMs,
+                       uint32_t fixedDwellMs, uint32_t revisitMs, uint32_t& maxRoundMs,
+                       uint32_t& maxGapMs) {
+    uint32_t rates[CHANNELS] = {};
+    uint32_t bssids[CHANNELS] = {};
+    uint32_t visits[CHANNELS] = {};
+    uint32_t lastLeft[CHANNELS] = {};
+    uint32_t dwellMs[CHANNELS];
+    for (uint8_t i = 0; i < CHANNELS; ++i) {
+        dwellMs[i] = adaptive ? ChannelHopper::MIN_DWELL_MS : fixedDwellMs;
+    }
+
+    maxRoundMs = 0;
+    maxGapMs = 0;
+    uint32_t now = 0;
+    while (now < durationMs) {
+        uint32_t roundStart = now;
+        if (adaptive) {
+            ChannelHopper::planDwell(rates, bssids, revisitMs, dwellMs);
+        }
+        for (uint8_t i = 0; i < CHANNELS; ++i) {
+            if (visits[i] && now - lastLeft[i] > maxGapMs) {
+                maxGapMs = now - lastLeft[i];
+            }
+
+            uint32_t leave = now + dwellMs[i];
+            uint32_t frames = 0;
+            for (auto& device : band) {
+                if (device.channel != i + 1) {
+                    continue;
+                }
+                for (uint32_t t = nextSend(device, now); t < leave; t += device.periodMs) {
+                    frames++;
+                    if (!device.found) {
+                        device.found = true;
+                        bssids[i] += device.accessPoint;
+                    }
+                }
+            }
+
+            // Smoothed as in hopTask
+            uint32_t rate = frames * 1000 / dwellMs[i];
+            rates[i] = visits[i] == 0 ? rate : (rates[i] * 3 + rate) / 4;
+            visits[i]++;
+            now = leave;
+            lastLeft[i] = now;
+        }
+        if (now - roundStart > maxRoundMs) {
+            maxRoundMs = now - roundStart;
+        }
+    }
+    return countFound(band);
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_quiet_band_splits_evenly() {
+    uint32_t rates[CHANNELS] = {};
+    uint32_t bssids[CHANNELS] = {};
+    uint32_t dwellMs[CHANNELS];
+    ChannelHopper::planDwell(rates, bssids, ChannelHopper::DEFAULT_REVISIT_MS, dwellMs);
+    for (uint8_t i = 1; i < CHANNELS; ++i) {
+        TEST_ASSERT_EQUAL(dwellMs[0], dwellMs[i]);
+    }
+    TEST_ASSERT_TRUE(dwellMs[0] > ChannelHopper::MIN_DWELL_MS);
+}
+
+void test_plan_stays_in_bounds() {
+    // One channel carries everything: capped, the rest keep the minimum
+    uint32_t rates[CHANNELS] = {};
+    uint32_t bssids[CHANNELS] = {};
+    rates[5] = 2000;
+    bssids[5] = 40;
+    uint32_t dwellMs[CHANNELS];
+    ChannelHopper::planDwell(rates, bssids, 20000, dwellMs);
+
+    uint32_t round = 0;
+    for (uint8_t i = 0; i < CHANNELS; ++i) {
+        TEST_ASSERT_TRUE(dwellMs[i] >= ChannelHopper::MIN_DWELL_MS);
+        TEST_ASSERT_TRUE(dwellMs[i] <= ChannelHopper::MAX_DWELL_MS);
+        round += dwellMs[i];
+    }
+    TEST_ASSERT_EQUAL(ChannelHopper::MAX_DWELL_MS, dwellMs[5]);
+    TEST_ASSERT_EQUAL(ChannelHopper::MIN_DWELL_MS, dwellMs[0]);
+    TEST_ASSERT_TRUE(round <= 20000);
+}
+
+void test_round_never_exceeds_revisit() {
+    static const uint32_t REVISITS[] = {1300, 2000, 5000, 9000};
+    for (uint32_t revisitMs : REVISITS) {
+        std::vector<Device> band = makeBand();
+        uint32_t maxRoundMs;
+        uint32_t maxGapMs;
+        simulate(band, true, 60000, 0, revisitMs, maxRoundMs, maxGapMs);
+        TEST_ASSERT_TRUE(maxRoundMs <= revisitMs);
+        // The gap spans the ends of two rounds planned apart
+        TEST_ASSERT_TRUE(maxGapMs < 2 * revisitMs);
+    }
+}
+
+void test_adaptive_finds_more_than_fixed() {
+    // One and five minutes of the band with the menu's default settings
+    static const uint32_t DURATIONS[] = {60000, 300000};
+    for (uint32_t durationMs : DURATIONS) {
+        std::vector<Device> fixedBand = makeBand();
+        std::vector<Device> adaptiveBand = makeBand();
+        uint32_t round;
+        uint32_t gap;
+        size_t fixed = simulate(fixedBand, false, durationMs,
+                                ChannelHopper::DEFAULT_FIXED_DWELL_MS,
+                                ChannelHopper::DEFAULT_REVISIT_MS, round, gap);
+        size_t adaptive = simulate(adaptiveBand, true, durationMs,
+                                   ChannelHopper::DEFAULT_FIXED_DWELL_MS,
+                                   ChannelHopper::DEFAULT_REVISIT_MS, round, gap);
+        printf("%u s: fixed %u devices, adaptive %u of %u\n",
+               static_cast<unsigned>(durationMs / 1000), static_cast<unsigned>(fixed),
+               static_cast<unsigned>(adaptive), static_cast<unsigned>(fixedBand.size()));
+        TEST_ASSERT_TRUE(adaptive > fixed);
+    }
+}
+
+void test_adaptive_still_covers_quiet_channels() {
+    // Busy channels take most of the round, yet the lone APs elsewhere are heard at once
+    std::vector<Device> band = makeBand();
+    uint32_t round;
+    uint32_t gap;
+    simulate(band, true, 2 * ChannelHopper::DEFAULT_REVISIT_MS, 0,
+             ChannelHopper::DEFAULT_REVISIT_MS, round, gap);
+    for (const auto& device : band) {
+        if (device.accessPoint) {
+            TEST_ASSERT_TRUE(device.found);
+        }
+    }
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_quiet_band_splits_evenly);
+    RUN_TEST(test_plan_stays_in_bounds);
+    RUN_TEST(test_round_never_exceeds_revisit);
+    RUN_TEST(test_adaptive_finds_more_than_fixed);
+    RUN_TEST(test_adaptive_still_covers_quiet_channels);
+    return UNITY_END();
+}
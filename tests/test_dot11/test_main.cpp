@@ -0,0 +1,365 @@
+#include <unity.h>
+#include "utils/dot11.h"
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+using namespace NightStrike::Utils::Dot11;
+
+// Frames of tests/fixtures/dot11_capture.pcap, radiotap header stripped
+static std::vector<std::vector<uint8_t>> s_fixture;
+
+static std::string fixturePath(const char* name) {
+    std::string path = __FILE__;
+    size_t slash = path.find_last_of('/');
+    path = slash == std::string::npos ? std::string(".") : path.substr(0, slash);
+    return path + "/../fixtures/" + name;
+}
+
+// LINKTYPE_IEEE802_11 (105) and _RADIOTAP (127), as PcapWriter saves them
+static bool loadPcap(const char* name, std::vector<std::vector<uint8_t>>& frames) {
+    FILE* file = fopen(fixturePath(name).c_str(), "rb");
+    if (!file) {
+        return false;
+    }
+
+    uint8_t header[24];
+    bool ok = fread(header, 1, sizeof(header), file) == sizeof(header) &&
+              header[0] == 0xd4 && header[1] == 0xc3 && header[2] == 0xb2 && header[3] == 0xa1;
+    uint32_t linktype = header[20] | header[21] << 8;
+    ok = ok && (linktype == 105 || linktype == 127);
+
+    uint8_t record[16];
+    while (ok && fread(record, 1, sizeof(record), file) == sizeof(record)) {
+        uint32_t length = record[8] | record[9] << 8 | record[10] << 16 | record[11] << 24;
+        std::vector<uint8_t> data(length);
+        if (length > 65535 || fread(data.data(), 1, length, file) != length) {
+            ok = false;
+            break;
+        }
+        size_t skip = 0;
+        if (linktype == 127) {
+            skip = length >= 4 ? (data[2] | data[3] << 8) : length + 1;
+            if (skip > length) {
+                ok = false;
+                break;
+            }
+        }
+        frames.emplace_back(data.begin() + skip, data.end());
+    }
+
+    fclose(file);
+    return ok && !frames.empty();
+}
+
+// Every pointer the parser hands out must stay inside [data, data + length)
+static void checkInside(const uint8_t* p, size_t size, const uint8_t* data, size_t length) {
+    if (p) {
+        TEST_ASSERT_TRUE(p >= data && p + size <= data + length);
+    }
+}
+
+// Drives every accessor; returns a checksum so the optimizer keeps the work
+static uint32_t exercise(const uint8_t* data, size_t length) {
+    Frame frame(data, length);
+    uint32_t sum = frame.type() + frame.subtype() + frame.sequence() + frame.fragment();
+
+    checkInside(frame.addr1(), MAC_LENGTH, data, length);
+    checkInside(frame.addr2(), MAC_LENGTH, data, length);
+    checkInside(frame.addr3(), MAC_LENGTH, data, length);
+    checkInside(frame.addr4(), MAC_LENGTH, data, length);
+    checkInside(frame.bssid(), MAC_LENGTH, data, length);
+    TEST_ASSERT_TRUE(frame.headerLength() <= length);
+
+    Span body = frame.body();
+    checkInside(body.data, body.length, data, length);
+
+    for (const Element& element : frame.elements()) {
+        checkInside(element.body.data, element.body.length, data, length);
+        sum += element.id + element.body.length;
+    }
+
+    Span ssid;
+    if (frame.ssid(ssid)) {
+        TEST_ASSERT_TRUE(ssid.length <= MAX_SSID_LENGTH);
+        checkInside(ssid.data, ssid.length, data, length);
+        sum += ssid.length;
+    }
+    return sum;
+}
+
+// Exactly-sized heap copy, so an over-read shows up under ASan/valgrind
+static uint32_t exerciseCopy(const uint8_t* data, size_t length) {
+    std::vector<uint8_t> copy(data, data + length);
+    return exercise(copy.empty() ? nullptr : copy.data(), length);
+}
+
+static uint32_t s_rng = 0x2545F491;
+
+static uint32_t nextRandom() {
+    s_rng ^= s_rng << 13;
+    s_rng ^= s_rng >> 17;
+    s_rng ^= s_rng << 5;
+    return s_rng;
+}
+
+void setUp() {}
+void tearDown() {}
+
+// ---- Malformed frames ----
+
+void test_null_and_empty() {
+    Frame none(nullptr, 100);
+    TEST_ASSERT_FALSE(none.valid());
+    TEST_ASSERT_EQUAL(0, none.length());
+    TEST_ASSERT_NULL(none.addr1());
+    TEST_ASSERT_TRUE(none.body().empty());
+
+    uint8_t byte = 0x80;
+    Frame one(&byte, 1);
+    TEST_ASSERT_EQUAL(0, one.type());
+    TEST_ASSERT_EQUAL(0, one.flags());
+    TEST_ASSERT_FALSE(one.is(TYPE_MGMT, BEACON));
+}
+
+void test_sniffer_length_without_fcs() {
+    uint8_t ack[14] = {0xd4, 0x00, 0x00, 0x00, 1, 2, 3, 4, 5, 6, 0xde, 0xad, 0xbe, 0xef};
+    TEST_ASSERT_EQUAL(10, Frame::fromSniffer(ack, sizeof(ack)).length());
+    TEST_ASSERT_TRUE(Frame::fromSniffer(ack, sizeof(ack)).valid());
+    TEST_ASSERT_EQUAL(0, Frame::fromSniffer(ack, FCS_LENGTH).length());
+    TEST_ASSERT_EQUAL(0, Frame::fromSniffer(ack, 2).length());
+}
+
+void test_truncated_header() {
+    // Beacon cut inside addr3 and inside the sequence control
+    uint8_t beacon[24] = {0x80, 0x00, 0x00, 0x00};
+    Frame cut(beacon, 20);
+    TEST_ASSERT_NOT_NULL(cut.addr2());
+    TEST_ASSERT_NULL(cut.addr3());
+    TEST_ASSERT_NULL(cut.bssid());
+    TEST_ASSERT_EQUAL(0, cut.headerLength());
+    TEST_ASSERT_FALSE(Frame(beacon, 23).hasSequence());
+    Elements none = Frame(beacon, 24).elements();
+    TEST_ASSERT_FALSE(none.begin() != none.end());
+}
+
+void test_beacon_shorter_than_fixed_fields() {
+    uint8_t beacon[24 + 11] = {0x80, 0x00};
+    Frame frame(beacon, sizeof(beacon));
+    TEST_ASSERT_EQUAL(24, frame.headerLength());
+    TEST_ASSERT_FALSE(frame.elements().begin() != frame.elements().end());
+    Span ssid;
+    TEST_ASSERT_FALSE(frame.ssid(ssid));
+}
+
+void test_element_past_end_is_dropped() {
+    // SSID "ab", then a rates element claiming 8 bytes with 3 left
+    uint8_t probe[24 + 9] = {0x40, 0x00};
+    const uint8_t tail[] = {0, 2, 'a', 'b', 1, 8, 0x82, 0x84, 0x8b};
+    memcpy(probe + 24, tail, sizeof(tail));
+
+    int count = 0;
+    for (const Element& element : Frame(probe, sizeof(probe)).elements()) {
+        TEST_ASSERT_EQUAL(IE_SSID, element.id);
+        count++;
+    }
+    TEST_ASSERT_EQUAL(1, count);
+
+    // Exactly filling the buffer is fine
+    probe[24 + 5] = 3;
+    count = 0;
+    for (const Element& element : Frame(probe, sizeof(probe)).elements()) {
+        (void)element;
+        count++;
+    }
+    TEST_ASSERT_EQUAL(2, count);
+}
+
+void test_element_header_split() {
+    // One byte left: the id without its length
+    uint8_t probe[24 + 5] = {0x40, 0x00};
+    const uint8_t tail[] = {0, 2, 'a', 'b', 221};
+    memcpy(probe + 24, tail, sizeof(tail));
+    Span body;
+    TEST_ASSERT_TRUE(Frame(probe, sizeof(probe)).elements().find(IE_SSID, body));
+    TEST_ASSERT_FALSE(Frame(probe, sizeof(probe)).elements().find(IE_VENDOR, body));
+}
+
+void test_oversized_ssid_rejected() {
+    uint8_t probe[24 + 2 + 33] = {0x40, 0x00};
+    probe[24] = IE_SSID;
+    probe[25] = 33;
+    Span ssid;
+    TEST_ASSERT_FALSE(Frame(probe, sizeof(probe)).ssid(ssid));
+}
+
+void test_protected_management_has_no_elements() {
+    uint8_t probe[24 + 4] = {0x40, 0x40};
+    const uint8_t tail[] = {0, 2, 'a', 'b'};
+    memcpy(probe + 24, tail, sizeof(tail));
+    Span ssid;
+    TEST_ASSERT_FALSE(Frame(probe, sizeof(probe)).ssid(ssid));
+}
+
+void test_control_frames() {
+    uint8_t rts[16] = {0xb4, 0x00, 0, 0, 1, 1, 1, 1, 1, 1, 2, 2, 2, 2, 2, 2};
+    Frame frame(rts, sizeof(rts));
+    TEST_ASSERT_EQUAL(TYPE_CTRL, frame.type());
+    TEST_ASSERT_NULL(frame.addr3());
+    TEST_ASSERT_NULL(frame.bssid());
+    TEST_ASSERT_FALSE(frame.hasSequence());
+    TEST_ASSERT_EQUAL(16, frame.headerLength());
+    TEST_ASSERT_EQUAL(10, Frame(rts, 10).length());
+    TEST_ASSERT_EQUAL(0, Frame(rts, 15).headerLength());
+}
+
+void test_data_addressing() {
+    uint8_t data[32] = {0x08, 0x00};
+    for (uint8_t i = 0; i < 4; ++i) {
+        memset(data + 4 + i * 6, i + 1, 6);
+    }
+    memset(data + 24, 4, 6);
+
+    data[1] = 0x01;  // To DS: BSSID is addr1
+    TEST_ASSERT_EQUAL_PTR(data + 4, Frame(data, 24).bssid());
+    data[1] = 0x02;  // From DS: addr2
+    TEST_ASSERT_EQUAL_PTR(data + 10, Frame(data, 24).bssid());
+
+    data[1] = 0x03;  // WDS: four addresses, no BSSID
+    TEST_ASSERT_NULL(Frame(data, sizeof(data)).bssid());
+    TEST_ASSERT_EQUAL_PTR(data + 24, Frame(data, sizeof(data)).addr4());
+    TEST_ASSERT_NULL(Frame(data, 29).addr4());
+    TEST_ASSERT_EQUAL(30, Frame(data, sizeof(data)).headerLength());
+    TEST_ASSERT_EQUAL(0, Frame(data, 29).headerLength());
+}
+
+void test_qos_and_ht_control() {
+    uint8_t qos[40] = {0x88, 0x01};
+    TEST_ASSERT_EQUAL(26, Frame(qos, sizeof(qos)).headerLength());
+    qos[1] |= 0x80;  // Order bit: HT control follows
+    TEST_ASSERT_EQUAL(30, Frame(qos, sizeof(qos)).headerLength());
+    TEST_ASSERT_EQUAL(10, Frame(qos, sizeof(qos)).body().length);
+    TEST_ASSERT_TRUE(Frame(qos, 29).body().empty());
+}
+
+void test_extension_type() {
+    uint8_t frame[30] = {0x0c, 0x00};
+    TEST_ASSERT_EQUAL(TYPE_EXTENSION, Frame(frame, sizeof(frame)).type());
+    TEST_ASSERT_EQUAL(0, Frame(frame, sizeof(frame)).headerLength());
+    TEST_ASSERT_NULL(Frame(frame, sizeof(frame)).bssid());
+}
+
+// ---- Fixture ----
+
+void test_fixture_frames() {
+    TEST_ASSERT_TRUE_MESSAGE(!s_fixture.empty(), "tests/fixtures/dot11_capture.pcap not loaded");
+
+    int beacons = 0;
+    int named = 0;
+    int acks = 0;
+    for (const auto& bytes : s_fixture) {
+        Frame frame(bytes.data(), bytes.size());
+        exercise(bytes.data(), bytes.size());
+
+        if (frame.is(TYPE_MGMT, BEACON)) {
+            beacons++;
+            Span ssid;
+            if (frame.ssid(ssid) && !ssid.empty()) {
+                TEST_ASSERT_EQUAL_MEMORY("net-", ssid.data, 4);
+                named++;
+            }
+        } else if (frame.is(TYPE_CTRL, 13)) {
+            acks++;
+            TEST_ASSERT_NULL(frame.addr2());
+        }
+    }
+    // 60 beacons, one in seven hidden; the damaged beacons don't count as named
+    TEST_ASSERT_TRUE(beacons >= 60);
+    TEST_ASSERT_EQUAL(51, named);
+    TEST_ASSERT_EQUAL(60, acks);
+}
+
+// ---- Fuzz ----
+
+void test_fuzz_random_bytes() {
+    uint8_t buffer[96];
+    uint32_t sum = 0;
+    for (int iteration = 0; iteration < 200000; ++iteration) {
+        size_t length = nextRandom() % sizeof(buffer);
+        for (size_t i = 0; i < length; ++i) {
+            buffer[i] = static_cast<uint8_t>(nextRandom());
+        }
+        // Bias toward management frames so the element walk gets exercised
+        if (length > 0 && (nextRandom() & 1)) {
+            buffer[0] = (nextRandom() & 1) ? 0x80 : 0x40;
+            buffer[1] &= ~0x40;
+        }
+        sum += exerciseCopy(buffer, length);
+    }
+    TEST_ASSERT_TRUE(sum != 0);
+}
+
+void test_fuzz_fixture_mutations() {
+    TEST_ASSERT_TRUE(!s_fixture.empty());
+    uint32_t sum = 0;
+    for (const auto& bytes : s_fixture) {
+        // Every truncation
+        for (size_t length = 0; length <= bytes.size(); ++length) {
+            sum += exerciseCopy(bytes.data(), length);
+        }
+        // Random bit flips, lengths included
+        std::vector<uint8_t> mutated(bytes);
+        for (int round = 0; round < 64 && !mutated.empty(); ++round) {
+            mutated[nextRandom() % mutated.size()] ^= 1 << (nextRandom() % 8);
+            sum += exerciseCopy(mutated.data(), mutated.size());
+        }
+    }
+    TEST_ASSERT_TRUE(sum != 0);
+}
+
+// ---- Benchmark ----
+
+void test_benchmark_fixture() {
+    TEST_ASSERT_TRUE(!s_fixture.empty());
+    const int rounds = 2000;
+    uint32_t sum = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int round = 0; round < rounds; ++round) {
+        for (const auto& bytes : s_fixture) {
+            sum += exercise(bytes.data(), bytes.size());
+        }
+    }
+    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start).count();
+
+    double frames = static_cast<double>(rounds) * s_fixture.size();
+    char line[96];
+    snprintf(line, sizeof(line), "%.0f frames in %lld us, %.1f Mframes/s (checksum %u)", frames,
+             static_cast<long long>(elapsed), elapsed > 0 ? frames / elapsed : 0.0, sum);
+    TEST_MESSAGE(line);
+}
+
+int main(int argc, char** argv) {
+    loadPcap("dot11_capture.pcap", s_fixture);
+
+    UNITY_BEGIN();
+    RUN_TEST(test_null_and_empty);
+    RUN_TEST(test_sniffer_length_without_fcs);
+    RUN_TEST(test_truncated_header);
+    RUN_TEST(test_beacon_shorter_than_fixed_fields);
+    RUN_TEST(test_element_past_end_is_dropped);
+    RUN_TEST(test_element_header_split);
+    RUN_TEST(test_oversized_ssid_rejected);
+    RUN_TEST(test_protected_management_has_no_elements);
+    RUN_TEST(test_control_frames);
+    RUN_TEST(test_data_addressing);
+    RUN_TEST(test_qos_and_ht_control);
+    RUN_TEST(test_extension_type);
+    RUN_TEST(test_fixture_frames);
+    RUN_TEST(test_fuzz_random_bytes);
+    RUN_TEST(test_fuzz_fixture_mutations);
+    RUN_TEST(test_benchmark_fixture);
+    return UNITY_END();
+}
@@ -0,0 +1,256 @@
+#include <unity.h>
+#include "modules/frame_filter.h"
+#include <string>
+
+using NightStrike::Modules::FrameFilter;
+
+// Frames without FCS: beacon from aa:bb:01:02:03:04, probe request from 11:22:01:02:03:04,
+// ACK to aa:bb:01:02:03:04, data to the DS in BSS aa:bb:01:02:03:04
+static const uint8_t BEACON[24] = {0x80, 0, 0, 0,
+                                   0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+                                   0xaa, 0xbb, 1, 2, 3, 4,
+                                   0xaa, 0xbb, 1, 2, 3, 4,
+                                   0x10, 0};
+static const uint8_t PROBE[24] = {0x40, 0, 0, 0,
+                                  0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+                                  0x11, 0x22, 1, 2, 3, 4,
+                                  0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+                                  0x20, 0};
+static const uint8_t ACK[10] = {0xd4, 0, 0, 0, 0xaa, 0xbb, 1, 2, 3, 4};
+static const uint8_t DATA_TO_DS[24] = {0x08, 0x01, 0, 0,
+                                       0xaa, 0xbb, 1, 2, 3, 4,
+                                       0x11, 0x22, 1, 2, 3, 4,
+                                       0x33, 0x44, 1, 2, 3, 4,
+                                       0x30, 0};
+
+static FrameFilter compileOk(const char* source) {
+    FrameFilter filter;
+    size_t errorAt = 0;
+    NightStrike::Core::Error err = FrameFilter::compile(source, filter, &errorAt);
+    TEST_ASSERT_TRUE_MESSAGE(err.isSuccess(), err.message ? err.message : source);
+    return filter;
+}
+
+static const char* compileError(const char* source, size_t* errorAt = nullptr) {
+    FrameFilter filter;
+    NightStrike::Core::Error err = FrameFilter::compile(source, filter, errorAt);
+    TEST_ASSERT_TRUE_MESSAGE(err.isError(), source);
+    TEST_ASSERT_TRUE(filter.empty());
+    return err.message ? err.message : "";
+}
+
+void setUp() {}
+void tearDown() {}
+
+// ---- Primitives ----
+
+void test_empty_filter_matches_everything() {
+    FrameFilter filter;
+    TEST_ASSERT_TRUE(filter.empty());
+    TEST_ASSERT_TRUE(filter.matches(ACK, sizeof(ACK), -90));
+}
+
+void test_type_and_subtype() {
+    FrameFilter mgmt = compileOk("type mgt");
+    TEST_ASSERT_TRUE(mgmt.matches(BEACON, sizeof(BEACON), 0));
+    TEST_ASSERT_FALSE(mgmt.matches(ACK, sizeof(ACK), 0));
+
+    FrameFilter beacon = compileOk("subtype beacon");
+    TEST_ASSERT_TRUE(beacon.matches(BEACON, sizeof(BEACON), 0));
+    TEST_ASSERT_FALSE(beacon.matches(PROBE, sizeof(PROBE), 0));
+
+    FrameFilter ack = compileOk("SUBTYPE Ack");
+    TEST_ASSERT_TRUE(ack.matches(ACK, sizeof(ACK), 0));
+    TEST_ASSERT_FALSE(ack.matches(BEACON, sizeof(BEACON), 0));
+}
+
+void test_rssi() {
+    FrameFilter strong = compileOk("rssi > -60");
+    TEST_ASSERT_TRUE(strong.matches(ACK, sizeof(ACK), -59));
+    TEST_ASSERT_FALSE(strong.matches(ACK, sizeof(ACK), -60));
+
+    FrameFilter weak = compileOk("rssi < -80");
+    TEST_ASSERT_TRUE(weak.matches(ACK, sizeof(ACK), -81));
+    TEST_ASSERT_FALSE(weak.matches(ACK, sizeof(ACK), -80));
+}
+
+void test_addresses() {
+    FrameFilter src = compileOk("src 11:22:01:02:03:04");
+    TEST_ASSERT_TRUE(src.matches(PROBE, sizeof(PROBE), 0));
+    TEST_ASSERT_FALSE(src.matches(BEACON, sizeof(BEACON), 0));
+
+    // To DS: the BSSID is addr1, not addr3
+    FrameFilter bssid = compileOk("bssid aa-bb-01-02-03-04");
+    TEST_ASSERT_TRUE(bssid.matches(DATA_TO_DS, sizeof(DATA_TO_DS), 0));
+    TEST_ASSERT_TRUE(bssid.matches(BEACON, sizeof(BEACON), 0));
+    // Control frames carry no BSSID, even when addr1 happens to be equal
+    TEST_ASSERT_FALSE(bssid.matches(ACK, sizeof(ACK), 0));
+}
+
+void test_wildcard_bssid() {
+    FrameFilter prefix = compileOk("bssid aa:bb:*");
+    TEST_ASSERT_TRUE(prefix.matches(BEACON, sizeof(BEACON), 0));
+    TEST_ASSERT_TRUE(prefix.matches(DATA_TO_DS, sizeof(DATA_TO_DS), 0));
+    TEST_ASSERT_FALSE(prefix.matches(PROBE, sizeof(PROBE), 0));
+
+    FrameFilter other = compileOk("bssid aa:bc:*");
+    TEST_ASSERT_FALSE(other.matches(BEACON, sizeof(BEACON), 0));
+
+    // A bare '*' matches any frame that has the address at all
+    FrameFilter any = compileOk("addr3 *");
+    TEST_ASSERT_TRUE(any.matches(PROBE, sizeof(PROBE), 0));
+    TEST_ASSERT_FALSE(any.matches(ACK, sizeof(ACK), 0));
+
+    compileError("bssid aa:*:cc");
+    compileError("bssid aa:bb:cc:dd:ee");
+    compileError("bssid aa:bb:cc:dd:ee:ff:00");
+}
+
+void test_truncated_frame_never_matches_address() {
+    FrameFilter filter = compileOk("addr3 aa:bb:01:02:03:04");
+    TEST_ASSERT_TRUE(filter.matches(BEACON, sizeof(BEACON), 0));
+    TEST_ASSERT_FALSE(filter.matches(BEACON, 21, 0));
+    TEST_ASSERT_FALSE(filter.matches(BEACON, 1, 0));
+}
+
+// ---- Operators ----
+
+void test_and_binds_tighter_than_or() {
+    // subtype ack or (subtype beacon and rssi > -50)
+    FrameFilter filter = compileOk("subtype ack or subtype beacon and rssi > -50");
+    TEST_ASSERT_TRUE(filter.matches(ACK, sizeof(ACK), -90));
+    TEST_ASSERT_FALSE(filter.matches(BEACON, sizeof(BEACON), -90));
+    TEST_ASSERT_TRUE(filter.matches(BEACON, sizeof(BEACON), -40));
+
+    FrameFilter grouped = compileOk("(subtype ack || subtype beacon) && rssi > -50");
+    TEST_ASSERT_FALSE(grouped.matches(ACK, sizeof(ACK), -90));
+    TEST_ASSERT_TRUE(grouped.matches(ACK, sizeof(ACK), -40));
+}
+
+void test_not() {
+    FrameFilter filter = compileOk("not type mgt");
+    TEST_ASSERT_FALSE(filter.matches(BEACON, sizeof(BEACON), 0));
+    TEST_ASSERT_TRUE(filter.matches(ACK, sizeof(ACK), 0));
+
+    // not binds to the next primitive only
+    FrameFilter tight = compileOk("! subtype beacon and type mgt");
+    TEST_ASSERT_TRUE(tight.matches(PROBE, sizeof(PROBE), 0));
+    TEST_ASSERT_FALSE(tight.matches(BEACON, sizeof(BEACON), 0));
+    TEST_ASSERT_FALSE(tight.matches(ACK, sizeof(ACK), 0));
+
+    FrameFilter twice = compileOk("not not subtype beacon");
+    TEST_ASSERT_TRUE(twice.matches(BEACON, sizeof(BEACON), 0));
+    TEST_ASSERT_FALSE(twice.matches(PROBE, sizeof(PROBE), 0));
+}
+
+void test_type_mask() {
+    TEST_ASSERT_EQUAL(0x01, compileOk("subtype beacon").typeMask());
+    TEST_ASSERT_EQUAL(0x05, compileOk("type mgt or type data").typeMask());
+    TEST_ASSERT_EQUAL(0x05, compileOk("bssid aa:bb:*").typeMask());
+    TEST_ASSERT_EQUAL(0x01, compileOk("type mgt and rssi > -70").typeMask());
+    // A negation can't narrow the driver filter
+    TEST_ASSERT_EQUAL(0x0F, compileOk("not type mgt").typeMask());
+}
+
+// ---- Errors and limits ----
+
+void test_syntax_errors() {
+    size_t errorAt = 0;
+    TEST_ASSERT_EQUAL_STRING("Unknown frame type", compileError("type foo", &errorAt));
+    TEST_ASSERT_EQUAL(5, errorAt);
+    TEST_ASSERT_EQUAL_STRING("Missing )", compileError("(type mgt", &errorAt));
+    TEST_ASSERT_EQUAL_STRING("Expression expected", compileError("type mgt and", &errorAt));
+    TEST_ASSERT_EQUAL_STRING("Expression expected", compileError(""));
+    TEST_ASSERT_EQUAL_STRING("Unexpected token", compileError("type mgt )", &errorAt));
+    TEST_ASSERT_EQUAL(9, errorAt);
+    TEST_ASSERT_EQUAL_STRING("Bad RSSI value", compileError("rssi > -129"));
+    TEST_ASSERT_EQUAL_STRING("rssi needs > or <", compileError("rssi = 3"));
+    TEST_ASSERT_EQUAL_STRING("Unknown keyword", compileError("ssid foo"));
+
+    FrameFilter filter;
+    TEST_ASSERT_TRUE(FrameFilter::compile(nullptr, filter).isError());
+}
+
+void test_never_matches_rejected() {
+    size_t errorAt = 99;
+    TEST_ASSERT_EQUAL_STRING("Filter can never match",
+                             compileError("type mgt and type data", &errorAt));
+    TEST_ASSERT_EQUAL(0, errorAt);
+    compileError("subtype ack and bssid aa:bb:*");
+    // Through a negation the mask is unknown, so it compiles
+    compileOk("not type mgt and type mgt");
+}
+
+void test_nesting_limit() {
+    std::string ok = std::string(FrameFilter::MAX_DEPTH, '(') + "type mgt" +
+                     std::string(FrameFilter::MAX_DEPTH, ')');
+    compileOk(ok.c_str());
+
+    std::string deep = std::string(FrameFilter::MAX_DEPTH + 1, '(') + "type mgt" +
+                       std::string(FrameFilter::MAX_DEPTH + 1, ')');
+    TEST_ASSERT_EQUAL_STRING("Filter nested too deeply", compileError(deep.c_str()));
+
+    // Unbalanced runs stop at the limit instead of recursing through the whole string
+    std::string run(FrameFilter::MAX_SOURCE, '(');
+    TEST_ASSERT_EQUAL_STRING("Filter nested too deeply", compileError(run.c_str()));
+
+    std::string nots;
+    for (int i = 0; i <= FrameFilter::MAX_DEPTH; ++i) {
+        nots += "not ";
+    }
+    nots += "type mgt";
+    TEST_ASSERT_EQUAL_STRING("Filter nested too deeply", compileError(nots.c_str()));
+}
+
+void test_code_limit() {
+    // Nine bytes per address primitive and one per "or": ten terms are 99 > MAX_CODE
+    std::string source = "src 11:22:33:44:55:66";
+    for (int i = 0; i < 9; ++i) {
+        source += " || src 11:22:33:44:55:66";
+    }
+    TEST_ASSERT_TRUE(source.size() <= FrameFilter::MAX_SOURCE);
+    TEST_ASSERT_EQUAL_STRING("Filter too long", compileError(source.c_str()));
+
+    std::string fits = "src 11:22:33:44:55:66";
+    for (int i = 0; i < 8; ++i) {
+        fits += " || src 11:22:33:44:55:66";
+    }
+    compileOk(fits.c_str());
+}
+
+void test_source_limit() {
+    std::string padded = std::string(FrameFilter::MAX_SOURCE - 8, ' ') + "type mgt";
+    compileOk(padded.c_str());
+
+    size_t errorAt = 0;
+    std::string longer = " " + padded;
+    TEST_ASSERT_EQUAL_STRING("Filter too long", compileError(longer.c_str(), &errorAt));
+    TEST_ASSERT_EQUAL(FrameFilter::MAX_SOURCE, errorAt);
+}
+
+void test_failed_compile_clears_previous_program() {
+    FrameFilter filter = compileOk("subtype beacon");
+    TEST_ASSERT_TRUE(FrameFilter::compile("subtype nope", filter).isError());
+    TEST_ASSERT_TRUE(filter.empty());
+    TEST_ASSERT_TRUE(filter.matches(PROBE, sizeof(PROBE), 0));
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_empty_filter_matches_everything);
+    RUN_TEST(test_type_and_subtype);
+    RUN_TEST(test_rssi);
+    RUN_TEST(test_addresses);
+    RUN_TEST(test_wildcard_bssid);
+    RUN_TEST(test_truncated_frame_never_matches_address);
+    RUN_TEST(test_and_binds_tighter_than_or);
+    RUN_TEST(test_not);
+    RUN_TEST(test_type_mask);
+    RUN_TEST(test_syntax_errors);
+    RUN_TEST(test_never_matches_rejected);
+    RUN_TEST(test_nesting_limit);
+    RUN_TEST(test_code_limit);
+    RUN_TEST(test_source_limit);
+    RUN_TEST(test_failed_compile_clears_previous_program);
+    return UNITY_END();
+}
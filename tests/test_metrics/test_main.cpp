@@ -0,0 +1,173 @@
+#include <unity.h>
+#include "core/metrics.h"
+#include <string>
+
+using NightStrike::Core::Metrics;
+
+// Collects the exposition text
+class StringPrint : public Print {
+public:
+    std::string text;
+    size_t write(uint8_t c) override {
+        text += static_cast<char>(c);
+        return 1;
+    }
+    size_t write(const uint8_t* buffer, size_t size) override {
+        text.append(reinterpret_cast<const char*>(buffer), size);
+        return size;
+    }
+};
+
+static std::string exposition() {
+    StringPrint out;
+    Metrics::getInstance().write(out);
+    return out.text;
+}
+
+static bool contains(const std::string& text, const std::string& part) {
+    return text.find(part) != std::string::npos;
+}
+
+static size_t occurrences(const std::string& text, const std::string& part) {
+    size_t count = 0;
+    for (size_t at = text.find(part); at != std::string::npos; at = text.find(part, at + 1)) {
+        count++;
+    }
+    return count;
+}
+
+// Every line ends in '\n' and none is empty, so no raw newline slipped through a field
+static void assertWellFormed(const std::string& text) {
+    TEST_ASSERT_TRUE(!text.empty());
+    TEST_ASSERT_EQUAL('\n', text[text.size() - 1]);
+    TEST_ASSERT_FALSE(contains(text, "\n\n"));
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_counter_help_and_type() {
+    Metrics::Counter& counter =
+        Metrics::getInstance().counter("test_events_total", "Events seen by the test");
+    counter.inc();
+    counter.inc(41);
+
+    std::string text = exposition();
+    assertWellFormed(text);
+    TEST_ASSERT_TRUE(contains(text, "# HELP test_events_total Events seen by the test\n"
+                                    "# TYPE test_events_total counter\n"
+                                    "test_events_total 42\n"));
+}
+
+void test_registering_twice_returns_same_metric() {
+    Metrics::Counter& first = Metrics::getInstance().counter("test_same_total", "Same");
+    Metrics::Counter& second = Metrics::getInstance().counter("test_same_total", "Same");
+    TEST_ASSERT_EQUAL_PTR(&first, &second);
+    TEST_ASSERT_EQUAL(1, occurrences(exposition(), "# TYPE test_same_total counter\n"));
+}
+
+void test_counter_is_64_bit() {
+    Metrics::Counter& bytes = Metrics::getInstance().counter("test_bytes_total", "Bytes");
+    bytes.inc(0xFFFFFFF0u);
+    bytes.inc(0x20);
+    TEST_ASSERT_TRUE(bytes.value() == 0x100000010ULL);
+    TEST_ASSERT_TRUE(contains(exposition(), "test_bytes_total 4294967312\n"));
+}
+
+void test_gauge_and_sampler() {
+    Metrics::Gauge& gauge = Metrics::getInstance().gauge("test_level", "Level");
+    gauge.set(-5);
+    Metrics::getInstance().gauge("test_sampled", "Sampled", []() { return 1234; });
+
+    std::string text = exposition();
+    TEST_ASSERT_TRUE(contains(text, "# TYPE test_level gauge\ntest_level -5\n"));
+    TEST_ASSERT_TRUE(contains(text, "test_sampled 1234\n"));
+}
+
+void test_labelled_family_shares_help_and_type() {
+    Metrics::getInstance().counter("test_io_total{dir=\"in\"}", "IO").inc(3);
+    Metrics::getInstance().counter("test_io_total{dir=\"out\"}", "IO").inc(4);
+
+    std::string text = exposition();
+    TEST_ASSERT_EQUAL(1, occurrences(text, "# HELP test_io_total IO\n"));
+    TEST_ASSERT_EQUAL(1, occurrences(text, "# TYPE test_io_total counter\n"));
+    TEST_ASSERT_TRUE(contains(text, "test_io_total{dir=\"in\"} 3\ntest_io_total{dir=\"out\"} 4\n"));
+}
+
+void test_escaping() {
+    Metrics::getInstance().counter("test_escaped_total{path=\"C:\\tmp\",note=\"a\nb\"}",
+                                   "Line one\nback\\slash").inc();
+
+    std::string text = exposition();
+    assertWellFormed(text);
+    TEST_ASSERT_TRUE(contains(text, "# HELP test_escaped_total Line one\\nback\\\\slash\n"));
+    TEST_ASSERT_TRUE(contains(text, "test_escaped_total{path=\"C:\\\\tmp\",note=\"a\\nb\"} 1\n"));
+}
+
+void test_histogram_buckets() {
+    static const uint32_t BOUNDS[] = {10, 100};
+    Metrics::Histogram& histogram =
+        Metrics::getInstance().histogram("test_latency_ms", "Latency", BOUNDS, 2);
+    histogram.observe(5);
+    histogram.observe(10);   // Upper bounds are inclusive
+    histogram.observe(50);
+    histogram.observe(1000);
+
+    std::string text = exposition();
+    assertWellFormed(text);
+    TEST_ASSERT_TRUE(contains(text, "# TYPE test_latency_ms histogram\n"
+                                    "test_latency_ms_bucket{le=\"10\"} 2\n"
+                                    "test_latency_ms_bucket{le=\"100\"} 3\n"
+                                    "test_latency_ms_bucket{le=\"+Inf\"} 4\n"
+                                    "test_latency_ms_sum 1065\n"
+                                    "test_latency_ms_count 4\n"));
+}
+
+void test_histogram_keeps_fixed_labels() {
+    static const uint32_t BOUNDS[] = {1};
+    Metrics::getInstance()
+        .histogram("test_size_bytes{kind=\"x\"}", "Size", BOUNDS, 1)
+        .observe(7);
+
+    std::string text = exposition();
+    TEST_ASSERT_TRUE(contains(text, "test_size_bytes_bucket{kind=\"x\",le=\"1\"} 0\n"
+                                    "test_size_bytes_bucket{kind=\"x\",le=\"+Inf\"} 1\n"
+                                    "test_size_bytes_sum{kind=\"x\"} 7\n"
+                                    "test_size_bytes_count{kind=\"x\"} 1\n"));
+}
+
+void test_type_conflict_gets_detached_metric() {
+    Metrics::Counter& counter = Metrics::getInstance().counter("test_conflict", "Counter");
+    counter.inc(2);
+
+    // Same family, other type: usable, but never exported
+    Metrics::Gauge& gauge = Metrics::getInstance().gauge("test_conflict{x=\"1\"}", "Gauge");
+    gauge.set(99);
+    TEST_ASSERT_EQUAL(99, gauge.value());
+    Metrics::Gauge& again = Metrics::getInstance().gauge("test_conflict", "Gauge");
+    TEST_ASSERT_TRUE(&again != &gauge);
+
+    std::string text = exposition();
+    TEST_ASSERT_EQUAL(1, occurrences(text, "# TYPE test_conflict "));
+    TEST_ASSERT_TRUE(contains(text, "# TYPE test_conflict counter\ntest_conflict 2\n"));
+    TEST_ASSERT_FALSE(contains(text, "99"));
+    TEST_ASSERT_FALSE(contains(text, "test_conflict{"));
+
+    // A longer name sharing the prefix is a different family
+    Metrics::getInstance().gauge("test_conflict_other", "Other").set(1);
+    TEST_ASSERT_TRUE(contains(exposition(), "# TYPE test_conflict_other gauge\n"));
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_counter_help_and_type);
+    RUN_TEST(test_registering_twice_returns_same_metric);
+    RUN_TEST(test_counter_is_64_bit);
+    RUN_TEST(test_gauge_and_sampler);
+    RUN_TEST(test_labelled_family_shares_help_and_type);
+    RUN_TEST(test_escaping);
+    RUN_TEST(test_histogram_buckets);
+    RUN_TEST(test_histogram_keeps_fixed_labels);
+    RUN_TEST(test_type_conflict_gets_detached_metric);
+    return UNITY_END();
+}
@@ -0,0 +1,270 @@
+#include <unity.h>
+#include "modules/nmea_parser.h"
+#include <chrono>
+#include <cstring>
+#include <cstdio>
+#include <string>
+
+using NightStrike::Modules::NmeaParser;
+
+// Logs under tests/fixtures, read whole
+static std::string s_log10Hz;    // 5 s of a u-blox at 10 Hz, south-west of the equator
+static std::string s_logDamaged; // Noise, bad and truncated sentences, then a fix
+
+static std::string readFixture(const char* name) {
+    std::string path = __FILE__;
+    size_t slash = path.find_last_of('/');
+    path = (slash == std::string::npos ? std::string(".") : path.substr(0, slash)) +
+           "/../fixtures/" + name;
+
+    std::string content;
+    FILE* file = fopen(path.c_str(), "rb");
+    if (!file) {
+        return content;
+    }
+    char buffer[512];
+    size_t length;
+    while ((length = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+        content.append(buffer, length);
+    }
+    fclose(file);
+    return content;
+}
+
+static size_t feed(NmeaParser& parser, const char* text) {
+    return parser.feed(text, strlen(text));
+}
+
+void setUp() {}
+void tearDown() {}
+
+// ---- Framing and checksums ----
+
+void test_checksum_error() {
+    NmeaParser parser;
+    TEST_ASSERT_EQUAL(0, feed(parser, "$GPGGA,123519,4807.038,N,01131.000,E,1,08,0.9,545.4,M,"
+                                      "46.9,M,,*48\r\n"));
+    TEST_ASSERT_EQUAL(1, parser.stats().checksumErrors);
+    TEST_ASSERT_EQUAL(0, parser.stats().sentences);
+    TEST_ASSERT_FALSE(parser.fix().valid);
+
+    // A digit that isn't hex fails the same way
+    TEST_ASSERT_EQUAL(0, feed(parser, "$GPVTG,054.7,T,034.4,M,005.5,N,010.2,K*4g\r\n"));
+    TEST_ASSERT_EQUAL(2, parser.stats().checksumErrors);
+}
+
+void test_missing_checksum() {
+    NmeaParser parser;
+    TEST_ASSERT_EQUAL(0, feed(parser, "$GPGGA,123519,4807.038,N,01131.000,E,1,08,0.9,545.4,M,"
+                                      "46.9,M,,\r\n"));
+    TEST_ASSERT_EQUAL(1, parser.stats().checksumErrors);
+    TEST_ASSERT_FALSE(parser.fix().valid);
+}
+
+void test_overflow() {
+    NmeaParser parser;
+    std::string longSentence = "$GPTXT," + std::string(NmeaParser::MAX_SENTENCE, 'X') + "*00\r\n";
+    TEST_ASSERT_EQUAL(0, feed(parser, longSentence.c_str()));
+    TEST_ASSERT_EQUAL(1, parser.stats().overflows);
+    TEST_ASSERT_EQUAL(0, parser.stats().checksumErrors);
+
+    // The next sentence parses normally
+    TEST_ASSERT_EQUAL(1, feed(parser, "$GPVTG,054.7,T,034.4,M,005.5,N,010.2,K*48\r\n"));
+}
+
+void test_resync_on_dollar() {
+    NmeaParser parser;
+    TEST_ASSERT_EQUAL(1, feed(parser, "$GPGGA,1235$GPVTG,054.7,T,034.4,M,005.5,N,010.2,K*48\r\n"));
+    TEST_ASSERT_EQUAL(1, parser.stats().sentences);
+}
+
+void test_unknown_sentence_ignored() {
+    NmeaParser parser;
+    TEST_ASSERT_EQUAL(0, feed(parser, "$GPGSV,3,1,11,03,03,111,00,04,15,270,00,06,01,010,00,13,"
+                                      "06,292,00*74\r\n"));
+    TEST_ASSERT_EQUAL(1, parser.stats().sentences);
+    TEST_ASSERT_EQUAL(1, parser.stats().ignored);
+}
+
+// ---- Fields ----
+
+void test_gga_fields() {
+    NmeaParser parser;
+    TEST_ASSERT_EQUAL(1, feed(parser, "$GPGGA,123519,4807.038,N,01131.000,E,1,08,0.9,545.4,M,"
+                                      "46.9,M,,*47\r\n"));
+    const NmeaParser::Fix& fix = parser.fix();
+    TEST_ASSERT_TRUE(fix.valid);
+    TEST_ASSERT_DOUBLE_WITHIN(1e-7, 48.1173, fix.latitude);
+    TEST_ASSERT_DOUBLE_WITHIN(1e-7, 11.516666667, fix.longitude);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 545.4f, fix.altitude);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 0.9f, fix.hdop);
+    TEST_ASSERT_EQUAL(8, fix.satellites);
+    TEST_ASSERT_EQUAL(1, fix.quality);
+    TEST_ASSERT_EQUAL(12, fix.hour);
+    TEST_ASSERT_EQUAL(35, fix.minute);
+    TEST_ASSERT_EQUAL(19, fix.second);
+    TEST_ASSERT_EQUAL(1, parser.stats().positions);
+}
+
+void test_gga_without_fix() {
+    NmeaParser parser;
+    feed(parser, "$GPGGA,123519,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,,*47\r\n");
+    feed(parser, "$GPGGA,235959,,,,,0,00,99.9,,,,,,*70\r\n");
+    TEST_ASSERT_FALSE(parser.fix().valid);
+    TEST_ASSERT_EQUAL(1, parser.stats().positions);
+    // The last good position is kept
+    TEST_ASSERT_DOUBLE_WITHIN(1e-7, 48.1173, parser.fix().latitude);
+}
+
+void test_rmc_fields() {
+    NmeaParser parser;
+    TEST_ASSERT_EQUAL(1, feed(parser, "$GPRMC,123519.50,A,4807.038,N,01131.000,E,022.4,084.4,"
+                                      "230394,003.1,W*41\r\n"));
+    const NmeaParser::Fix& fix = parser.fix();
+    TEST_ASSERT_TRUE(fix.valid);
+    TEST_ASSERT_DOUBLE_WITHIN(1e-7, 48.1173, fix.latitude);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 22.4f * 1.852f, fix.speedKmh);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 84.4f, fix.course);
+    TEST_ASSERT_EQUAL(500, fix.millisecond);
+    TEST_ASSERT_EQUAL(23, fix.day);
+    TEST_ASSERT_EQUAL(3, fix.month);
+    TEST_ASSERT_EQUAL(1994, fix.year);
+
+    // Void status drops the fix but still carries the date
+    TEST_ASSERT_EQUAL(1, feed(parser, "$GPRMC,235959,V,,,,,,,311299,,,N*53\r\n"));
+    TEST_ASSERT_FALSE(parser.fix().valid);
+    TEST_ASSERT_EQUAL(1999, parser.fix().year);
+    TEST_ASSERT_EQUAL(1, parser.stats().positions);
+}
+
+void test_gsa_fields() {
+    NmeaParser parser;
+    TEST_ASSERT_EQUAL(1, feed(parser, "$GNGSA,A,3,04,05,,09,12,,,24,,,,,2.5,1.3,2.1*27\r\n"));
+    const NmeaParser::Fix& fix = parser.fix();
+    TEST_ASSERT_EQUAL(3, fix.mode);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 2.5f, fix.pdop);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 1.3f, fix.hdop);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 2.1f, fix.vdop);
+    TEST_ASSERT_EQUAL(0, parser.stats().positions);
+}
+
+void test_vtg_fields() {
+    NmeaParser parser;
+    TEST_ASSERT_EQUAL(1, feed(parser, "$GPVTG,054.7,T,034.4,M,005.5,N,010.2,K*48\r\n"));
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 54.7f, parser.fix().course);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 10.2f, parser.fix().speedKmh);
+    TEST_ASSERT_EQUAL(0, parser.stats().positions);
+}
+
+// ---- Logs ----
+
+void test_south_west_log() {
+    TEST_ASSERT_TRUE_MESSAGE(!s_log10Hz.empty(), "tests/fixtures/nmea_10hz_sw.nmea not loaded");
+    NmeaParser parser;
+    parser.feed(s_log10Hz.data(), s_log10Hz.size());
+
+    const NmeaParser::Fix& fix = parser.fix();
+    TEST_ASSERT_TRUE(fix.valid);
+    TEST_ASSERT_TRUE(fix.latitude < -34.5 && fix.latitude > -34.7);
+    TEST_ASSERT_TRUE(fix.longitude < -58.3 && fix.longitude > -58.5);
+    TEST_ASSERT_EQUAL(3, fix.mode);
+    TEST_ASSERT_EQUAL(12, fix.satellites);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 20.0f, fix.speedKmh);
+    TEST_ASSERT_EQUAL(2024, fix.year);
+    TEST_ASSERT_EQUAL(3, fix.month);
+    TEST_ASSERT_EQUAL(5, fix.day);
+
+    const NmeaParser::Stats& stats = parser.stats();
+    TEST_ASSERT_EQUAL(0, stats.checksumErrors);
+    TEST_ASSERT_EQUAL(0, stats.overflows);
+    TEST_ASSERT_EQUAL(10, stats.ignored);     // GSV and TXT once a second
+    TEST_ASSERT_EQUAL(100, stats.positions);  // RMC and GGA, 50 epochs
+}
+
+void test_10hz_timing() {
+    TEST_ASSERT_TRUE(!s_log10Hz.empty());
+    NmeaParser parser;
+
+    // Epoch time after each position, byte by byte as the UART delivers it
+    uint32_t last = 0;
+    uint32_t epochs = 0;
+    uint32_t positions = 0;
+    for (char c : s_log10Hz) {
+        if (!parser.feed(c) || parser.stats().positions == positions) {
+            continue;
+        }
+        positions = parser.stats().positions;
+        const NmeaParser::Fix& fix = parser.fix();
+        uint32_t ms = ((fix.hour * 60 + fix.minute) * 60 + fix.second) * 1000 + fix.millisecond;
+        if (ms != last) {
+            if (epochs > 0) {
+                TEST_ASSERT_EQUAL(100, ms - last);
+            }
+            last = ms;
+            epochs++;
+        }
+    }
+    TEST_ASSERT_EQUAL(50, epochs);
+}
+
+void test_damaged_log() {
+    TEST_ASSERT_TRUE_MESSAGE(!s_logDamaged.empty(), "tests/fixtures/nmea_damaged.nmea not loaded");
+    NmeaParser parser;
+    parser.feed(s_logDamaged.data(), s_logDamaged.size());
+
+    const NmeaParser::Stats& stats = parser.stats();
+    TEST_ASSERT_EQUAL(4, stats.sentences);
+    TEST_ASSERT_EQUAL(3, stats.checksumErrors);  // Wrong sum, no "*hh", bad hex digit
+    TEST_ASSERT_EQUAL(1, stats.overflows);
+    TEST_ASSERT_EQUAL(2, stats.positions);
+
+    TEST_ASSERT_TRUE(parser.fix().valid);
+    TEST_ASSERT_DOUBLE_WITHIN(1e-7, 48.1173, parser.fix().latitude);
+    TEST_ASSERT_EQUAL(2, parser.fix().second);
+}
+
+// ---- Benchmark ----
+
+void test_benchmark_bytes_per_second() {
+    TEST_ASSERT_TRUE(!s_log10Hz.empty());
+    NmeaParser parser;
+    const int rounds = 2000;
+
+    auto start = std::chrono::steady_clock::now();
+    size_t updates = 0;
+    for (int round = 0; round < rounds; ++round) {
+        updates += parser.feed(s_log10Hz.data(), s_log10Hz.size());
+    }
+    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start).count();
+
+    double bytes = static_cast<double>(rounds) * s_log10Hz.size();
+    char line[96];
+    snprintf(line, sizeof(line), "%.0f bytes in %lld us, %.1f MB/s (%u updates)", bytes,
+             static_cast<long long>(elapsed), elapsed > 0 ? bytes / elapsed : 0.0,
+             static_cast<unsigned>(updates));
+    TEST_MESSAGE(line);
+    TEST_ASSERT_EQUAL(rounds * 200, updates);
+}
+
+int main(int argc, char** argv) {
+    s_log10Hz = readFixture("nmea_10hz_sw.nmea");
+    s_logDamaged = readFixture("nmea_damaged.nmea");
+
+    UNITY_BEGIN();
+    RUN_TEST(test_checksum_error);
+    RUN_TEST(test_missing_checksum);
+    RUN_TEST(test_overflow);
+    RUN_TEST(test_resync_on_dollar);
+    RUN_TEST(test_unknown_sentence_ignored);
+    RUN_TEST(test_gga_fields);
+    RUN_TEST(test_gga_without_fix);
+    RUN_TEST(test_rmc_fields);
+    RUN_TEST(test_gsa_fields);
+    RUN_TEST(test_vtg_fields);
+    RUN_TEST(test_south_west_log);
+    RUN_TEST(test_10hz_timing);
+    RUN_TEST(test_damaged_log);
+    RUN_TEST(test_benchmark_bytes_per_second);
+    return UNITY_END();
+}
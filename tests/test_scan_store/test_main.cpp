@@ -0,0 +1,319 @@
+#include <unity.h>
+#include "modules/scan_store.h"
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+using NightStrike::Modules::ScanStore;
+using NightStrike::Modules::WiFiModule;
+
+// BSSID 02:00:00:00:00:<id>
+static WiFiModule::ScanRecord ap(uint8_t id, const char* ssid, int8_t rssi, uint8_t channel,
+                                 uint8_t authMode = WIFI_AUTH_WPA2_PSK) {
+    WiFiModule::ScanRecord record;
+    const uint8_t bssid[6] = {0x02, 0, 0, 0, 0, id};
+    memcpy(record.bssid, bssid, sizeof(record.bssid));
+    snprintf(record.ssid, sizeof(record.ssid), "%s", ssid);
+    record.rssi = rssi;
+    record.channel = channel;
+    record.authMode = authMode;
+    return record;
+}
+
+static ScanStore& store() {
+    return ScanStore::getInstance();
+}
+
+// Row indices of a query's first page, as BSSID ids
+static std::vector<int> ids(const ScanStore::Query& query, size_t limit = 100) {
+    ScanStore::Reader reader = store().read();
+    ScanStore::Page page;
+    TEST_ASSERT_TRUE(reader.query(query, 0, 0, limit, page).isSuccess());
+    std::vector<int> result;
+    for (uint16_t row : page.items) {
+        result.push_back(reader.entry(row).bssid[5]);
+    }
+    return result;
+}
+
+static void assertIds(const std::vector<int>& expected, const std::vector<int>& actual) {
+    TEST_ASSERT_EQUAL(expected.size(), actual.size());
+    for (size_t i = 0; i < expected.size(); ++i) {
+        TEST_ASSERT_EQUAL(expected[i], actual[i]);
+    }
+}
+
+// Every test starts from its own full scan
+void setUp() {
+    store().replace(std::vector<WiFiModule::ScanRecord>());
+}
+void tearDown() {}
+
+void test_sort_by_rssi_ties_keep_scan_order() {
+    store().replace({ap(1, "a", -60, 1), ap(2, "b", -40, 6), ap(3, "c", -60, 11),
+                     ap(4, "d", -40, 1)});
+
+    ScanStore::Query query;  // RSSI, strongest first
+    assertIds({2, 4, 1, 3}, ids(query));
+    query.descending = false;
+    assertIds({1, 3, 2, 4}, ids(query));
+}
+
+void test_sort_by_channel_and_ssid() {
+    store().replace({ap(1, "beta", -50, 11), ap(2, "Alpha", -50, 6), ap(3, "alpha", -50, 1),
+                     ap(4, "Gamma", -50, 6)});
+
+    ScanStore::Query query;
+    query.sort = ScanStore::SortKey::CHANNEL;
+    query.descending = false;
+    assertIds({3, 2, 4, 1}, ids(query));
+
+    // Case-insensitive, equal names in scan order
+    query.sort = ScanStore::SortKey::SSID;
+    assertIds({2, 3, 1, 4}, ids(query));
+}
+
+void test_filters() {
+    store().replace({ap(1, "HomeNet", -50, 1, WIFI_AUTH_OPEN),
+                     ap(2, "homenet-5", -50, 6, WIFI_AUTH_WPA_WPA2_PSK),
+                     ap(3, "Office", -50, 6, WIFI_AUTH_WPA3_PSK),
+                     ap(4, "", -50, 11, WIFI_AUTH_WEP),
+                     ap(5, "Lab", -50, 1, WIFI_AUTH_WPA2_WPA3_PSK)});
+
+    ScanStore::Query query;
+    query.descending = false;
+    query.channel = 6;
+    assertIds({2, 3}, ids(query));
+
+    query.channel = 0;
+    query.security = ScanStore::Security::OPEN;
+    assertIds({1}, ids(query));
+    query.security = ScanStore::Security::ENCRYPTED;
+    assertIds({2, 3, 4, 5}, ids(query));
+    query.security = ScanStore::Security::WPA;
+    assertIds({2}, ids(query));
+    query.security = ScanStore::Security::WPA2;
+    assertIds({2, 5}, ids(query));
+    query.security = ScanStore::Security::WPA3;
+    assertIds({3, 5}, ids(query));
+
+    query.security = ScanStore::Security::ANY;
+    query.ssid = "NET";
+    assertIds({1, 2}, ids(query));
+
+    // All at once
+    query.channel = 6;
+    query.security = ScanStore::Security::WPA2;
+    assertIds({2}, ids(query));
+}
+
+void test_paging() {
+    std::vector<WiFiModule::ScanRecord> records;
+    for (int i = 1; i <= 5; ++i) {
+        records.push_back(ap(i, "net", -40 - i, 1));
+    }
+    store().replace(records);
+
+    ScanStore::Reader reader = store().read();
+    ScanStore::Query query;
+    ScanStore::Page page;
+    TEST_ASSERT_TRUE(reader.query(query, 0, 0, 2, page).isSuccess());
+    TEST_ASSERT_EQUAL(5, page.total);
+    TEST_ASSERT_EQUAL(2, page.items.size());
+    TEST_ASSERT_TRUE(page.hasMore());
+
+    TEST_ASSERT_TRUE(reader.query(query, page.generation, 4, 2, page).isSuccess());
+    TEST_ASSERT_EQUAL(1, page.items.size());
+    TEST_ASSERT_EQUAL(5, reader.entry(page.items[0]).bssid[5]);
+    TEST_ASSERT_FALSE(page.hasMore());
+
+    // Past the end: empty, not an error
+    TEST_ASSERT_TRUE(reader.query(query, page.generation, 9, 2, page).isSuccess());
+    TEST_ASSERT_EQUAL(0, page.items.size());
+    TEST_ASSERT_EQUAL(5, page.total);
+}
+
+void test_page_size_is_capped() {
+    std::vector<WiFiModule::ScanRecord> records;
+    for (int i = 0; i < 150; ++i) {
+        records.push_back(ap(i, "net", -50, 1));
+    }
+    store().replace(records);
+
+    ScanStore::Reader reader = store().read();
+    ScanStore::Page page;
+    TEST_ASSERT_TRUE(reader.query(ScanStore::Query(), 0, 0, 1000, page).isSuccess());
+    TEST_ASSERT_EQUAL(ScanStore::MAX_PAGE_SIZE, page.items.size());
+    TEST_ASSERT_TRUE(page.hasMore());
+}
+
+void test_cursor_round_trip() {
+    uint32_t generation = 0;
+    size_t offset = 0;
+    std::string cursor = ScanStore::makeCursor(4000000000u, 75);
+    TEST_ASSERT_EQUAL_STRING("4000000000.75", cursor.c_str());
+    TEST_ASSERT_TRUE(ScanStore::parseCursor(cursor.c_str(), generation, offset));
+    TEST_ASSERT_TRUE(generation == 4000000000u);
+    TEST_ASSERT_EQUAL(75, offset);
+}
+
+void test_cursor_rejects_malformed() {
+    static const char* const BAD[] = {"", "7", "7.", ".5", "0.5", "7.5x", "7,5", "x.5", "7.5.1"};
+    for (const char* cursor : BAD) {
+        uint32_t generation = 99;
+        size_t offset = 99;
+        TEST_ASSERT_FALSE_MESSAGE(ScanStore::parseCursor(cursor, generation, offset), cursor);
+        TEST_ASSERT_EQUAL(99, generation);
+        TEST_ASSERT_EQUAL(99, offset);
+    }
+}
+
+void test_stale_cursor_is_refused() {
+    store().replace({ap(1, "a", -50, 1), ap(2, "b", -50, 1)});
+    uint32_t old = store().generation();
+    store().replace({ap(3, "c", -50, 1)});
+    TEST_ASSERT_TRUE(store().generation() != old);
+
+    // The route answers this with 410
+    ScanStore::Reader reader = store().read();
+    ScanStore::Page page;
+    NightStrike::Core::Error err = reader.query(ScanStore::Query(), old, 1, 10, page);
+    TEST_ASSERT_TRUE(err.code == NightStrike::Core::ErrorCode::INVALID_PARAMETER);
+    TEST_ASSERT_TRUE(reader.query(ScanStore::Query(), reader.generation(), 0, 10, page)
+                         .isSuccess());
+}
+
+void test_survey_keeps_rows_and_generation() {
+    store().replace({ap(1, "a", -50, 1), ap(2, "b", -50, 6), ap(3, "c", -50, 11)});
+    uint32_t generation = store().generation();
+
+    // Channel 6: b updated in place, d new at the end, a overheard from channel 1 ignored
+    store().merge(6, {ap(2, "b2", -30, 6), ap(4, "d", -70, 6), ap(1, "a", -80, 1)}, true);
+    TEST_ASSERT_EQUAL(generation, store().generation());
+    {
+        ScanStore::Reader reader = store().read();
+        TEST_ASSERT_EQUAL(4, reader.size());
+        TEST_ASSERT_EQUAL_STRING("b2", reader.entry(1).ssid);
+        TEST_ASSERT_EQUAL(-30, reader.entry(1).rssi);
+        TEST_ASSERT_EQUAL(-50, reader.entry(0).rssi);
+        TEST_ASSERT_EQUAL(4, reader.entry(3).bssid[5]);
+    }
+
+    // Channel 1 failed, so a stays although this survey never heard it
+    store().keep(1, true);
+    store().merge(11, {ap(3, "c", -55, 11)}, false);
+
+    // Nothing removed at the end, so every cursor handed out is still good
+    TEST_ASSERT_EQUAL(generation, store().generation());
+    TEST_ASSERT_EQUAL(4, store().size());
+}
+
+void test_survey_end_removes_unheard_aps() {
+    store().replace({ap(1, "a", -50, 1), ap(2, "b", -50, 6), ap(3, "c", -50, 6)});
+    uint32_t generation = store().generation();
+
+    store().merge(1, {ap(1, "a", -50, 1)}, true);
+    store().merge(6, {ap(3, "c", -50, 6)}, false);
+
+    TEST_ASSERT_TRUE(store().generation() != generation);
+    WiFiModule::ScanRecord found;
+    TEST_ASSERT_FALSE(store().find(ap(2, "", 0, 0).bssid, found));
+    TEST_ASSERT_TRUE(store().find(ap(3, "", 0, 0).bssid, found));
+    TEST_ASSERT_EQUAL_STRING("c", found.ssid);
+    TEST_ASSERT_EQUAL(6, found.channel);
+    TEST_ASSERT_EQUAL(2, store().size());
+}
+
+void test_ssids_are_interned() {
+    store().replace({ap(1, "cafe", -50, 1), ap(2, "shop", -50, 1), ap(3, "cafe", -50, 6),
+                     ap(4, "", -50, 6), ap(5, "", -50, 11)});
+
+    ScanStore::Reader reader = store().read();
+    TEST_ASSERT_EQUAL_PTR(reader.entry(0).ssid, reader.entry(2).ssid);
+    TEST_ASSERT_TRUE(reader.entry(0).ssid != reader.entry(1).ssid);
+    TEST_ASSERT_EQUAL_STRING("", reader.entry(3).ssid);
+    TEST_ASSERT_EQUAL_PTR(reader.entry(3).ssid, reader.entry(4).ssid);
+}
+
+void test_pool_survives_growth() {
+    // Enough names to grow the open-addressed index several times
+    std::vector<WiFiModule::ScanRecord> records;
+    char name[16];
+    for (int i = 0; i < 200; ++i) {
+        snprintf(name, sizeof(name), "net-%d", i);
+        records.push_back(ap(i, name, -50, 1));
+    }
+    records.push_back(ap(200, "net-7", -50, 1));
+    store().replace(records);
+
+    ScanStore::Reader reader = store().read();
+    for (int i = 0; i < 200; ++i) {
+        snprintf(name, sizeof(name), "net-%d", i);
+        TEST_ASSERT_EQUAL_STRING(name, reader.entry(i).ssid);
+    }
+    TEST_ASSERT_EQUAL_PTR(reader.entry(7).ssid, reader.entry(200).ssid);
+}
+
+void test_compact_pool_drops_gone_names() {
+    // A survey of 100 named APs on channel 1...
+    std::vector<WiFiModule::ScanRecord> records;
+    char name[16];
+    for (int i = 0; i < 100; ++i) {
+        snprintf(name, sizeof(name), "gone-%d", i);
+        records.push_back(ap(i, name, -50, 1));
+    }
+    store().merge(1, records, false);
+    size_t before = store().read().memoryUsage();
+
+    // ...of which two are left: their names must survive the compaction
+    store().merge(1, {ap(10, "gone-10", -50, 1), ap(150, "new", -50, 1)}, false);
+    {
+        ScanStore::Reader reader = store().read();
+        TEST_ASSERT_EQUAL(2, reader.size());
+        TEST_ASSERT_EQUAL_STRING("gone-10", reader.entry(0).ssid);
+        TEST_ASSERT_EQUAL_STRING("new", reader.entry(1).ssid);
+        TEST_ASSERT_TRUE(reader.memoryUsage() < before);
+    }
+
+    // The rebuilt index still finds what is there
+    store().merge(1, {ap(10, "gone-10", -50, 1), ap(150, "new", -50, 1),
+                      ap(151, "new", -60, 1)}, false);
+    ScanStore::Reader reader = store().read();
+    TEST_ASSERT_EQUAL(3, reader.size());
+    TEST_ASSERT_EQUAL_PTR(reader.entry(1).ssid, reader.entry(2).ssid);
+}
+
+void test_parse_names() {
+    ScanStore::SortKey key;
+    TEST_ASSERT_TRUE(ScanStore::parseSortKey("channel", key));
+    TEST_ASSERT_TRUE(key == ScanStore::SortKey::CHANNEL);
+    TEST_ASSERT_FALSE(ScanStore::parseSortKey("RSSI", key));
+
+    ScanStore::Security security;
+    TEST_ASSERT_TRUE(ScanStore::parseSecurity("wpa3", security));
+    TEST_ASSERT_TRUE(security == ScanStore::Security::WPA3);
+    TEST_ASSERT_FALSE(ScanStore::parseSecurity("wpa4", security));
+
+    TEST_ASSERT_EQUAL_STRING("wpa/wpa2", ScanStore::securityName(WIFI_AUTH_WPA_WPA2_PSK));
+    TEST_ASSERT_EQUAL_STRING("other", ScanStore::securityName(WIFI_AUTH_WAPI_PSK));
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_sort_by_rssi_ties_keep_scan_order);
+    RUN_TEST(test_sort_by_channel_and_ssid);
+    RUN_TEST(test_filters);
+    RUN_TEST(test_paging);
+    RUN_TEST(test_page_size_is_capped);
+    RUN_TEST(test_cursor_round_trip);
+    RUN_TEST(test_cursor_rejects_malformed);
+    RUN_TEST(test_stale_cursor_is_refused);
+    RUN_TEST(test_survey_keeps_rows_and_generation);
+    RUN_TEST(test_survey_end_removes_unheard_aps);
+    RUN_TEST(test_ssids_are_interned);
+    RUN_TEST(test_pool_survives_growth);
+    RUN_TEST(test_compact_pool_drops_gone_names);
+    RUN_TEST(test_parse_names);
+    return UNITY_END();
+}
@@ -0,0 +1,140 @@
+const status = {};
+
+function renderStatus() {
+    document.getElementById('status').innerHTML =
+        'Free Heap: ' + status.freeHeap + ' bytes<br>' +
+        'Uptime: ' + status.uptime + ' ms';
+}
+function updateStatus() {
+    fetch('/api/status').then(r => r.json()).then(data => {
+        Object.assign(status, data);
+        renderStatus();
+    });
+}
+// Scan results are paged on the device; "More" follows the cursor of the last page
+let scanNext = null;
+
+function scanQuery(cursor) {
+    let url = '/api/wifi/scan?sort=' + document.getElementById('wifiSort').value;
+    if (cursor) {
+        url += '&cursor=' + cursor;
+    }
+    return url;
+}
+function renderScan(data, append) {
+    const results = document.getElementById('wifiResults');
+    const more = document.getElementById('wifiMore');
+    if (!data.networks) {
+        results.textContent = 'Scanning...';
+        more.style.display = 'none';
+        return;
+    }
+    if (!append) {
+        // Channels arrive one by one; the list fills in while the rest are scanned
+        results.textContent = 'Found ' + data.count + ' networks' +
+            (data.scanning ? ', scanning...' : '');
+    }
+    data.networks.forEach(n => {
+        const line = document.createElement('div');
+        line.textContent = n.ssid + ' (' + n.bssid + ') ch' + n.channel + ' ' + n.rssi + ' dBm ' +
+            n.security;
+        results.appendChild(line);
+    });
+    scanNext = data.next;
+    more.style.display = scanNext ? 'inline-block' : 'none';
+}
+function loadScan(cursor) {
+    fetch(scanQuery(cursor)).then(r => {
+        // 410: a newer scan replaced the one being paged, start over
+        if (r.status === 410) {
+            return loadScan();
+        }
+        return r.json().then(data => {
+            renderScan(data, !!cursor);
+            // Without the event stream, poll until the scan is done
+            if (data.scanning && !window.EventSource) {
+                setTimeout(loadScan, 1000);
+            }
+        });
+    });
+}
+function loadMoreScan() {
+    if (scanNext) {
+        loadScan(scanNext);
+    }
+}
+function renderSpectrum(data) {
+    const canvas = document.getElementById('spectrum');
+    canvas.style.display = 'block';
+    document.getElementById('spectrumTitle').textContent = data.title;
+    const ctx = canvas.getContext('2d');
+    const span = data.maxLevel - data.minLevel;
+    const width = canvas.width / data.levels.length;
+    ctx.fillStyle = '#000';
+    ctx.fillRect(0, 0, canvas.width, canvas.height);
+    ctx.fillStyle = '#0f0';
+    data.levels.forEach((level, i) => {
+        const h = Math.max(0, Math.min(1, (level - data.minLevel) / span)) * canvas.height;
+        ctx.fillRect(i * width, canvas.height - h, Math.max(1, width - 1), h);
+    });
+}
+function scanWiFi() {
+    fetch('/api/wifi/scan', {method: 'POST'}).then(r => r.json()).then(data => {
+        renderScan(data);
+        if (!window.EventSource) {
+            setTimeout(loadScan, 1000);
+        }
+    });
+}
+function renderHopper(data) {
+    document.getElementById('hopperStatus').textContent = data.running
+        ? data.mode + ': ' + data.devices + ' devices, ' + data.devicesPerMinute + '/min'
+        : 'Stopped';
+    const table = document.getElementById('hopperChannels');
+    table.innerHTML = '<tr><th>Ch</th><th>Dwell ms</th><th>Frames/s</th><th>BSSIDs</th></tr>';
+    data.channels.forEach(c => {
+        const row = table.insertRow();
+        [c.channel, c.dwellMs, c.framesPerSecond, c.bssids].forEach(v => {
+            row.insertCell().textContent = v;
+        });
+    });
+}
+let hopperTimer = null;
+function updateHopper() {
+    fetch('/api/wifi/hopper').then(r => r.json()).then(data => {
+        renderHopper(data);
+        if (data.running && !hopperTimer) {
+            hopperTimer = setInterval(updateHopper, 2000);
+        } else if (!data.running && hopperTimer) {
+            clearInterval(hopperTimer);
+            hopperTimer = null;
+        }
+    });
+}
+function stopHopper() {
+    fetch('/api/wifi/hopper/stop', {method: 'POST'}).then(updateHopper);
+}
+function startAP() {
+    fetch('/api/wifi/ap/start', {method: 'POST'}).then(r => r.json());
+}
+function scanBLE() {
+    fetch('/api/ble/scan').then(r => r.json());
+}
+function spamBLE() {
+    fetch('/api/ble/spam', {method: 'POST'}).then(r => r.json());
+}
+
+// The device pushes status deltas, scan results and spectrum sweeps
+if (window.EventSource) {
+    const events = new EventSource('/api/events');
+    events.addEventListener('status', e => {
+        Object.assign(status, JSON.parse(e.data));
+        renderStatus();
+    });
+    events.addEventListener('scan', () => loadScan());
+    events.addEventListener('spectrum', e => renderSpectrum(JSON.parse(e.data)));
+} else {
+    setInterval(updateStatus, 1000);
+}
+updateStatus();
+updateHopper();